@@ -27,3 +27,8 @@ option(DEBUG "Enable debug statements and asserts" OFF)
 if (DEBUG OR CMAKE_BUILD_TYPE STREQUAL "Debug")
   add_compile_definitions(DEBUG APP_PROFILE)
 endif ()
+
+option(APP_PROFILE "Enable profiling in any build type" OFF)
+if (APP_PROFILE)
+  add_compile_definitions(APP_PROFILE)
+endif ()
@@ -1,16 +1,77 @@
 #define SDL_MAIN_HANDLED
 
+#include <cstdio>
+#include <cstdlib>
 #include <exception>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 #include "Core/Application.hpp"
 #include "Core/Debug/Instrumentor.hpp"
+#include "Core/Exporter.hpp"
 #include "Core/Log.hpp"
 
-int main() {
+namespace {
+
+constexpr const char* EXPORT_USAGE{
+    "Usage: App --export [--out DIR] [--size WIDTHxHEIGHT] [--format png|svg] SESSION...\n"};
+
+// Headless export: `App --export ...` renders the sessions without opening a window.
+int run_export(int argc, char** argv) {
+  App::Core::Exporter::Options options;
+  std::vector<std::filesystem::path> sessions;
+  for (int i = 2; i < argc; ++i) {
+    const std::string_view argument{argv[i]};
+    const bool has_value{i + 1 < argc};
+    if (argument == "--out" && has_value) {
+      options.output_directory = argv[++i];
+    } else if (argument == "--size" && has_value) {
+      // NOLINTNEXTLINE(cert-err34-c): checked through the count and the range below
+      if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+          options.width <= 0 || options.height <= 0) {
+        std::fputs(EXPORT_USAGE, stderr);
+        return EXIT_FAILURE;
+      }
+    } else if (argument == "--format" && has_value) {
+      const std::string_view format{argv[++i]};
+      if (format != "png" && format != "svg") {
+        std::fputs(EXPORT_USAGE, stderr);
+        return EXIT_FAILURE;
+      }
+      options.format =
+          format == "svg" ? App::Core::Exporter::Format::Svg : App::Core::Exporter::Format::Png;
+    } else if (argument.starts_with("--")) {
+      std::fputs(EXPORT_USAGE, stderr);
+      return EXIT_FAILURE;
+    } else {
+      sessions.emplace_back(argument);
+    }
+  }
+  if (sessions.empty()) {
+    std::fputs(EXPORT_USAGE, stderr);
+    return EXIT_FAILURE;
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(options.output_directory, error);
+
+  App::Core::Exporter exporter;
+  return exporter.run(sessions, options) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int status{EXIT_SUCCESS};
   try {
     APP_PROFILE_BEGIN_SESSION_WITH_FILE("App", "profile.json");
 
-    {
+    if (argc > 1 && std::string_view{argv[1]} == "--export") {
+      APP_PROFILE_SCOPE("Export");
+      status = run_export(argc, argv);
+    } else {
       APP_PROFILE_SCOPE("Test scope");
       App::Application app{"App"};
       app.run();
@@ -21,5 +82,5 @@ int main() {
     APP_ERROR("Main process terminated with: {}", e.what());
   }
 
-  return 0;
+  return status;
 }
@@ -0,0 +1,207 @@
+// Headless benchmark of the compile -> sample -> tessellate pipeline.
+//
+// Drives Core::PlotPipeline through a Dear ImGui context without any window or renderer,
+// over a fixed corpus of expressions, zoom levels and pans, and prints one line of numbers
+// per case:
+//
+//   Bench [pan frames per case, default 120]
+
+#include <imgui.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Core/Debug/AllocationCounter.hpp"
+#include "Core/Debug/PerfStats.hpp"
+#include "Core/FrameArena.hpp"
+#include "Core/PlotPipeline.hpp"
+#include "Core/expression.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float WIDTH{1280.0F};
+constexpr float HEIGHT{720.0F};
+constexpr float THICKNESS{3.0F};
+constexpr double PAN_PIXELS_PER_FRAME{4.0};
+
+constexpr std::array<std::string_view, 12> CORPUS{
+    "tanh(x)",
+    "sin(x)",
+    "x^3 - 2*x",
+    "exp(-x^2)*cos(10*x)",
+    "sin(1/x)",
+    "tan(x)",
+    "sqrt(abs(x))*sin(x^2)",
+    "floor(x)",
+    "x^2 + y^2 = 4",
+    "sin(x) < y",
+    "(cos(3*t), sin(2*t))",
+    "r = 1 + cos(theta) {0 <= theta <= 8*pi}",
+};
+constexpr std::array<double, 3> ZOOMS{10.0, 100.0, 1000.0};
+
+struct Result {
+  double cold_ms;
+  std::uint64_t evaluations;
+  std::size_t points;
+  double pan_frame_us;
+  double allocations_per_frame;
+};
+
+class Harness {
+ public:
+  Harness(std::string_view source, double zoom) : m_zoom(zoom) {
+    m_functions.add(source, App::Core::PlotPipeline::parse_color("#C74440"));
+  }
+
+  // One UI frame; returns true while sampling is still pending.
+  bool frame() {
+    ImGui::NewFrame();
+    ImDrawList* draw_list{ImGui::GetForegroundDrawList()};
+
+    const double xmin{(-WIDTH / 2.0 - m_offset_x) / m_zoom};
+    const double xmax{(WIDTH / 2.0 - m_offset_x) / m_zoom};
+    const double ymin{-HEIGHT / 2.0 / m_zoom};
+    const double ymax{HEIGHT / 2.0 / m_zoom};
+    const bool pending{m_pipeline.update(
+        m_functions, {xmin, xmax, ymin, ymax, m_zoom}, THICKNESS, draw_list, &m_arena)};
+    m_pipeline.draw(m_functions, draw_list, ImVec2(WIDTH / 2.0F, HEIGHT / 2.0F));
+
+    ImGui::Render();
+    App::Debug::PerfStats::get().end_frame({}, 0);
+    m_arena.reset();
+    m_evaluations += App::Debug::PerfStats::get().evaluations_last_frame();
+    return pending;
+  }
+
+  // Runs frames until the background work for the current view is done.
+  std::size_t settle() {
+    std::size_t frames{1};
+    while (frame()) {
+      std::this_thread::yield();
+      ++frames;
+    }
+    // One more frame picks up the finished curve's geometry.
+    frame();
+    return frames + 1;
+  }
+
+  void pan() {
+    m_offset_x += PAN_PIXELS_PER_FRAME;
+  }
+
+  [[nodiscard]] std::uint64_t evaluations() const {
+    return m_evaluations;
+  }
+
+  [[nodiscard]] std::size_t points() const {
+    const auto curve{m_functions.curve.front().latest()};
+    return curve->samples.size() + curve->segments.size();
+  }
+
+ private:
+  double m_zoom;
+  double m_offset_x{0.0};
+  std::uint64_t m_evaluations{0};
+  App::Core::ExpressionList m_functions;
+  App::Core::PlotPipeline m_pipeline;
+  App::Core::FrameArena m_arena;
+};
+
+Result run_case(std::string_view source, double zoom, int pan_frames) {
+  Harness harness{source, zoom};
+
+  const auto cold_start{Clock::now()};
+  harness.settle();
+  const auto cold_end{Clock::now()};
+
+  Result result{};
+  result.cold_ms = std::chrono::duration<double, std::milli>(cold_end - cold_start).count();
+  result.evaluations = harness.evaluations();
+  result.points = harness.points();
+
+  std::size_t frames{0};
+  const std::uint64_t allocations_before{App::Debug::AllocationCounter::total()};
+  const auto pan_start{Clock::now()};
+  for (int i = 0; i < pan_frames; ++i) {
+    harness.pan();
+    frames += harness.settle();
+  }
+  const auto pan_end{Clock::now()};
+  const std::uint64_t allocations{App::Debug::AllocationCounter::total() - allocations_before};
+
+  if (frames > 0) {
+    result.pan_frame_us =
+        std::chrono::duration<double, std::micro>(pan_end - pan_start).count() /
+        static_cast<double>(frames);
+    result.allocations_per_frame =
+        static_cast<double>(allocations) / static_cast<double>(frames);
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int pan_frames{argc > 1 ? std::atoi(argv[1]) : 120};
+
+  // A bare context is enough for draw lists: no platform or renderer backend.
+  ImGui::SetAllocatorFunctions(
+      &App::Debug::AllocationCounter::imgui_alloc, &App::Debug::AllocationCounter::imgui_free);
+  ImGui::CreateContext();
+  ImGuiIO& io{ImGui::GetIO()};
+  io.DisplaySize = ImVec2(WIDTH, HEIGHT);
+  io.DeltaTime = 1.0F / 60.0F;
+  io.IniFilename = nullptr;
+  unsigned char* pixels{nullptr};
+  int atlas_width{0};
+  int atlas_height{0};
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &atlas_width, &atlas_height);
+
+  std::printf("%-24s %6s %9s %9s %9s %8s %11s %11s %10s\n",
+      "expression",
+      "zoom",
+      "cold ms",
+      "evals",
+      "ns/eval",
+      "points",
+      "pan us/fr",
+      "frames/s",
+      "allocs/fr");
+
+  for (const std::string_view source : CORPUS) {
+    for (const double zoom : ZOOMS) {
+      const Result result{run_case(source, zoom, pan_frames)};
+      const double ns_per_evaluation{result.evaluations > 0
+                                         ? result.cold_ms * 1e6 /
+                                               static_cast<double>(result.evaluations)
+                                         : 0.0};
+      const double frames_per_second{
+          result.pan_frame_us > 0.0 ? 1e6 / result.pan_frame_us : 0.0};
+
+      std::printf("%-24.*s %6.0f %9.3f %9llu %9.1f %8zu %11.1f %11.0f %10.1f\n",
+          static_cast<int>(source.size()),
+          source.data(),
+          zoom,
+          result.cold_ms,
+          static_cast<unsigned long long>(result.evaluations),
+          ns_per_evaluation,
+          result.points,
+          result.pan_frame_us,
+          frames_per_second,
+          result.allocations_per_frame);
+    }
+  }
+
+  ImGui::DestroyContext();
+  return EXIT_SUCCESS;
+}
@@ -1,32 +1,158 @@
 #include "Application.hpp"
-#include<vector>
 
 #include <SDL2/SDL.h>
 #include <backends/imgui_impl_sdl2.h>
 #include <backends/imgui_impl_sdlrenderer2.h>
 #include <imgui.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
+#include "Core/AxisLayer.hpp"
+#include "Core/CurveAnalysis.hpp"
 #include "Core/DPIHandler.hpp"
+#include "Core/FontCache.hpp"
+#include "Core/FrameArena.hpp"
+#include "Core/Debug/AllocationCounter.hpp"
 #include "Core/Debug/Instrumentor.hpp"
+#include "Core/Debug/PerfStats.hpp"
 #include "Core/Log.hpp"
+#include "Core/PlotPipeline.hpp"
 #include "Core/Resources.hpp"
+#include "Core/Session.hpp"
+#include "Core/ViewTransform.hpp"
 #include "Core/Window.hpp"
 #include "Settings/Project.hpp"
-#include "exprtk.hpp"
-#include "funcs.hpp"
-
 #include "Core/expression.hpp"
 
 namespace App {
 
-Application::Application(const std::string& title) {
+namespace {
+
+// Idle loop wait; also the cursor blink rate while a text field is active.
+constexpr int IDLE_WAIT_MS{500};
+// ImGui needs a few frames after an input to settle hover, focus and layout.
+constexpr int FRAMES_AFTER_EVENT{3};
+// Longest animation step per frame, so a stalled frame does not make playing sliders jump.
+constexpr double MAX_ANIMATION_STEP_S{0.1};
+
+// Curves that took at least this long to sample are saved with the session.
+constexpr double CACHE_MIN_COST_MS{20.0};
+constexpr const char* SESSION_FILENAME{"session.imgraph"};
+
+// How close (pixels) the cursor has to be to a marker to show its coordinates.
+constexpr float MARKER_HIT_RADIUS{8.0F};
+
+Uint32 g_wake_event{0};
+
+// Runs on a worker thread when a background curve is ready.
+void wake_ui() {
+  SDL_Event event{};
+  event.type = g_wake_event;
+  SDL_PushEvent(&event);
+}
+
+const char* marker_label(Core::CurveAnalysis::Kind kind) {
+  switch (kind) {
+    case Core::CurveAnalysis::Kind::Root:
+      return "Root";
+    case Core::CurveAnalysis::Kind::Minimum:
+      return "Minimum";
+    case Core::CurveAnalysis::Kind::Maximum:
+      return "Maximum";
+    case Core::CurveAnalysis::Kind::Intersection:
+      return "Intersection";
+  }
+  return "";
+}
+
+// InputText resize callback for a std::string buffer (passed as user data): lets the text grow
+// without a fixed capacity.
+int resize_text(ImGuiInputTextCallbackData* data) {
+  if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+    auto* text = static_cast<std::string*>(data->UserData);
+    text->resize(static_cast<std::size_t>(data->BufTextLen));
+    data->Buf = text->data();
+  }
+  return 0;
+}
+
+// Live frame-time and pipeline overlay, toggled with F3.
+void draw_perf_overlay(bool* open, const Core::ExpressionList& functions) {
+  const Debug::PerfStats& stats{Debug::PerfStats::get()};
+  const ImGuiViewport* viewport{ImGui::GetMainViewport()};
+
+  ImGui::SetNextWindowPos(
+      ImVec2(viewport->Pos.x + viewport->Size.x - 360.0F, viewport->Pos.y + 10.0F),
+      ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowBgAlpha(0.85F);
+  if (ImGui::Begin("Performance (F3)",
+          open,
+          ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing |
+              ImGuiWindowFlags_NoSavedSettings)) {
+    const auto frames{stats.frame_percentiles()};
+    ImGui::Text(
+        "Frame  p50 %.2f ms  p95 %.2f ms  p99 %.2f ms", frames.p50, frames.p95, frames.p99);
+    ImGui::PlotHistogram("##frames",
+        stats.frame_history().data(),
+        static_cast<int>(Debug::PerfStats::HISTORY),
+        static_cast<int>(stats.history_offset()),
+        nullptr,
+        0.0F,
+        1000.0F / 30.0F,
+        ImVec2(340.0F, 60.0F));
+
+    ImGui::Separator();
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Debug::PerfStats::Stage::Count); ++i) {
+      const auto stage{static_cast<Debug::PerfStats::Stage>(i)};
+      ImGui::Text("%-10s %8.3f ms/frame",
+          Debug::PerfStats::stage_name(stage),
+          stats.stage_average(stage));
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Evaluations last frame: %llu",
+        static_cast<unsigned long long>(stats.evaluations_last_frame()));
+    ImGui::Text("Draw list vertices: %zu", stats.vertices_last_frame());
+    ImGui::Text("Heap allocations last frame: %llu UI thread, %llu all threads",
+        static_cast<unsigned long long>(stats.ui_allocations_last_frame()),
+        static_cast<unsigned long long>(stats.allocations_last_frame()));
+
+    ImGui::Separator();
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+      const auto& compiled{functions.compiled[i]};
+      if (compiled == nullptr || !compiled->is_valid() ||
+          compiled->kind() == Core::CompiledExpression::Kind::Definition) {
+        continue;
+      }
+      const auto curve{functions.curve[i].latest()};
+      ImGui::Text("#%zu  %zu samples  %zu segments  %zu vertices  %s",
+          i + 1,
+          curve->samples.size(),
+          curve->segments.size(),
+          functions.geometry[i].vertex_count(),
+          compiled->is_batched() ? "bytecode" : "exprtk");
+    }
+  }
+  ImGui::End();
+}
+
+}  // namespace
+
+Application::Application(const std::string& title) : m_start_ns(Debug::Instrumentor::now_ns()) {
   APP_PROFILE_FUNCTION();
 
-  const unsigned int init_flags{SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER};
+  // Game controllers are only for navigation; their subsystem (which scans devices) starts
+  // after the first frame is presented.
+  const unsigned int init_flags{SDL_INIT_VIDEO | SDL_INIT_TIMER};
   if (SDL_Init(init_flags) != 0) {
     APP_ERROR("Error: %s\n", SDL_GetError());
     m_exit_status = ExitStatus::FAILURE;
@@ -54,11 +180,15 @@ ExitStatus App::Application::run() {
 
   // Setup Dear ImGui context
   IMGUI_CHECKVERSION();
+  ImGui::SetAllocatorFunctions(
+      &Debug::AllocationCounter::imgui_alloc, &Debug::AllocationCounter::imgui_free);
   ImGui::CreateContext();
   ImGuiIO& io{ImGui::GetIO()};
 
-  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard | ImGuiConfigFlags_DockingEnable |
-                    ImGuiConfigFlags_ViewportsEnable;
+  // No ImGuiConfigFlags_ViewportsEnable: the SDL_Renderer backend cannot draw secondary
+  // viewports, so the flag only made the platform backend set up (and update every frame)
+  // monitors and windows that were never used.
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard | ImGuiConfigFlags_DockingEnable;
 
   const std::string user_config_path{SDL_GetPrefPath(COMPANY_NAMESPACE.c_str(), APP_NAME.c_str())};
   APP_DEBUG("User config path: {}", user_config_path);
@@ -67,14 +197,21 @@ ExitStatus App::Application::run() {
   static const std::string imgui_ini_filename{user_config_path + "imgui.ini"};
   io.IniFilename = imgui_ini_filename.c_str();
 
-  // ImGUI font
+  // ImGUI font, loaded once and restored from the baked atlas of an earlier start if there is
+  // one; otherwise it is baked when the renderer uploads the texture and cached after the
+  // first frame.
   const float font_scaling_factor{DPIHandler::get_scale()};
   const float font_size{18.0F * font_scaling_factor};
   const std::string font_path{Resources::font_path("Manrope.ttf").generic_string()};
+  const std::filesystem::path font_cache{Core::FontCache::entry_path("Manrope.ttf", font_size)};
+  bool store_font_cache{false};
 
   if (Resources::exists(font_path)) {
-    io.Fonts->AddFontFromFileTTF(font_path.c_str(), font_size);
-    io.FontDefault = io.Fonts->AddFontFromFileTTF(font_path.c_str(), font_size);
+    io.FontDefault = Core::FontCache::load(*io.Fonts, font_cache, font_path, font_size);
+    if (io.FontDefault == nullptr) {
+      io.FontDefault = io.Fonts->AddFontFromFileTTF(font_path.c_str(), font_size);
+      store_font_cache = io.FontDefault != nullptr;
+    }
   } else {
     APP_WARN("Could not find font file under: {}", font_path.c_str());
   }
@@ -85,22 +222,89 @@ ExitStatus App::Application::run() {
   ImGui_ImplSDL2_InitForSDLRenderer(m_window->get_native_window(), m_window->get_native_renderer());
   ImGui_ImplSDLRenderer2_Init(m_window->get_native_renderer());
 
-  // All the expressions
-  std::vector<Core::Expression> functions = {{{"tanh(x)"}, "#C74440", true}};
-
-  double zoom = 100.0;
-
-  //panning offset
-  double offsetx=0;
-  double offsety=0;
+  // All the expressions. Rows keep their id for life, so widget state follows the row and
+  // labels need no formatting.
+  Core::ExpressionList functions;
+  // Zoom and pan, as the world point at the canvas center.
+  Core::ViewTransform view;
+
+  // The previous session, with the curves that were slow to sample drawn from its cache until
+  // they are resampled; a fresh start shows a default row instead.
+  const std::filesystem::path session_path{user_config_path + SESSION_FILENAME};
+  if (std::error_code error; std::filesystem::exists(session_path, error)) {
+    Core::Session session;
+    if (session.load(session_path)) {
+      for (const auto& row : session.rows) {
+        const std::size_t index{functions.add(row.text, row.color)};
+        functions.visible[index] = row.visible ? 1 : 0;
+        if (!row.curve.empty()) {
+          functions.curve[index].seed({{row.curve.samples.begin(), row.curve.samples.end()},
+              row.curve.ordered_by_x,
+              {row.curve.segments.begin(), row.curve.segments.end()},
+              {row.curve.regions.begin(), row.curve.regions.end()}});
+        }
+      }
+      view = Core::ViewTransform{session.center_x, session.center_y, session.pixels_per_unit};
+    }
+  }
+  if (functions.size() == 0) {
+    functions.add("tanh(x)", Core::PlotPipeline::parse_color("#C74440"));
+  }
+  // Left pane filter and the rows that pass it, recomputed only when the filter or the number
+  // of rows changes (a row being edited stays listed until then).
+  ImGuiTextFilter function_filter;
+  std::vector<std::size_t> listed_rows;
+  bool rows_changed = true;
+  Core::PlotPipeline pipeline;
+  // Loaded data files, drawn over the functions.
+  std::vector<Core::PlotPipeline::DataRow> data_rows;
+  std::string data_path;
+  Core::AxisLayer axis_layer;
+  // Roots, extrema and intersections of the plotted curves.
+  Core::CurveAnalysis analysis;
+  // Per-frame scratch memory, rewound after every frame.
+  Core::FrameArena frame_arena;
+
+  // Screen position of the canvas center, from the last frame (the wheel zooms around the
+  // cursor relative to it).
+  ImVec2 canvas_center{0.0f, 0.0f};
+
+  // On-demand rendering: while nothing moves, block on events instead of redrawing at vsync
+  // rate. Input, a finished background curve (wake event) or an ongoing interaction schedule
+  // frames; everything else keeps the loop asleep.
+  g_wake_event = SDL_RegisterEvents(1);
+  if (g_wake_event != static_cast<Uint32>(-1)) {
+    Core::AsyncCurve::set_publish_callback(&wake_ui);
+    Core::CurveAnalysis::set_publish_callback(&wake_ui);
+  }
+  int frames_to_render = FRAMES_AFTER_EVENT;
+  bool continuous = false;
 
   m_running = true;
   while (m_running) {
     APP_PROFILE_SCOPE("MainLoop");
 
     SDL_Event event{};
-    while (SDL_PollEvent(&event) == 1) {
+    const bool idle = !continuous && frames_to_render == 0;
+    bool has_event = idle ? SDL_WaitEventTimeout(&event, IDLE_WAIT_MS) == 1
+                          : SDL_PollEvent(&event) == 1;
+    // Followed data files are checked on every wake-up, so appended data shows within
+    // IDLE_WAIT_MS without drawing anything while they stay the same.
+    bool data_changed = false;
+    for (auto& row : data_rows) {
+      if (row.follow && row.series.poll()) {
+        data_changed = true;
+      }
+    }
+    if (data_changed) {
+      frames_to_render = FRAMES_AFTER_EVENT;
+    } else if (idle && !has_event && !io.WantTextInput) {
+      continue;
+    }
+
+    for (; has_event; has_event = SDL_PollEvent(&event) == 1) {
       APP_PROFILE_SCOPE("EventPolling");
+      frames_to_render = FRAMES_AFTER_EVENT;
 
       ImGui_ImplSDL2_ProcessEvent(&event);
 
@@ -114,38 +318,33 @@ ExitStatus App::Application::run() {
       }
 
       if (event.type == SDL_MOUSEWHEEL) {
-          const float zoom_speed = 1.1f;
-          ImVec2 mousePos = ImGui::GetMousePos();
-
-          // Keep previous zoom for compensation
-          double prevZoom = zoom;
-
-          if (event.wheel.y > 0) zoom *= zoom_speed;
-          if (event.wheel.y < 0) zoom /= zoom_speed;
-          zoom = std::clamp(zoom, 10.0, 1000.0);
-
-          // Get viewport and origin (same as below in your render loop)
-          const ImGuiViewport* viewport = ImGui::GetMainViewport();
-          const ImVec2 base_pos = viewport->Pos;
-          const ImVec2 base_size = viewport->Size;
-          const ImVec2 origin(base_pos.x + base_size.x * 0.5f,
-                              base_pos.y + base_size.y * 0.5f);
-
-          // Convert mouse to world coordinates before zoom
-          double worldX = (mousePos.x - origin.x - offsetx) / prevZoom;
-          double worldY = (mousePos.y - origin.y - offsety) / -prevZoom;
-
-          // Adjust offsets to keep cursor fixed
-          offsetx = mousePos.x - origin.x - worldX * zoom;
-          offsety = mousePos.y - origin.y + worldY * zoom;
+          const double zoom_speed = 1.1;
+          const ImVec2 mousePos = ImGui::GetMousePos();
+
+          // Keeps the world point under the cursor fixed
+          if (event.wheel.y != 0) {
+            view.zoom_at(mousePos.x - canvas_center.x,
+                mousePos.y - canvas_center.y,
+                event.wheel.y > 0 ? zoom_speed : 1.0 / zoom_speed);
+          }
       }
     }
+    frames_to_render = std::max(frames_to_render - 1, 0);
+    const auto frame_start = std::chrono::steady_clock::now();
 
     // Start the Dear ImGui frame
     ImGui_ImplSDLRenderer2_NewFrame();
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 
+    if (ImGui::IsKeyPressed(ImGuiKey_F3, false)) {
+      m_show_debug_panel = !m_show_debug_panel;
+    }
+
+    // Playing sliders only change parameter values, so just the rows reading them resample.
+    const bool animating =
+        functions.animate(std::min(static_cast<double>(io.DeltaTime), MAX_ANIMATION_STEP_S));
+
     if (!m_minimized) {
       const ImGuiViewport* viewport = ImGui::GetMainViewport();
       const ImVec2 base_pos = viewport->Pos;
@@ -161,32 +360,133 @@ ExitStatus App::Application::run() {
                 ImGuiWindowFlags_NoTitleBar);
 
         if (ImGui::Button("+ Add Function")) {
-            functions.push_back({});
+            functions.add("");
+            rows_changed = true;
+        }
+        // Bulk visibility applies to the listed (filtered) rows, only when clicked.
+        ImGui::SameLine();
+        if (ImGui::Button("Show all")) {
+          for (const std::size_t i : listed_rows) {
+            functions.visible[i] = 1;
+          }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Hide all")) {
+          for (const std::size_t i : listed_rows) {
+            functions.visible[i] = 0;
+          }
         }
 
-        for (size_t i = 0; i < functions.size(); ++i) {
-          std::string label = "##function" + std::to_string(i);
-          ImGui::InputTextMultiline(label.c_str(),
-              functions[i].expr.data(),
-              functions[i].expr.size(),
-              ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 4));
+        // Data files: CSV-like text, or raw .f32 / .f64 (x, y) records.
+        ImGui::InputTextWithHint("##data_path",
+            "Data file (.csv, .f32, .f64)",
+            data_path.data(),
+            data_path.capacity() + 1,
+            ImGuiInputTextFlags_CallbackResize,
+            resize_text,
+            &data_path);
+        ImGui::SameLine();
+        if (ImGui::Button("Load") && !data_path.empty()) {
+          Core::PlotPipeline::DataRow row{{}, Core::PlotPipeline::parse_color("#2D70B3")};
+          if (row.series.load(data_path)) {
+            row.name = row.series.path().filename().string();
+            data_rows.push_back(std::move(row));
+          }
+        }
+        ImGui::PushID("data");
+        for (std::size_t i = 0; i < data_rows.size(); ++i) {
+          auto& row = data_rows[i];
+          ImGui::PushID(static_cast<int>(i));
+          ImGui::Checkbox("##visible", &row.visible);
+          ImGui::SameLine();
+          ImVec4 color = ImGui::ColorConvertU32ToFloat4(row.color);
+          if (ImGui::ColorEdit3("##color", &color.x, ImGuiColorEditFlags_NoInputs)) {
+            row.color = ImGui::ColorConvertFloat4ToU32(color);
+          }
+          ImGui::SameLine();
+          ImGui::Checkbox("Follow", &row.follow);
+          ImGui::SameLine();
+          ImGui::Text("%s (%zu)", row.name.c_str(), row.series.size());
+          ImGui::PopID();
+        }
+        ImGui::PopID();
+        ImGui::Separator();
 
-          ImGui::Checkbox(("Visible##" + std::to_string(i)).c_str(), &functions[i].visible);
+        if (function_filter.Draw("##filter", -FLT_MIN)) {
+          rows_changed = true;
+        }
 
-          float color[3];
-          int r = 199, g = 68, b = 64;
-          if (functions[i].color.size() == 7 && functions[i].color[0] == '#') {
-              sscanf(functions[i].color.c_str() + 1, "%02x%02x%02x", &r, &g, &b);
+        if (rows_changed) {
+          listed_rows.clear();
+          for (std::size_t i = 0; i < functions.size(); ++i) {
+            if (function_filter.PassFilter(functions.rows[i].expr.c_str())) {
+              listed_rows.push_back(i);
+            }
           }
-          color[0] = r / 255.0f;
-          color[1] = g / 255.0f;
-          color[2] = b / 255.0f;
-
-          if (ImGui::ColorEdit3(("Color##" + std::to_string(i)).c_str(), color)) {
-              char hexColor[16];
-              snprintf(hexColor, sizeof(hexColor), "#%02X%02X%02X",
-                       int(color[0] * 255), int(color[1] * 255), int(color[2] * 255));
-              functions[i].color = hexColor;
+          rows_changed = false;
+        }
+
+        // Only the rows in view are submitted. They all have the same height (the error note
+        // shares the line with the controls), so the clipper can skip the others.
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(listed_rows.size()));
+        while (clipper.Step()) {
+          for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const std::size_t i = listed_rows[static_cast<std::size_t>(row)];
+            Core::Expression& function = functions.rows[i];
+            ImGui::PushID(function.id);
+            if (ImGui::InputTextMultiline("##function",
+                    function.expr.data(),
+                    function.expr.capacity() + 1,
+                    ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 4),
+                    ImGuiInputTextFlags_CallbackResize,
+                    resize_text,
+                    &function.expr)) {
+              function.dirty = true;
+            }
+
+            const std::size_t parameter = functions.parameter(i);
+            if (parameter != Core::Parameters::NONE) {
+              // Parameter rows are not plotted; their line holds the slider instead, with the
+              // range in its context menu.
+              Core::ParameterSlider& slider = function.slider;
+              if (ImGui::Button(slider.playing ? "Pause" : "Play")) {
+                slider.playing = !slider.playing;
+              }
+              ImGui::SameLine();
+              double value = functions.parameters->value(parameter);
+              const double low = std::min(slider.min, value);
+              const double high = std::max(slider.max, value);
+              ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.5f);
+              if (ImGui::SliderScalar(
+                      "##value", ImGuiDataType_Double, &value, &low, &high, "%.4g")) {
+                functions.set_parameter(i, value);
+              }
+              if (ImGui::BeginPopupContextItem("##range")) {
+                ImGui::InputDouble("Min", &slider.min);
+                ImGui::InputDouble("Max", &slider.max);
+                ImGui::InputDouble("Seconds per sweep", &slider.period);
+                ImGui::EndPopup();
+              }
+            } else {
+              bool visible = functions.visible[i] != 0;
+              if (ImGui::Checkbox("Visible", &visible)) {
+                functions.visible[i] = visible ? 1 : 0;
+              }
+
+              ImGui::SameLine();
+              ImVec4 color = ImGui::ColorConvertU32ToFloat4(functions.color[i]);
+              if (ImGui::ColorEdit3("Color", &color.x, ImGuiColorEditFlags_NoInputs)) {
+                functions.color[i] = ImGui::ColorConvertFloat4ToU32(color);
+              }
+            }
+
+            functions.compile(i);
+            if (!functions.compiled[i]->is_valid() && !function.expr.empty()) {
+              ImGui::SameLine();
+              ImGui::TextColored(ImVec4(0.9f, 0.3f, 0.3f, 1.0f), "Invalid expression");
+            }
+            ImGui::PopID();
           }
         }
 
@@ -211,14 +511,13 @@ ExitStatus App::Application::run() {
         const auto canvas_p1 =
             ImVec2(canvas_p0.x + canvas_sz.x, canvas_p0.y + canvas_sz.y);  // Bottom-right
 
-        // Define your coordinate system origin (e.g., center of the canvas)
-        const ImVec2 origin(canvas_p0.x + canvas_sz.x * 0.5f, canvas_p0.y + canvas_sz.y * 0.5f);
+        // The view is centered on the canvas
+        canvas_center = ImVec2(canvas_p0.x + canvas_sz.x * 0.5f, canvas_p0.y + canvas_sz.y * 0.5f);
 
         float lineThickness = 3.0f;
 
         //panning logic
         static bool isPanning = false;
-        static ImVec2 panStart = ImVec2(0,0);
 
         //get mouse position and state
         ImGuiIO& io=ImGui::GetIO();
@@ -230,7 +529,6 @@ ExitStatus App::Application::run() {
         // Left click pressed: start panning
         if (isHovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
             isPanning = true;
-            panStart = mousePos;
         }
 
         // Mouse released: stop panning
@@ -241,180 +539,156 @@ ExitStatus App::Application::run() {
         // If panning, update offset
         if (isPanning && ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
             ImVec2 dragDelta = ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
-            offsetx += dragDelta.x;
-            offsety += dragDelta.y;
+            view.pan(dragDelta.x, dragDelta.y);
             ImGui::ResetMouseDragDelta(ImGuiMouseButton_Left);
         }
 
-        // 1. Draw Axes
-        draw_list->AddLine(ImVec2(canvas_p0.x, origin.y+offsety),
-            ImVec2(canvas_p1.x, origin.y+offsety),
-            IM_COL32(0, 0, 0, 255),
-            lineThickness);  // X-axis
-        draw_list->AddLine(ImVec2(origin.x+offsetx, canvas_p0.y),
-            ImVec2(origin.x+offsetx, canvas_p1.y),
-            IM_COL32(0, 0, 0, 255),
-            lineThickness);  // Y-axis
-
-        // === Axis Markings (Ticks and Labels) ===
-        {
-            const ImU32 tickColor = IM_COL32(100, 100, 100, 255);
-            const ImU32 textColor = IM_COL32(50, 50, 50, 255);
-            const ImU32 gridColor = IM_COL32(200, 200, 200, 80);
-            const float tickLength = 5.0f;  // pixel length of tick
-            const float labelOffset = 15.0f;
-
-            ImGuiIO& io = ImGui::GetIO();
-            ImFont* font = io.FontDefault;
-
-            // Step size for ticks (auto-adjust with zoom)
-            double step = 1.0;
-            double pixelsPerUnit = zoom;
-            if (pixelsPerUnit > 400) step = 0.1;
-            else if (pixelsPerUnit > 200) step = 0.25;
-            else if (pixelsPerUnit > 100) step = 0.5;
-            else if (pixelsPerUnit > 50) step = 1.0;
-            else if (pixelsPerUnit > 20) step = 2.0;
-            else if (pixelsPerUnit > 10) step = 5.0;
-            else step = 10.0;
-
-            // Determine world bounds
-            const double xmin = (-canvas_sz.x / 2.0 - offsetx) / zoom;
-            const double xmax = (canvas_sz.x / 2.0 - offsetx) / zoom;
-            const double ymin = (-canvas_sz.y / 2.0 + offsety) / zoom;
-            const double ymax = (canvas_sz.y / 2.0 + offsety) / zoom;
-
-            // Round bounds to nearest multiple of step
-            const double xstart = std::floor(xmin / step) * step;
-            const double xend = std::ceil(xmax / step) * step;
-            const double ystart = std::floor(ymin / step) * step;
-            const double yend = std::ceil(ymax / step) * step;
-
-            // X-axis ticks
-            for (double xw = xstart; xw <= xend; xw += step) {
-                float xScreen = origin.x + xw * zoom + offsetx;
-                draw_list->AddLine(ImVec2(xScreen, origin.y + offsety - tickLength),
-                                  ImVec2(xScreen, origin.y + offsety + tickLength),
-                                  tickColor, 1.0f);
-
-                if (std::fabs(xw) > 1e-6) { // skip labeling origin
-                    char label[32];
-                    snprintf(label, sizeof(label), "%.2f", xw);
-                    draw_list->AddText(font, 13.0f,
-                                      ImVec2(xScreen - 10, origin.y + offsety + labelOffset),
-                                      textColor, label);
-                }
-            }
-
-            // Y-axis ticks
-            for (double yw = ystart; yw <= yend; yw += step) {
-                float yScreen = origin.y - yw * zoom + offsety;
-                draw_list->AddLine(ImVec2(origin.x + offsetx - tickLength, yScreen),
-                                  ImVec2(origin.x + offsetx + tickLength, yScreen),
-                                  tickColor, 1.0f);
-
-                if (std::fabs(yw) > 1e-6) { // skip labeling origin
-                    char label[32];
-                    snprintf(label, sizeof(label), "%.2f", yw);
-                    draw_list->AddText(font, 13.0f,
-                                      ImVec2(origin.x + offsetx + labelOffset, yScreen - 10),
-                                      textColor, label);
-                }
-            }
-
-            // Vertical grid lines
-            for (double xw = xstart; xw <= xend; xw += step) {
-                float xScreen = origin.x + xw * zoom + offsetx;
-                draw_list->AddLine(
-                    ImVec2(xScreen, canvas_p0.y),
-                    ImVec2(xScreen, canvas_p1.y),
-                    gridColor,
-                    1.0f
-                );
-            }
-
-            // Horizontal grid lines
-            for (double yw = ystart; yw <= yend; yw += step) {
-                float yScreen = origin.y - yw * zoom + offsety;
-                draw_list->AddLine(
-                    ImVec2(canvas_p0.x, yScreen),
-                    ImVec2(canvas_p1.x, yScreen),
-                    gridColor,
-                    1.0f
-                );
-            }
+        // Axes, grid and labels: rebuilt only when the zoom, pan or canvas size change.
+        const double zoom = view.pixels_per_unit();
+        axis_layer.update({canvas_sz.x,
+                              canvas_sz.y,
+                              canvas_sz.x * 0.5 - view.center_x() * zoom,
+                              canvas_sz.y * 0.5 + view.center_y() * zoom,
+                              zoom,
+                              lineThickness},
+                          draw_list,
+                          io.FontDefault);
+        axis_layer.draw(draw_list, canvas_p0);
+
+        // Compute the visible range based on panning offset
+        const double xmin = view.to_world_x(-canvas_sz.x / 2.0);
+        const double xmax = view.to_world_x(canvas_sz.x / 2.0);
+        const double ymin = view.to_world_y(canvas_sz.y / 2.0);
+        const double ymax = view.to_world_y(-canvas_sz.y / 2.0);
+
+        const bool sampling = pipeline.update(
+            functions, {xmin, xmax, ymin, ymax, zoom}, lineThickness, draw_list, &frame_arena);
+        pipeline.draw(functions, draw_list, canvas_center);
+
+        analysis.update(functions, pipeline.plotted());
+        analysis.draw(draw_list, {xmin, xmax, ymin, ymax, zoom}, canvas_center);
+        if (isHovered && !isPanning) {
+          if (const auto marker = analysis.hit(
+                  {xmin, xmax, ymin, ymax, zoom}, canvas_center, mousePos, MARKER_HIT_RADIUS)) {
+            ImGui::SetTooltip("%s (%.6g, %.6g)", marker_label(marker->kind), marker->x, marker->y);
+          }
+        }
+        Core::PlotPipeline::draw_data(data_rows,
+            {xmin, xmax, ymin, ymax, zoom},
+            lineThickness * 0.5f,
+            draw_list,
+            canvas_center,
+            &frame_arena);
+
+        // Progressive-refinement indicator
+        if (sampling) {
+            draw_list->AddText(ImVec2(canvas_p1.x - 90.0f, canvas_p0.y + 5.0f),
+                               IM_COL32(120, 120, 120, 255),
+                               "Sampling...");
         }
 
-        double x;
-
-        exprtk::symbol_table<double> symbolTable;
-        symbolTable.add_constants();
-        addConstants(symbolTable);
-        symbolTable.add_variable("x", x);
+        ImGui::End();
+        ImGui::PopStyleColor();
+      }
+    }
 
-        exprtk::expression<double> expression;
-        expression.register_symbol_table(symbolTable);
+    if (m_show_debug_panel) {
+      draw_perf_overlay(&m_show_debug_panel, functions);
+    }
 
-        exprtk::parser<double> parser;
-        std::vector<exprtk::expression<double>> expressions(functions.size());
+    // Rendering
+    std::size_t vertex_count{0};
+    {
+      const Debug::StageTimer timer{Debug::PerfStats::Stage::Render};
+      ImGui::Render();
+      vertex_count = static_cast<std::size_t>(ImGui::GetDrawData()->TotalVtxCount);
+
+      SDL_RenderSetScale(m_window->get_native_renderer(),
+          io.DisplayFramebufferScale.x,
+          io.DisplayFramebufferScale.y);
+      SDL_SetRenderDrawColor(m_window->get_native_renderer(), 100, 100, 100, 255);
+      SDL_RenderClear(m_window->get_native_renderer());
+      ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), m_window->get_native_renderer());
+      SDL_RenderPresent(m_window->get_native_renderer());
+    }
 
-        for (size_t i = 0; i < functions.size(); ++i) {
-            if (!functions[i].visible) continue;
-            expressions[i].register_symbol_table(symbolTable);
-            parser.compile(functions[i].expr.data(), expressions[i]);
-        }
+    if (!m_presented) {
+      m_presented = true;
+      on_first_present(font_cache, font_path, font_size, store_font_cache);
+    }
 
-        for (size_t i = 0; i < functions.size(); ++i) {
-            if (!functions[i].visible) continue;
+    Debug::PerfStats::get().end_frame(
+        std::chrono::steady_clock::now() - frame_start, vertex_count);
+    frame_arena.reset();
 
-            auto& expr = expressions[i];
-            std::vector<ImVec2> points;
-            points.reserve(static_cast<size_t>(canvas_sz.x / 2)); // small optimization
+    // Keep drawing while the user interacts (drags, held keys, active widgets), while sliders
+    // play and while the overlay measures frame times.
+    continuous = ImGui::IsMouseDown(ImGuiMouseButton_Left) ||
+                 ImGui::IsMouseDown(ImGuiMouseButton_Right) || ImGui::IsAnyItemActive() ||
+                 animating || m_show_debug_panel;
+  }
 
-            // Compute X range based on panning offset
-            const double xmin = (-canvas_sz.x / 2.0 - offsetx) / zoom;
-            const double xmax = (canvas_sz.x / 2.0 - offsetx) / zoom;
-            const double step = 0.05;  // smaller → smoother curve
+  Core::AsyncCurve::set_publish_callback(nullptr);
+  Core::CurveAnalysis::set_publish_callback(nullptr);
 
-            for (x = xmin; x < xmax; x += step) {
-                const double y = expr.value();  // evaluate using current 'x' bound in symbolTable
-                points.push_back(ImVec2(origin.x + (x * zoom) + offsetx,
-                                        origin.y - (y * zoom) + offsety));
-            }
+  save_session(session_path, functions, view);
 
-            // Parse color (from hex string like "#C74440")
-            int r = 199, g = 68, b = 64;
-            if (functions[i].color.size() == 7 && functions[i].color[0] == '#') {
-                sscanf(functions[i].color.c_str() + 1, "%02x%02x%02x", &r, &g, &b);
-            }
+  return m_exit_status;
+}
 
-            // Draw the function line
-            if (!points.empty()) {
-                draw_list->AddPolyline(points.data(), points.size(),
-                                      IM_COL32(r, g, b, 255),
-                                      ImDrawFlags_None,
-                                      lineThickness);
-            }
-        }
+void Application::save_session(const std::filesystem::path& path,
+    const Core::ExpressionList& functions,
+    const Core::ViewTransform& view) {
+  APP_PROFILE_FUNCTION();
 
-        ImGui::End();
-        ImGui::PopStyleColor();
-      }
+  Core::Session session;
+  session.center_x = view.center_x();
+  session.center_y = view.center_y();
+  session.pixels_per_unit = view.pixels_per_unit();
+
+  // Keeps the cached curves alive until they are written.
+  std::vector<std::shared_ptr<const Core::AsyncCurve::Curve>> curves;
+  curves.reserve(functions.size());
+  for (std::size_t i = 0; i < functions.size(); ++i) {
+    Core::Session::Row& row{session.rows.emplace_back()};
+    row.text = functions.rows[i].expr;
+    row.color = functions.color[i];
+    row.visible = functions.visible[i] != 0;
+
+    // Cheap curves are resampled faster than they are read back.
+    const auto& curve{curves.emplace_back(functions.curve[i].latest())};
+    if (curve->cost_ms >= CACHE_MIN_COST_MS) {
+      row.curve = {curve->samples, curve->segments, curve->regions, curve->ordered_by_x};
     }
+  }
 
-    // Rendering
-    ImGui::Render();
-
-    SDL_RenderSetScale(m_window->get_native_renderer(),
-        io.DisplayFramebufferScale.x,
-        io.DisplayFramebufferScale.y);
-    SDL_SetRenderDrawColor(m_window->get_native_renderer(), 100, 100, 100, 255);
-    SDL_RenderClear(m_window->get_native_renderer());
-    ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), m_window->get_native_renderer());
-    SDL_RenderPresent(m_window->get_native_renderer());
+  session.save(path, Core::Session::Format::Binary);
+}
+
+void Application::on_first_present(const std::filesystem::path& font_cache,
+    const std::filesystem::path& font_path,
+    float font_size,
+    bool store_font_cache) {
+  APP_PROFILE_FUNCTION();
+
+  // Cold start: from constructing the application to the first presented frame.
+  [[maybe_unused]] const std::int64_t now_ns{Debug::Instrumentor::now_ns()};
+  APP_INFO("First frame presented {:.1f} ms after start",
+      static_cast<double>(now_ns - m_start_ns) / 1e6);
+#if APP_PROFILE
+  if (Debug::Instrumentor::get().is_active()) {
+    static const std::uint32_t name_id{Debug::Instrumentor::get().intern("ColdStart")};
+    Debug::Instrumentor::get().record({name_id, m_start_ns, now_ns - m_start_ns});
   }
+#endif
 
-  return m_exit_status;
+  // Deferred setup, nothing the first frame needs.
+  if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) != 0) {
+    APP_WARN("Could not initialize game controllers: {}", SDL_GetError());
+  }
+  if (store_font_cache) {
+    Core::FontCache::store(*ImGui::GetIO().Fonts, font_cache, font_path, font_size);
+  }
 }
 
 void App::Application::stop() {
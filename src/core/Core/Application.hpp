@@ -2,6 +2,8 @@
 
 #include <SDL2/SDL.h>
 
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,6 +12,11 @@
 
 namespace App {
 
+namespace Core {
+struct ExpressionList;
+class ViewTransform;
+}  // namespace Core
+
 enum class ExitStatus : int { SUCCESS = 0, FAILURE = 1 };
 
 class Application {
@@ -31,9 +38,23 @@ class Application {
   void on_close();
 
  private:
+  // Reports the cold start and runs the setup deferred until the first frame is on screen.
+  void on_first_present(const std::filesystem::path& font_cache,
+      const std::filesystem::path& font_path,
+      float font_size,
+      bool store_font_cache);
+  // Saves the rows, the view and the curves that were slow to sample, restored on next start.
+  static void save_session(const std::filesystem::path& path,
+      const Core::ExpressionList& functions,
+      const Core::ViewTransform& view);
+
   ExitStatus m_exit_status{ExitStatus::SUCCESS};
   std::unique_ptr<Window> m_window{nullptr};
 
+  // Instrumentor clock at construction, and whether a frame has been presented since.
+  std::int64_t m_start_ns;
+  bool m_presented{false};
+
   bool m_running{true};
   bool m_minimized{false};
   bool m_show_some_panel{true};
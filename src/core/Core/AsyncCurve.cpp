@@ -0,0 +1,229 @@
+#include "AsyncCurve.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Debug/PerfStats.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace App::Core {
+
+AsyncCurve::AsyncCurve() : m_state(std::make_shared<State>()) {
+  m_state->front = std::make_shared<Curve>();
+}
+
+namespace {
+
+std::atomic<void (*)()> g_publish_callback{nullptr};
+
+// Pads [min, max] by a dyadic quantum, so padded ranges stay aligned with the sample grid.
+void pad(double& min, double& max) {
+  const double extent{max - min};
+  if (!(extent > 0.0)) {
+    return;
+  }
+  const double quantum{std::exp2(std::floor(std::log2(extent * 0.25)))};
+  min = std::floor(min / quantum) * quantum - quantum;
+  max = std::ceil(max / quantum) * quantum + quantum;
+}
+
+}  // namespace
+
+AsyncCurve::View AsyncCurve::padded_view(
+    double xmin, double xmax, double ymin, double ymax, double pixels_per_unit) {
+  if (pixels_per_unit > 0.0) {
+    pad(xmin, xmax);
+    pad(ymin, ymax);
+  }
+  return {xmin, xmax, ymin, ymax, pixels_per_unit};
+}
+
+bool AsyncCurve::request(const std::shared_ptr<CompiledExpression>& expression,
+    View view,
+    std::shared_ptr<GridSweep> sweep) {
+  // The background update samples the expression; there is nothing to sample without one.
+  if (expression == nullptr) {
+    return false;
+  }
+  // Explicit curves only depend on the vertical range through culling, which needs bytecode,
+  // and parametric ones on neither range; ignoring them keeps those pans free.
+  if (expression->kind() == CompiledExpression::Kind::Explicit && !expression->is_batched()) {
+    view.ymin = 0.0;
+    view.ymax = 0.0;
+  }
+  if (expression->is_curve()) {
+    view = {0.0, 0.0, 0.0, 0.0, view.pixels_per_unit};
+  }
+  const std::uint64_t revision{expression->parameter_revision()};
+  if (expression == m_requested_expression && revision == m_requested_revision &&
+      view == m_requested_view) {
+    return false;
+  }
+
+  m_state->stale = true;
+  if (m_state->busy.exchange(true)) {
+    // Still working on an older request; it is picked up again next frame.
+    return false;
+  }
+
+  m_requested_expression = expression;
+  m_requested_revision = revision;
+  m_requested_view = view;
+  m_state->stale = false;
+
+  ThreadPool::get().submit(
+      [state = m_state, expression, revision, view, sweep = std::move(sweep)] {
+        run(state, expression, revision, view, sweep);
+      });
+  return true;
+}
+
+void AsyncCurve::run(const std::shared_ptr<State>& state,
+    const std::shared_ptr<CompiledExpression>& expression,
+    std::uint64_t revision,
+    const View& view,
+    const std::shared_ptr<GridSweep>& sweep) {
+  APP_PROFILE_FUNCTION();
+  const auto start{std::chrono::steady_clock::now()};
+
+  // A changed parameter changes every sample, as a new expression does.
+  if (expression != state->cache_expression || revision != state->cache_revision) {
+    state->cache.invalidate();
+    state->implicit.invalidate();
+    state->parametric.invalidate();
+    state->cache_expression = expression;
+    state->cache_revision = revision;
+    state->cache_cost_ms = 0.0;
+  }
+
+  const CompiledExpression::Kind kind{expression->kind()};
+  if (kind == CompiledExpression::Kind::Explicit) {
+    const Debug::StageTimer timer{Debug::PerfStats::Stage::Evaluate};
+    SampleCache::BoundsFunction bounds_x;
+    if (expression->is_batched()) {
+      bounds_x = [&expression](double x0, double x1) { return expression->bounds({x0, x1}); };
+    }
+    const std::size_t evaluated{
+        state->cache.update([&expression](double x) { return expression->evaluate(x); },
+            view.xmin,
+            view.xmax,
+            view.pixels_per_unit,
+            &ThreadPool::get(),
+            [&expression, &sweep](const double* x, double* y, std::size_t count) {
+              if (sweep == nullptr || !sweep->lookup(expression.get(), x, y, count)) {
+                expression->evaluate(x, y, count);
+              }
+            },
+            {view.ymin, view.ymax, bounds_x})};
+    Debug::PerfStats::get().add_evaluations(evaluated);
+  } else if (expression->is_curve()) {
+    const Debug::StageTimer timer{Debug::PerfStats::Stage::Evaluate};
+    const CompiledExpression::Domain domain{expression->domain()};
+    const std::size_t evaluated{state->parametric.update(
+        [&expression](const double* t, double* x, double* y, std::size_t count) {
+          expression->evaluate_curve(t, x, y, count);
+        },
+        domain.min,
+        domain.max,
+        view.pixels_per_unit,
+        &ThreadPool::get())};
+    Debug::PerfStats::get().add_evaluations(evaluated);
+  } else {
+    const Debug::StageTimer timer{Debug::PerfStats::Stage::Evaluate};
+    // Regions evaluate to 0 or 1, so their boundary is the 0.5 contour.
+    const bool region{kind == CompiledExpression::Kind::Region};
+    ImplicitPlot::Bounds bounds_xy;
+    if (expression->is_batched()) {
+      bounds_xy = [&expression](const Interval& x, const Interval& y) {
+        return expression->bounds(x, y);
+      };
+    }
+    std::atomic<std::size_t> evaluated{0};
+    state->implicit.update(
+        [&expression, &evaluated](
+            const double* x, const double* y, double* out, std::size_t count) {
+          expression->evaluate(x, y, out, count);
+          evaluated.fetch_add(count, std::memory_order_relaxed);
+        },
+        view.xmin,
+        view.xmax,
+        view.ymin,
+        view.ymax,
+        view.pixels_per_unit,
+        region ? 0.5 : 0.0,
+        region,
+        &ThreadPool::get(),
+        bounds_xy);
+    Debug::PerfStats::get().add_evaluations(evaluated);
+  }
+
+  state->cache_cost_ms +=
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  // Reuse the back buffer unless the UI still draws from it.
+  std::shared_ptr<Curve> buffer;
+  {
+    const std::lock_guard lock(state->mutex);
+    buffer = std::move(state->back);
+  }
+  if (buffer == nullptr || buffer.use_count() > 1) {
+    buffer = std::make_shared<Curve>();
+  }
+  buffer->ordered_by_x = kind == CompiledExpression::Kind::Explicit;
+  buffer->cost_ms = state->cache_cost_ms;
+  if (kind == CompiledExpression::Kind::Explicit) {
+    buffer->samples.assign(state->cache.curve().begin(), state->cache.curve().end());
+    buffer->segments.clear();
+    buffer->regions.clear();
+  } else if (expression->is_curve()) {
+    buffer->samples.assign(state->parametric.curve().begin(), state->parametric.curve().end());
+    buffer->segments.clear();
+    buffer->regions.clear();
+  } else {
+    buffer->samples.clear();
+    buffer->segments.assign(state->implicit.segments().begin(), state->implicit.segments().end());
+    buffer->regions.assign(state->implicit.regions().begin(), state->implicit.regions().end());
+  }
+
+  {
+    const std::lock_guard lock(state->mutex);
+    buffer->generation = ++state->generation;
+    state->back = std::move(state->front);
+    state->front = std::move(buffer);
+  }
+
+  state->busy = false;
+
+  if (const auto callback{g_publish_callback.load(std::memory_order_acquire)}) {
+    callback();
+  }
+}
+
+void AsyncCurve::seed(Curve curve) {
+  auto buffer{std::make_shared<Curve>(std::move(curve))};
+  const std::lock_guard lock(m_state->mutex);
+  buffer->generation = ++m_state->generation;
+  m_state->front = std::move(buffer);
+}
+
+std::shared_ptr<const AsyncCurve::Curve> AsyncCurve::latest() const {
+  const std::lock_guard lock(m_state->mutex);
+  return m_state->front;
+}
+
+bool AsyncCurve::is_pending() const {
+  return m_state->busy || m_state->stale;
+}
+
+void AsyncCurve::set_publish_callback(void (*callback)()) {
+  g_publish_callback.store(callback, std::memory_order_release);
+}
+
+}  // namespace App::Core
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Core/CompiledExpression.hpp"
+#include "Core/GridSweep.hpp"
+#include "Core/ImplicitPlot.hpp"
+#include "Core/ParametricCurve.hpp"
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+// Samples one expression in the background and publishes finished curves.
+// Implicit and region expressions are contoured with an ImplicitPlot instead, parametric and
+// polar curves are sampled in their parameter with a ParametricCurve.
+//
+// The UI thread calls `request()` every frame and draws whatever `latest()` returns; updating
+// the SampleCache runs as a ThreadPool task, so an expensive expression never stalls a frame.
+// Curves are double-buffered: a finished update swaps in a new buffer and recycles the previous
+// one once nobody holds it anymore.
+class AsyncCurve {
+ public:
+  struct View {
+    double xmin;
+    double xmax;
+    double ymin;  // for implicit and region expressions, and culling explicit ones
+    double ymax;
+    double pixels_per_unit;
+
+    bool operator==(const View& other) const = default;
+  };
+
+  struct Curve {
+    std::vector<Sample> samples;
+    bool ordered_by_x{true};  // false for parametric and polar curves
+    std::vector<ImplicitPlot::Segment> segments;
+    std::vector<ImplicitPlot::Box> regions;
+    std::uint64_t generation{0};  // increases with every published curve
+    // Evaluation time spent on the expression since its caches were last reset, i.e. roughly
+    // what it would cost to sample this curve again from scratch.
+    double cost_ms{0.0};
+  };
+
+  // Range to request for a visible [xmin, xmax] x [ymin, ymax]: each axis padded by a quarter of
+  // its extent on both sides and snapped to multiples of that quarter, so small pans keep
+  // requesting the same range and neither resample nor re-tessellate.
+  [[nodiscard]] static View padded_view(
+      double xmin, double xmax, double ymin, double ymax, double pixels_per_unit);
+
+  AsyncCurve();
+
+  // Starts a background update if the expression, a parameter it reads or the view changed
+  // since the last one and no update is running. Returns true if one was started. Grid points
+  // of explicit expressions are taken from `sweep` when it covers them. A null `expression` is
+  // ignored (returns false) and the latest curve stays as it is.
+  bool request(const std::shared_ptr<CompiledExpression>& expression,
+      View view,
+      std::shared_ptr<GridSweep> sweep = nullptr);
+
+  // Publishes `curve` (e.g. restored from a session) as the latest one, so it is drawn until
+  // the first update finishes. Call it before the first request.
+  void seed(Curve curve);
+
+  // Last finished curve (world space), possibly for an older view or expression. Never null.
+  [[nodiscard]] std::shared_ptr<const Curve> latest() const;
+  // True while an update is running or the latest curve does not match the last request.
+  [[nodiscard]] bool is_pending() const;
+
+  // Called on the worker thread after every published curve, e.g. to wake an idle UI loop.
+  // Set it before the first request.
+  static void set_publish_callback(void (*callback)());
+
+ private:
+  struct State {
+    std::atomic<bool> busy{false};
+    std::atomic<bool> stale{false};
+
+    // Only touched by the task that currently owns `busy`.
+    SampleCache cache;
+    ImplicitPlot implicit;
+    ParametricCurve parametric;
+    std::shared_ptr<CompiledExpression> cache_expression;
+    std::uint64_t cache_revision{0};  // parameter revision the caches were sampled at
+    double cache_cost_ms{0.0};        // evaluation time since the caches were reset
+
+    mutable std::mutex mutex;
+    std::shared_ptr<Curve> front;
+    std::shared_ptr<Curve> back;
+    std::uint64_t generation{0};
+  };
+
+  static void run(const std::shared_ptr<State>& state,
+      const std::shared_ptr<CompiledExpression>& expression,
+      std::uint64_t revision,
+      const View& view,
+      const std::shared_ptr<GridSweep>& sweep);
+
+  std::shared_ptr<State> m_state;
+  std::shared_ptr<CompiledExpression> m_requested_expression;
+  std::uint64_t m_requested_revision{0};
+  View m_requested_view{0.0, 0.0, 0.0, 0.0, 0.0};
+};
+
+}  // namespace App::Core
@@ -0,0 +1,161 @@
+#include "AxisLayer.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "Core/Debug/Instrumentor.hpp"
+
+namespace App::Core {
+
+bool AxisLayer::update(const Frame& frame, const ImDrawList* reference, ImFont* font) {
+  if (m_built && frame == m_frame) {
+    return false;
+  }
+
+  APP_PROFILE_FUNCTION();
+
+  m_built = true;
+  m_frame = frame;
+  m_geometry.clear();
+
+  if (font == nullptr) {
+    font = ImGui::GetFont();
+  }
+  m_scratch._Data = reference->_Data;
+  m_scratch._ResetForNewFrame();
+  m_scratch.Flags = reference->Flags;
+  m_scratch.PushClipRectFullScreen();
+  m_scratch.PushTextureID(font->ContainerAtlas->TexID);
+
+  const ImVec2 size{frame.width, frame.height};
+  const double origin_x{frame.origin_x};
+  const double origin_y{frame.origin_y};
+  const double step{nice_step(MIN_TICK_SPACING_PX / frame.pixels_per_unit)};
+  const double spacing{step * frame.pixels_per_unit};
+  if (step != m_label_step || m_labels.size() > MAX_CACHED_LABELS) {
+    m_labels.clear();
+    m_label_step = step;
+  }
+
+  // Tick indices covering the canvas; positions are computed from the index in double
+  // precision (the origin may be far away), so they do not accumulate rounding errors.
+  const auto first_x{static_cast<std::int64_t>(std::floor(-origin_x / spacing))};
+  const auto last_x{static_cast<std::int64_t>(std::ceil((size.x - origin_x) / spacing))};
+  const auto first_y{static_cast<std::int64_t>(std::floor((origin_y - size.y) / spacing))};
+  const auto last_y{static_cast<std::int64_t>(std::ceil(origin_y / spacing))};
+  const auto x_of{[&](std::int64_t tick) {
+    return static_cast<float>(origin_x + static_cast<double>(tick) * spacing);
+  }};
+  const auto y_of{[&](std::int64_t tick) {
+    return static_cast<float>(origin_y - static_cast<double>(tick) * spacing);
+  }};
+
+  // Axes. When the origin is out of view, its ticks and labels stay at the nearest edge, so
+  // coordinates can still be read at deep zoom.
+  const ImVec2 origin{static_cast<float>(std::clamp(origin_x, 0.0, static_cast<double>(size.x))),
+      static_cast<float>(std::clamp(origin_y, 0.0, static_cast<double>(size.y)))};
+  if (origin_y >= 0.0 && origin_y <= static_cast<double>(size.y)) {
+    m_scratch.AddLine(
+        ImVec2(0.0F, origin.y), ImVec2(size.x, origin.y), AXIS_COLOR, frame.axis_thickness);
+  }
+  if (origin_x >= 0.0 && origin_x <= static_cast<double>(size.x)) {
+    m_scratch.AddLine(
+        ImVec2(origin.x, 0.0F), ImVec2(origin.x, size.y), AXIS_COLOR, frame.axis_thickness);
+  }
+
+  // Ticks and labels, skipping the origin
+  for (std::int64_t tick = first_x; tick <= last_x; ++tick) {
+    const float x{x_of(tick)};
+    m_scratch.AddLine(ImVec2(x, origin.y - TICK_LENGTH),
+        ImVec2(x, origin.y + TICK_LENGTH),
+        TICK_COLOR,
+        1.0F);
+    if (tick != 0) {
+      const std::string& text{label(tick)};
+      m_scratch.AddText(font,
+          LABEL_FONT_SIZE,
+          ImVec2(x - 10.0F, origin.y + LABEL_OFFSET),
+          TEXT_COLOR,
+          text.data(),
+          text.data() + text.size());
+    }
+  }
+  for (std::int64_t tick = first_y; tick <= last_y; ++tick) {
+    const float y{y_of(tick)};
+    m_scratch.AddLine(ImVec2(origin.x - TICK_LENGTH, y),
+        ImVec2(origin.x + TICK_LENGTH, y),
+        TICK_COLOR,
+        1.0F);
+    if (tick != 0) {
+      const std::string& text{label(tick)};
+      m_scratch.AddText(font,
+          LABEL_FONT_SIZE,
+          ImVec2(origin.x + LABEL_OFFSET, y - 10.0F),
+          TEXT_COLOR,
+          text.data(),
+          text.data() + text.size());
+    }
+  }
+
+  // Grid
+  for (std::int64_t tick = first_x; tick <= last_x; ++tick) {
+    const float x{x_of(tick)};
+    m_scratch.AddLine(ImVec2(x, 0.0F), ImVec2(x, size.y), GRID_COLOR, 1.0F);
+  }
+  for (std::int64_t tick = first_y; tick <= last_y; ++tick) {
+    const float y{y_of(tick)};
+    m_scratch.AddLine(ImVec2(0.0F, y), ImVec2(size.x, y), GRID_COLOR, 1.0F);
+  }
+
+  m_geometry.capture(m_scratch);
+  return true;
+}
+
+void AxisLayer::draw(ImDrawList* draw_list, const ImVec2& canvas_min) const {
+  m_geometry.draw(draw_list, canvas_min);
+}
+
+double AxisLayer::nice_step(double min_step) {
+  if (!(min_step > 0.0) || !std::isfinite(min_step)) {
+    return 1.0;
+  }
+  const double magnitude{std::pow(10.0, std::floor(std::log10(min_step)))};
+  const double fraction{min_step / magnitude};
+  // A little slack so that rounding in log10 does not skip from 1 to 2.
+  if (fraction <= 1.0 + 1e-9) {
+    return magnitude;
+  }
+  if (fraction <= 2.0 + 1e-9) {
+    return 2.0 * magnitude;
+  }
+  if (fraction <= 5.0 + 1e-9) {
+    return 5.0 * magnitude;
+  }
+  return 10.0 * magnitude;
+}
+
+int AxisLayer::label_decimals(double step) {
+  return std::max(0, static_cast<int>(std::ceil(-std::log10(step) - 1e-9)));
+}
+
+const std::string& AxisLayer::label(std::int64_t tick) {
+  auto [it, inserted]{m_labels.try_emplace(tick)};
+  if (inserted) {
+    std::array<char, 32> text{};
+    std::snprintf(text.data(),
+        text.size(),
+        "%.*f",
+        label_decimals(m_label_step),
+        static_cast<double>(tick) * m_label_step);
+    it->second = text.data();
+  }
+  return it->second;
+}
+
+}  // namespace App::Core
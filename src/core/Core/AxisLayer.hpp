@@ -0,0 +1,75 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Core/RetainedGeometry.hpp"
+
+namespace App::Core {
+
+// Axes, grid lines, ticks and tick labels of the graph view, cached on the CPU between frames.
+//
+// The layer is only rebuilt when the zoom, the pan offset or the canvas size change; every other
+// frame copies the cached triangles. Labels are formatted once per tick and step and reused
+// while panning.
+class AxisLayer {
+ public:
+  struct Frame {
+    float width;  // canvas size
+    float height;
+    // World origin relative to the top-left of the canvas; far outside it at deep zoom.
+    double origin_x;
+    double origin_y;
+    double pixels_per_unit;
+    float axis_thickness;
+
+    bool operator==(const Frame& other) const = default;
+  };
+
+  // Rebuilds the layer if `frame` changed. `reference` is the draw list it is drawn into later;
+  // `font` (null for the current font) must come from its texture atlas. Returns true if it
+  // rebuilt.
+  bool update(const Frame& frame, const ImDrawList* reference, ImFont* font);
+
+  // Appends the layer for a canvas whose top-left corner is at `canvas_min` (screen space).
+  void draw(ImDrawList* draw_list, const ImVec2& canvas_min) const;
+
+  // Smallest 1, 2 or 5 times a power of ten that is at least `min_step`.
+  [[nodiscard]] static double nice_step(double min_step);
+  // Decimals needed to tell ticks `step` apart.
+  [[nodiscard]] static int label_decimals(double step);
+
+  // Ticks are at least this far apart, which bounds their number by the canvas size.
+  static constexpr double MIN_TICK_SPACING_PX{50.0};
+
+  // Style, shared with exports that draw the axes themselves (see Exporter).
+  static constexpr ImU32 AXIS_COLOR{IM_COL32(0, 0, 0, 255)};
+  static constexpr ImU32 TICK_COLOR{IM_COL32(100, 100, 100, 255)};
+  static constexpr ImU32 TEXT_COLOR{IM_COL32(50, 50, 50, 255)};
+  static constexpr ImU32 GRID_COLOR{IM_COL32(200, 200, 200, 80)};
+  static constexpr float TICK_LENGTH{5.0F};
+  // Distance of the labels from their axis.
+  static constexpr float LABEL_OFFSET{15.0F};
+  static constexpr float LABEL_FONT_SIZE{13.0F};
+
+ private:
+  // Labels of the current step by tick index; cleared when it grows past this.
+  static constexpr std::size_t MAX_CACHED_LABELS{4096};
+
+  // Text of tick `tick` of the current step.
+  const std::string& label(std::int64_t tick);
+
+  Frame m_frame{0.0F, 0.0F, 0.0, 0.0, 0.0, 0.0F};
+  bool m_built{false};
+
+  double m_label_step{0.0};
+  std::unordered_map<std::int64_t, std::string> m_labels;
+
+  RetainedGeometry m_geometry;
+  ImDrawList m_scratch{nullptr};
+};
+
+}  // namespace App::Core
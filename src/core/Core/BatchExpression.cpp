@@ -0,0 +1,826 @@
+#include "BatchExpression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Core/Constants.hpp"
+#include "Core/Interval.hpp"
+#include "Core/Parameters.hpp"
+
+namespace App::Core {
+
+namespace {
+
+using Op = BatchExpression::Op;
+using Instruction = BatchExpression::Instruction;
+
+struct FunctionInfo {
+  std::string_view name;
+  Op op;
+  int arity;
+};
+
+constexpr std::array<FunctionInfo, 24> FUNCTIONS{{
+    {"sin", Op::Sin, 1},
+    {"cos", Op::Cos, 1},
+    {"tan", Op::Tan, 1},
+    {"asin", Op::Asin, 1},
+    {"acos", Op::Acos, 1},
+    {"atan", Op::Atan, 1},
+    {"sinh", Op::Sinh, 1},
+    {"cosh", Op::Cosh, 1},
+    {"tanh", Op::Tanh, 1},
+    {"exp", Op::Exp, 1},
+    {"log", Op::Log, 1},
+    {"log10", Op::Log10, 1},
+    {"log2", Op::Log2, 1},
+    {"sqrt", Op::Sqrt, 1},
+    {"abs", Op::Abs, 1},
+    {"floor", Op::Floor, 1},
+    {"ceil", Op::Ceil, 1},
+    {"sgn", Op::Sgn, 1},
+    {"pow", Op::Pow, 2},
+    {"atan2", Op::Atan2, 2},
+    {"min", Op::Min, 2},
+    {"max", Op::Max, 2},
+    {"hypot", Op::Hypot, 2},
+    {"mod", Op::Mod, 2},
+}};
+
+double sgn(double value) {
+  if (value > 0.0) {
+    return 1.0;
+  }
+  if (value < 0.0) {
+    return -1.0;
+  }
+  return 0.0;
+}
+
+double apply(Op op, double a, double b) {
+  switch (op) {
+    case Op::Add:
+      return a + b;
+    case Op::Sub:
+      return a - b;
+    case Op::Mul:
+      return a * b;
+    case Op::Div:
+      return a / b;
+    case Op::Mod:
+      return std::fmod(a, b);
+    case Op::Pow:
+      return std::pow(a, b);
+    case Op::Neg:
+      return -a;
+    case Op::Sin:
+      return std::sin(a);
+    case Op::Cos:
+      return std::cos(a);
+    case Op::Tan:
+      return std::tan(a);
+    case Op::Asin:
+      return std::asin(a);
+    case Op::Acos:
+      return std::acos(a);
+    case Op::Atan:
+      return std::atan(a);
+    case Op::Sinh:
+      return std::sinh(a);
+    case Op::Cosh:
+      return std::cosh(a);
+    case Op::Tanh:
+      return std::tanh(a);
+    case Op::Exp:
+      return std::exp(a);
+    case Op::Log:
+      return std::log(a);
+    case Op::Log10:
+      return std::log10(a);
+    case Op::Log2:
+      return std::log2(a);
+    case Op::Sqrt:
+      return std::sqrt(a);
+    case Op::Abs:
+      return std::fabs(a);
+    case Op::Floor:
+      return std::floor(a);
+    case Op::Ceil:
+      return std::ceil(a);
+    case Op::Sgn:
+      return sgn(a);
+    case Op::Atan2:
+      return std::atan2(a, b);
+    case Op::Min:
+      return std::fmin(a, b);
+    case Op::Max:
+      return std::fmax(a, b);
+    case Op::Hypot:
+      return std::hypot(a, b);
+    case Op::Constant:
+    case Op::Variable:
+    case Op::Parameter:
+      break;
+  }
+  return a;
+}
+
+// `f` over `count` lanes, as one loop the compiler sees whole: simple arithmetic vectorizes,
+// calls into libm at least run without any dispatch between lanes.
+template <typename Function>
+void unary_lanes(const double* a, double* out, std::size_t count, Function f) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = f(a[i]);
+  }
+}
+
+template <typename Function>
+void binary_lanes(const double* a, const double* b, double* out, std::size_t count, Function f) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = f(a[i], b[i]);
+  }
+}
+
+// Runs `op` over `count` lanes, every op in a loop of its own.
+void apply_block(Op op, const double* a, const double* b, double* out, std::size_t count) {
+  switch (op) {
+    case Op::Add:
+      binary_lanes(a, b, out, count, [](double x, double y) { return x + y; });
+      return;
+    case Op::Sub:
+      binary_lanes(a, b, out, count, [](double x, double y) { return x - y; });
+      return;
+    case Op::Mul:
+      binary_lanes(a, b, out, count, [](double x, double y) { return x * y; });
+      return;
+    case Op::Div:
+      binary_lanes(a, b, out, count, [](double x, double y) { return x / y; });
+      return;
+    case Op::Mod:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::fmod(x, y); });
+      return;
+    case Op::Pow:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::pow(x, y); });
+      return;
+    case Op::Neg:
+      unary_lanes(a, out, count, [](double x) { return -x; });
+      return;
+    case Op::Sin:
+      unary_lanes(a, out, count, [](double x) { return std::sin(x); });
+      return;
+    case Op::Cos:
+      unary_lanes(a, out, count, [](double x) { return std::cos(x); });
+      return;
+    case Op::Tan:
+      unary_lanes(a, out, count, [](double x) { return std::tan(x); });
+      return;
+    case Op::Asin:
+      unary_lanes(a, out, count, [](double x) { return std::asin(x); });
+      return;
+    case Op::Acos:
+      unary_lanes(a, out, count, [](double x) { return std::acos(x); });
+      return;
+    case Op::Atan:
+      unary_lanes(a, out, count, [](double x) { return std::atan(x); });
+      return;
+    case Op::Sinh:
+      unary_lanes(a, out, count, [](double x) { return std::sinh(x); });
+      return;
+    case Op::Cosh:
+      unary_lanes(a, out, count, [](double x) { return std::cosh(x); });
+      return;
+    case Op::Tanh:
+      unary_lanes(a, out, count, [](double x) { return std::tanh(x); });
+      return;
+    case Op::Exp:
+      unary_lanes(a, out, count, [](double x) { return std::exp(x); });
+      return;
+    case Op::Log:
+      unary_lanes(a, out, count, [](double x) { return std::log(x); });
+      return;
+    case Op::Log10:
+      unary_lanes(a, out, count, [](double x) { return std::log10(x); });
+      return;
+    case Op::Log2:
+      unary_lanes(a, out, count, [](double x) { return std::log2(x); });
+      return;
+    case Op::Sqrt:
+      unary_lanes(a, out, count, [](double x) { return std::sqrt(x); });
+      return;
+    case Op::Abs:
+      unary_lanes(a, out, count, [](double x) { return std::fabs(x); });
+      return;
+    case Op::Floor:
+      unary_lanes(a, out, count, [](double x) { return std::floor(x); });
+      return;
+    case Op::Ceil:
+      unary_lanes(a, out, count, [](double x) { return std::ceil(x); });
+      return;
+    case Op::Sgn:
+      unary_lanes(a, out, count, [](double x) { return sgn(x); });
+      return;
+    case Op::Atan2:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::atan2(x, y); });
+      return;
+    case Op::Min:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::fmin(x, y); });
+      return;
+    case Op::Max:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::fmax(x, y); });
+      return;
+    case Op::Hypot:
+      binary_lanes(a, b, out, count, [](double x, double y) { return std::hypot(x, y); });
+      return;
+    case Op::Constant:
+    case Op::Variable:
+    case Op::Parameter:
+      return;
+  }
+}
+
+bool is_binary(Op op) {
+  switch (op) {
+    case Op::Add:
+    case Op::Sub:
+    case Op::Mul:
+    case Op::Div:
+    case Op::Mod:
+    case Op::Pow:
+    case Op::Atan2:
+    case Op::Min:
+    case Op::Max:
+    case Op::Hypot:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Instructions that read their value instead of computing it from registers.
+bool is_leaf(Op op) {
+  return op == Op::Constant || op == Op::Variable || op == Op::Parameter;
+}
+
+bool is_identifier_char(char c, bool first) {
+  const auto byte{static_cast<unsigned char>(c)};
+  // Bytes >= 0x80 belong to UTF-8 sequences such as `π`.
+  return std::isalpha(byte) != 0 || c == '_' || byte >= 0x80 || (!first && std::isdigit(byte));
+}
+
+// Runs `code` over `count` points, one block of lanes at a time; `store(registers, base, lanes)`
+// copies the results of each block out of the register file.
+template <typename Store>
+void run_blocks(const std::vector<Instruction>& code,
+    std::span<const double* const> inputs,
+    const Parameters* parameters,
+    std::size_t count,
+    Store&& store) {
+  constexpr std::size_t BLOCK_SIZE{BatchExpression::BLOCK_SIZE};
+
+  // Register file: one block of lanes per instruction, reused across calls on this thread.
+  thread_local std::vector<double> registers;
+  registers.resize(code.size() * BLOCK_SIZE);
+
+  // Constants and parameters are the same for every block, so fill them once.
+  for (std::size_t i = 0; i < code.size(); ++i) {
+    if (code[i].op == Op::Constant) {
+      std::fill_n(registers.data() + i * BLOCK_SIZE, BLOCK_SIZE, code[i].value);
+    } else if (code[i].op == Op::Parameter) {
+      std::fill_n(registers.data() + i * BLOCK_SIZE, BLOCK_SIZE, parameters->value(code[i].a));
+    }
+  }
+
+  for (std::size_t base = 0; base < count; base += BLOCK_SIZE) {
+    const std::size_t lanes{std::min(BLOCK_SIZE, count - base)};
+
+    for (std::size_t i = 0; i < code.size(); ++i) {
+      const Instruction& instruction{code[i]};
+      double* target{registers.data() + i * BLOCK_SIZE};
+
+      if (instruction.op == Op::Constant || instruction.op == Op::Parameter) {
+        continue;
+      }
+      if (instruction.op == Op::Variable) {
+        std::copy_n(inputs[instruction.a] + base, lanes, target);
+        continue;
+      }
+
+      apply_block(instruction.op,
+          registers.data() + instruction.a * BLOCK_SIZE,
+          registers.data() + instruction.b * BLOCK_SIZE,
+          target,
+          lanes);
+    }
+
+    store(registers.data(), base, lanes);
+  }
+}
+
+// Identity of an instruction for sharing it between programs; constants compare bitwise.
+struct InstructionKey {
+  Op op;
+  std::uint32_t a;
+  std::uint32_t b;
+  std::uint64_t value;
+
+  bool operator==(const InstructionKey& other) const = default;
+};
+
+struct InstructionKeyHash {
+  std::size_t operator()(const InstructionKey& key) const {
+    std::uint64_t hash{static_cast<std::uint64_t>(key.op)};
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ key.a;
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ key.b;
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ key.value;
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+  }
+};
+
+}  // namespace
+
+// Recursive-descent parser for the supported subset of exprtk's syntax:
+//
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/' | '%') unary)*
+//   unary      := ('-' | '+') unary | power
+//   power      := primary ('^' unary)?
+//   primary    := number | constant | variable | parameter | function '(' args ')'
+//               | bracket expression
+class BatchParser {
+ public:
+  BatchParser(std::string_view source,
+      std::span<const std::string_view> variables,
+      const Parameters* parameters,
+      std::vector<Instruction>& code)
+      : m_source(source),
+        m_variables(variables),
+        m_parameters(parameters),
+        m_code(code) {}
+
+  bool parse() {
+    std::uint32_t result{0};
+    if (!parse_expression(result)) {
+      return false;
+    }
+    skip_whitespace();
+    if (m_position != m_source.size() || m_code.empty()) {
+      return false;
+    }
+    // The output is always the last instruction.
+    if (result != m_code.size() - 1) {
+      const Instruction copy{m_code[result]};
+      if (is_leaf(copy.op)) {
+        m_code.push_back(copy);
+      } else {
+        m_code.push_back({Op::Add, result, constant(0.0), 0.0});
+      }
+    }
+    prune();
+    return m_code.size() <= BatchExpression::MAX_INSTRUCTIONS;
+  }
+
+ private:
+  // Drops instructions the output does not depend on, e.g. constants that were folded.
+  void prune() {
+    std::vector<bool> live(m_code.size(), false);
+    live.back() = true;
+    for (std::size_t i = m_code.size(); i-- > 0;) {
+      if (!live[i] || is_leaf(m_code[i].op)) {
+        continue;
+      }
+      live[m_code[i].a] = true;
+      if (is_binary(m_code[i].op)) {
+        live[m_code[i].b] = true;
+      }
+    }
+
+    std::vector<std::uint32_t> remap(m_code.size(), 0);
+    std::size_t kept{0};
+    for (std::size_t i = 0; i < m_code.size(); ++i) {
+      if (!live[i]) {
+        continue;
+      }
+      Instruction instruction{m_code[i]};
+      if (!is_leaf(instruction.op)) {
+        instruction.a = remap[instruction.a];
+        instruction.b = is_binary(instruction.op) ? remap[instruction.b] : 0;
+      }
+      remap[i] = static_cast<std::uint32_t>(kept);
+      m_code[kept++] = instruction;
+    }
+    m_code.resize(kept);
+  }
+
+  void skip_whitespace() {
+    while (m_position < m_source.size() &&
+           std::isspace(static_cast<unsigned char>(m_source[m_position])) != 0) {
+      ++m_position;
+    }
+  }
+
+  bool accept(char c) {
+    skip_whitespace();
+    if (m_position < m_source.size() && m_source[m_position] == c) {
+      ++m_position;
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] char peek() {
+    skip_whitespace();
+    return m_position < m_source.size() ? m_source[m_position] : '\0';
+  }
+
+  // Interns an instruction: identical instructions share one register, and instructions on
+  // constants are folded.
+  std::uint32_t emit(Op op, std::uint32_t a, std::uint32_t b = 0) {
+    const bool unary{!is_binary(op)};
+    if (m_code[a].op == Op::Constant && (unary || m_code[b].op == Op::Constant)) {
+      return constant(apply(op, m_code[a].value, unary ? 0.0 : m_code[b].value));
+    }
+    return intern({op, a, unary ? 0 : b, 0.0});
+  }
+
+  std::uint32_t constant(double value) {
+    return intern({Op::Constant, 0, 0, value});
+  }
+
+  std::uint32_t intern(const Instruction& instruction) {
+    for (std::size_t i = 0; i < m_code.size(); ++i) {
+      const Instruction& other{m_code[i]};
+      const bool same_value{instruction.op != Op::Constant ||
+                            std::bit_cast<std::uint64_t>(other.value) ==
+                                std::bit_cast<std::uint64_t>(instruction.value)};
+      if (other.op == instruction.op && other.a == instruction.a && other.b == instruction.b &&
+          same_value) {
+        return static_cast<std::uint32_t>(i);
+      }
+    }
+    m_code.push_back(instruction);
+    return static_cast<std::uint32_t>(m_code.size() - 1);
+  }
+
+  bool parse_expression(std::uint32_t& result) {
+    if (!parse_term(result)) {
+      return false;
+    }
+    while (true) {
+      Op op{};
+      if (accept('+')) {
+        op = Op::Add;
+      } else if (accept('-')) {
+        op = Op::Sub;
+      } else {
+        return true;
+      }
+      std::uint32_t rhs{0};
+      if (!parse_term(rhs)) {
+        return false;
+      }
+      result = emit(op, result, rhs);
+    }
+  }
+
+  bool parse_term(std::uint32_t& result) {
+    if (!parse_unary(result)) {
+      return false;
+    }
+    while (true) {
+      Op op{};
+      if (accept('*')) {
+        op = Op::Mul;
+      } else if (accept('/')) {
+        op = Op::Div;
+      } else if (accept('%')) {
+        op = Op::Mod;
+      } else {
+        return true;
+      }
+      std::uint32_t rhs{0};
+      if (!parse_unary(rhs)) {
+        return false;
+      }
+      result = emit(op, result, rhs);
+    }
+  }
+
+  bool parse_unary(std::uint32_t& result) {
+    if (accept('-')) {
+      if (!parse_unary(result)) {
+        return false;
+      }
+      result = emit(Op::Neg, result);
+      return true;
+    }
+    if (accept('+')) {
+      return parse_unary(result);
+    }
+    return parse_power(result);
+  }
+
+  bool parse_power(std::uint32_t& result) {
+    if (!parse_primary(result)) {
+      return false;
+    }
+    if (accept('^')) {
+      std::uint32_t exponent{0};
+      if (!parse_unary(exponent)) {
+        return false;
+      }
+      result = emit(Op::Pow, result, exponent);
+    }
+    return true;
+  }
+
+  bool parse_primary(std::uint32_t& result) {
+    const char c{peek()};
+
+    for (const auto& [open, close] : {std::pair{'(', ')'}, {'[', ']'}, {'{', '}'}}) {
+      if (c == open) {
+        ++m_position;
+        return parse_expression(result) && accept(close);
+      }
+    }
+
+    if (std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '.') {
+      return parse_number(result);
+    }
+
+    if (is_identifier_char(c, true)) {
+      return parse_identifier(result);
+    }
+
+    return false;
+  }
+
+  bool parse_number(std::uint32_t& result) {
+    double value{0.0};
+    const char* begin{m_source.data() + m_position};
+    const char* end{m_source.data() + m_source.size()};
+    const auto [ptr, error]{std::from_chars(begin, end, value)};
+    if (error != std::errc{}) {
+      return false;
+    }
+    m_position += static_cast<std::size_t>(ptr - begin);
+    // Implicit multiplication such as `2x` is left to exprtk.
+    if (m_position < m_source.size() && is_identifier_char(m_source[m_position], false)) {
+      return false;
+    }
+    result = constant(value);
+    return true;
+  }
+
+  bool parse_identifier(std::uint32_t& result) {
+    const std::size_t start{m_position};
+    while (m_position < m_source.size() &&
+           is_identifier_char(m_source[m_position], m_position == start)) {
+      ++m_position;
+    }
+    const std::string_view name{m_source.substr(start, m_position - start)};
+
+    if (peek() == '(') {
+      const auto* function{std::find_if(FUNCTIONS.begin(),
+          FUNCTIONS.end(),
+          [name](const FunctionInfo& info) { return info.name == name; })};
+      if (function == FUNCTIONS.end()) {
+        return false;
+      }
+      ++m_position;
+
+      std::uint32_t a{0};
+      std::uint32_t b{0};
+      if (!parse_expression(a)) {
+        return false;
+      }
+      if (function->arity == 2 && (!accept(',') || !parse_expression(b))) {
+        return false;
+      }
+      if (!accept(')')) {
+        return false;
+      }
+      result = emit(function->op, a, b);
+      return true;
+    }
+
+    for (std::size_t i = 0; i < m_variables.size(); ++i) {
+      if (m_variables[i] == name) {
+        result = intern({Op::Variable, static_cast<std::uint32_t>(i), 0, 0.0});
+        return true;
+      }
+    }
+
+    if (const auto* info{Constants::find(name)}; info != nullptr) {
+      result = constant(info->value);
+      return true;
+    }
+
+    // Parameters are leaves rather than constants, so nothing depending on them is folded.
+    const std::size_t id{m_parameters == nullptr ? Parameters::NONE : m_parameters->find(name)};
+    if (id != Parameters::NONE) {
+      result = intern({Op::Parameter, static_cast<std::uint32_t>(id), 0, 0.0});
+      return true;
+    }
+
+    return false;
+  }
+
+  std::string_view m_source;
+  std::span<const std::string_view> m_variables;
+  const Parameters* m_parameters;
+  std::vector<Instruction>& m_code;
+  std::size_t m_position{0};
+};
+
+bool BatchExpression::compile(std::string_view source,
+    std::span<const std::string_view> variables,
+    const Parameters* parameters) {
+  m_code.clear();
+  m_variable_count = variables.size();
+  m_parameters = parameters;
+
+  BatchParser parser{source, variables, parameters, m_code};
+  m_valid = parser.parse();
+  if (!m_valid) {
+    m_code.clear();
+  }
+  return m_valid;
+}
+
+bool BatchExpression::compile(std::string_view source) {
+  static constexpr std::array<std::string_view, 1> VARIABLES{"x"};
+  return compile(source, VARIABLES);
+}
+
+bool BatchExpression::is_valid() const {
+  return m_valid;
+}
+
+const std::vector<BatchExpression::Instruction>& BatchExpression::instructions() const {
+  return m_code;
+}
+
+std::size_t BatchExpression::variable_count() const {
+  return m_variable_count;
+}
+
+const Parameters* BatchExpression::parameters() const {
+  return m_parameters;
+}
+
+void BatchExpression::evaluate(std::span<const double* const> inputs,
+    double* out,
+    std::size_t count) const {
+  const std::size_t result{m_code.size() - 1};
+  run_blocks(m_code,
+      inputs,
+      m_parameters,
+      count,
+      [&](const double* registers, std::size_t base, std::size_t lanes) {
+        std::copy_n(registers + result * BLOCK_SIZE, lanes, out + base);
+      });
+}
+
+void BatchExpression::evaluate(const double* x, double* out, std::size_t count) const {
+  const std::array<const double*, 1> inputs{x};
+  evaluate(inputs, out, count);
+}
+
+// Scalar path for single-variable expressions, used for one-off samples such as refinements.
+double BatchExpression::evaluate(double x) const {
+  thread_local std::vector<double> registers;
+  registers.resize(m_code.size());
+
+  for (std::size_t i = 0; i < m_code.size(); ++i) {
+    const Instruction& instruction{m_code[i]};
+    switch (instruction.op) {
+      case Op::Constant:
+        registers[i] = instruction.value;
+        break;
+      case Op::Variable:
+        registers[i] = x;
+        break;
+      case Op::Parameter:
+        registers[i] = m_parameters->value(instruction.a);
+        break;
+      default:
+        registers[i] = apply(instruction.op, registers[instruction.a], registers[instruction.b]);
+        break;
+    }
+  }
+
+  return registers.empty() ? 0.0 : registers.back();
+}
+
+// Interval path: the same program over ranges instead of values.
+Interval BatchExpression::evaluate(std::span<const Interval> inputs) const {
+  thread_local std::vector<Interval> registers;
+  registers.resize(m_code.size());
+
+  for (std::size_t i = 0; i < m_code.size(); ++i) {
+    const Instruction& instruction{m_code[i]};
+    switch (instruction.op) {
+      case Op::Constant:
+        registers[i] = Interval::point(instruction.value);
+        break;
+      case Op::Variable:
+        registers[i] = inputs[instruction.a];
+        break;
+      case Op::Parameter:
+        registers[i] = Interval::point(m_parameters->value(instruction.a));
+        break;
+      default:
+        registers[i] = Interval::apply(
+            instruction.op, registers[instruction.a], registers[instruction.b]);
+        break;
+    }
+  }
+
+  return registers.empty() ? Interval::point(0.0) : registers.back();
+}
+
+bool BatchProgram::compile(std::span<const BatchExpression* const> expressions) {
+  m_code.clear();
+  m_outputs.clear();
+  m_parameters = expressions.empty() || expressions.front() == nullptr
+                     ? nullptr
+                     : expressions.front()->parameters();
+
+  // Every instruction is re-interned into the shared code, so whatever the expressions have in
+  // common (x itself, constants, sin(x), ...) is computed once per block.
+  std::unordered_map<InstructionKey, std::uint32_t, InstructionKeyHash> interned;
+  std::vector<std::uint32_t> remap;
+  for (const BatchExpression* expression : expressions) {
+    if (expression == nullptr || !expression->is_valid() || expression->variable_count() != 1 ||
+        expression->parameters() != m_parameters) {
+      m_code.clear();
+      m_outputs.clear();
+      return false;
+    }
+
+    const std::vector<Instruction>& code{expression->instructions()};
+    remap.assign(code.size(), 0);
+    for (std::size_t i = 0; i < code.size(); ++i) {
+      Instruction instruction{code[i]};
+      if (!is_leaf(instruction.op)) {
+        instruction.a = remap[instruction.a];
+        instruction.b = is_binary(instruction.op) ? remap[instruction.b] : 0;
+      }
+      const InstructionKey key{instruction.op,
+          instruction.a,
+          instruction.b,
+          instruction.op == Op::Constant ? std::bit_cast<std::uint64_t>(instruction.value) : 0};
+      const auto [it, inserted]{
+          interned.try_emplace(key, static_cast<std::uint32_t>(m_code.size()))};
+      if (inserted) {
+        m_code.push_back(instruction);
+      }
+      remap[i] = it->second;
+    }
+    m_outputs.push_back(remap.back());
+  }
+  return true;
+}
+
+std::size_t BatchProgram::output_count() const {
+  return m_outputs.size();
+}
+
+const std::vector<BatchExpression::Instruction>& BatchProgram::instructions() const {
+  return m_code;
+}
+
+void BatchProgram::evaluate(const double* x,
+    std::size_t count,
+    double* out,
+    std::size_t stride) const {
+  if (m_code.empty()) {
+    return;
+  }
+  const std::array<const double*, 1> inputs{x};
+  run_blocks(m_code,
+      inputs,
+      m_parameters,
+      count,
+      [&](const double* registers, std::size_t base, std::size_t lanes) {
+        for (std::size_t j = 0; j < m_outputs.size(); ++j) {
+          std::copy_n(registers + m_outputs[j] * BatchExpression::BLOCK_SIZE,
+              lanes,
+              out + j * stride + base);
+        }
+      });
+}
+
+}  // namespace App::Core
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Parameters.hpp"
+
+namespace App::Core {
+
+struct Interval;
+
+// Block-at-a-time backend for the common subset of expressions: arithmetic, powers and the
+// elementary functions of a few variables and parameters.
+//
+// The source is lowered to a flat list of instructions in SSA form (every instruction writes the
+// register of its own index) with constants folded and common subexpressions shared. Evaluation
+// runs every instruction over a block of BLOCK_SIZE points at once, so the per-node dispatch is
+// paid once per block instead of once per sample, and each instruction is a plain loop over the
+// block. The arithmetic loops auto-vectorize; the elementary functions call libm lane by lane
+// (vectorized only where the toolchain supplies a vector math library). Anything outside the
+// subset fails to compile and the caller keeps using exprtk.
+class BatchExpression {
+ public:
+  static constexpr std::size_t BLOCK_SIZE{64};
+  static constexpr std::size_t MAX_INSTRUCTIONS{512};
+
+  enum class Op : std::uint8_t {
+    Constant,
+    Variable,
+    Parameter,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Pow,
+    Neg,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Sinh,
+    Cosh,
+    Tanh,
+    Exp,
+    Log,
+    Log10,
+    Log2,
+    Sqrt,
+    Abs,
+    Floor,
+    Ceil,
+    Sgn,
+    Atan2,
+    Min,
+    Max,
+    Hypot,
+  };
+
+  struct Instruction {
+    Op op;
+    std::uint32_t a;  // first operand register, variable index or parameter id
+    std::uint32_t b;  // second operand register
+    double value;     // for Op::Constant
+  };
+
+  // Lowers `source` over the given variable names and the parameters defined in `parameters`,
+  // whose values are read on every evaluation (so the table must outlive the expression).
+  // Returns false if the expression uses anything the batch backend does not support.
+  bool compile(std::string_view source,
+      std::span<const std::string_view> variables,
+      const Parameters* parameters = nullptr);
+  bool compile(std::string_view source);  // single variable `x`
+
+  [[nodiscard]] bool is_valid() const;
+  [[nodiscard]] const std::vector<Instruction>& instructions() const;
+  [[nodiscard]] std::size_t variable_count() const;
+  [[nodiscard]] const Parameters* parameters() const;
+
+  // Evaluates `count` points; `inputs[v]` holds the values of variable v.
+  void evaluate(std::span<const double* const> inputs, double* out, std::size_t count) const;
+  void evaluate(const double* x, double* out, std::size_t count) const;
+  [[nodiscard]] double evaluate(double x) const;
+  // Bounds over variable v ranging over `inputs[v]` (see Interval).
+  [[nodiscard]] Interval evaluate(std::span<const Interval> inputs) const;
+
+ private:
+  friend class BatchParser;
+
+  std::vector<Instruction> m_code;
+  std::size_t m_variable_count{0};
+  const Parameters* m_parameters{nullptr};
+  bool m_valid{false};
+};
+
+// Several single-variable BatchExpressions fused into one program over a shared x.
+//
+// Instructions the expressions have in common (the variable, constants and any shared
+// subexpression such as sin(x)) exist once in the fused code, so plotting several functions of
+// the same grid reads x once per block and computes what they share once. Results are written
+// column-major: one contiguous column per expression.
+class BatchProgram {
+ public:
+  // Returns false if any expression is invalid, has more than one variable or reads another
+  // parameter table than the others.
+  bool compile(std::span<const BatchExpression* const> expressions);
+
+  [[nodiscard]] std::size_t output_count() const;
+  [[nodiscard]] const std::vector<BatchExpression::Instruction>& instructions() const;
+
+  // Evaluates `count` points of `x`; expression j writes `out[j * stride + i]`.
+  void evaluate(const double* x, std::size_t count, double* out, std::size_t stride) const;
+
+ private:
+  std::vector<BatchExpression::Instruction> m_code;
+  std::vector<std::uint32_t> m_outputs;  // result register of each expression
+  const Parameters* m_parameters{nullptr};
+};
+
+}  // namespace App::Core
@@ -0,0 +1,391 @@
+#include "CompiledExpression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Core/Constants.hpp"
+#include "Core/Interval.hpp"
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+#include "Core/ThreadPool.hpp"
+#include "exprtk.hpp"
+
+namespace App::Core {
+
+namespace {
+
+constexpr std::array<std::string_view, 1> LINE_VARIABLES{"x"};
+constexpr std::array<std::string_view, 2> PLANE_VARIABLES{"x", "y"};
+constexpr std::array<std::string_view, 1> PARAMETRIC_VARIABLES{"t"};
+constexpr std::array<std::string_view, 1> POLAR_VARIABLES{"theta"};
+
+// Names bound to the first and (for two-variable kinds) second input.
+std::span<const std::string_view> variables(CompiledExpression::Kind kind) {
+  switch (kind) {
+    case CompiledExpression::Kind::Implicit:
+    case CompiledExpression::Kind::Region:
+      return PLANE_VARIABLES;
+    case CompiledExpression::Kind::Parametric:
+      return PARAMETRIC_VARIABLES;
+    case CompiledExpression::Kind::Polar:
+      return POLAR_VARIABLES;
+    case CompiledExpression::Kind::Explicit:
+    case CompiledExpression::Kind::Definition:
+      break;
+  }
+  return LINE_VARIABLES;
+}
+
+// Equal, both NaN, or within rounding of each other.
+bool agrees(double expected, double actual) {
+  if (std::isnan(expected) || std::isnan(actual)) {
+    return std::isnan(expected) == std::isnan(actual);
+  }
+  const double scale{std::max({1.0, std::fabs(expected), std::fabs(actual)})};
+  return expected == actual || std::fabs(expected - actual) <= 1e-12 * scale;
+}
+
+}  // namespace
+
+struct CompiledExpression::Instance {
+  // A parameter as this instance sees it; exprtk reads `value` by reference.
+  struct Binding {
+    std::size_t id;
+    double value;
+  };
+
+  // Called by exprtk for every name that is not a variable: adds the shared constant or the
+  // parameter of that name to the symbol table, or fails the compilation.
+  class Resolver final : public exprtk::parser<double>::unknown_symbol_resolver {
+   public:
+    Resolver(Instance& instance, const Parameters* parameters)
+        : unknown_symbol_resolver(e_usrmode_extended),
+          m_instance(instance),
+          m_parameters(parameters) {}
+
+    using unknown_symbol_resolver::process;
+    bool process(const std::string& name,
+        exprtk::symbol_table<double>& table,
+        std::string& error) override {
+      if (const auto* constant{Constants::find(name)}; constant != nullptr) {
+        return table.add_constant(name, constant->value);
+      }
+      const std::size_t id{
+          m_parameters == nullptr ? Parameters::NONE : m_parameters->find(name)};
+      if (id == Parameters::NONE) {
+        error = "Unknown symbol '" + name + "'";
+        return false;
+      }
+      m_instance.bindings.push_back({id, m_parameters->value(id)});
+      return table.add_variable(name, m_instance.bindings.back().value);
+    }
+
+   private:
+    Instance& m_instance;
+    const Parameters* m_parameters;
+  };
+
+  double x{0.0};
+  double y{0.0};
+  std::deque<Binding> bindings;  // stable addresses, as the symbol table points into them
+  std::uint64_t revision{0};     // of the Parameters the bindings were last read at
+  exprtk::symbol_table<double> symbol_table;
+  exprtk::expression<double> expression;
+  exprtk::expression<double> y_expression;  // y(t) of parametric curves
+
+  bool compile(const std::string& source,
+      const std::string& y_source,
+      Kind kind,
+      const Parameters* parameters,
+      std::string* error) {
+    if (parameters != nullptr) {
+      revision = parameters->revision();
+    }
+    const auto names{variables(kind)};
+    symbol_table.add_variable(std::string{names[0]}, x);
+    if (names.size() > 1) {
+      symbol_table.add_variable(std::string{names[1]}, y);
+    }
+    expression.register_symbol_table(symbol_table);
+    y_expression.register_symbol_table(symbol_table);
+
+    Resolver resolver{*this, parameters};
+    exprtk::parser<double> parser;
+    parser.enable_unknown_symbol_resolver(&resolver);
+    bool compiled{parser.compile(source, expression)};
+    if (compiled && kind == Kind::Parametric) {
+      compiled = parser.compile(y_source, y_expression);
+    }
+    if (!compiled && error != nullptr) {
+      *error = parser.error();
+    }
+    return compiled;
+  }
+
+  // Picks up parameter values changed since the last evaluation.
+  void refresh(const Parameters& parameters) {
+    const std::uint64_t current{parameters.revision()};
+    if (current == revision) {
+      return;
+    }
+    revision = current;
+    for (auto& binding : bindings) {
+      binding.value = parameters.value(binding.id);
+    }
+  }
+};
+
+CompiledExpression::CompiledExpression(
+    std::string_view source, Kind kind, std::shared_ptr<const Parameters> parameters)
+    : CompiledExpression(source, {}, kind, DEFAULT_DOMAIN, std::move(parameters)) {}
+
+CompiledExpression::CompiledExpression(std::string_view source,
+    std::string_view y_source,
+    Kind kind,
+    Domain domain,
+    std::shared_ptr<const Parameters> parameters)
+    : m_source(source),
+      m_y_source(y_source),
+      m_kind(kind),
+      m_domain(domain),
+      m_parameters(std::move(parameters)),
+      m_instances(ThreadPool::get().slot_count()) {
+  APP_PROFILE_FUNCTION();
+
+  // Compile once up front on this thread's slot to validate the source.
+  auto& instance{m_instances[ThreadPool::current_slot()]};
+  instance = std::make_unique<Instance>();
+  m_valid = instance->compile(m_source, m_y_source, m_kind, m_parameters.get(), &m_error);
+  for (const auto& binding : instance->bindings) {
+    m_parameter_ids.push_back(binding.id);
+  }
+  std::sort(m_parameter_ids.begin(), m_parameter_ids.end());
+  if (m_valid && is_curve() &&
+      !(std::isfinite(m_domain.min) && std::isfinite(m_domain.max) &&
+          m_domain.max > m_domain.min)) {
+    m_valid = false;
+    m_error = "Invalid parameter domain";
+  }
+
+  const bool lowered{
+      m_valid && m_batch.compile(m_source, variables(m_kind), m_parameters.get()) &&
+      (m_kind != Kind::Parametric ||
+          m_y_batch.compile(m_y_source, variables(m_kind), m_parameters.get()))};
+  if (!lowered) {
+    m_batch = BatchExpression{};
+    m_y_batch = BatchExpression{};
+  }
+  if (lowered && !matches_exprtk(*instance)) {
+    APP_DEBUG("Batch backend disagrees with exprtk for '{}', using exprtk only", m_source);
+    m_batch = BatchExpression{};
+    m_y_batch = BatchExpression{};
+  }
+}
+
+CompiledExpression::~CompiledExpression() = default;
+
+bool CompiledExpression::is_valid() const {
+  return m_valid;
+}
+
+const std::string& CompiledExpression::source() const {
+  return m_source;
+}
+
+const std::string& CompiledExpression::error() const {
+  return m_error;
+}
+
+bool CompiledExpression::is_batched() const {
+  return m_batch.is_valid();
+}
+
+const BatchExpression& CompiledExpression::batch() const {
+  return m_batch;
+}
+
+CompiledExpression::Kind CompiledExpression::kind() const {
+  return m_kind;
+}
+
+bool CompiledExpression::is_curve() const {
+  return m_kind == Kind::Parametric || m_kind == Kind::Polar;
+}
+
+CompiledExpression::Domain CompiledExpression::domain() const {
+  return m_domain;
+}
+
+const std::vector<std::size_t>& CompiledExpression::parameters() const {
+  return m_parameter_ids;
+}
+
+std::uint64_t CompiledExpression::parameter_revision() const {
+  std::uint64_t revision{0};
+  for (const std::size_t id : m_parameter_ids) {
+    revision += m_parameters->revision(id);
+  }
+  return revision;
+}
+
+double CompiledExpression::evaluate(double x) {
+  if (!m_valid) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (m_batch.is_valid()) {
+    return m_batch.evaluate(x);
+  }
+
+  Instance& slot{instance()};
+  slot.x = x;
+  return slot.expression.value();
+}
+
+void CompiledExpression::evaluate(const double* x, double* out, std::size_t count) {
+  if (m_valid && m_batch.is_valid()) {
+    m_batch.evaluate(x, out, count);
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = evaluate(x[i]);
+  }
+}
+
+double CompiledExpression::evaluate(double x, double y) {
+  if (!m_valid) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (m_batch.is_valid()) {
+    double out{0.0};
+    evaluate(&x, &y, &out, 1);
+    return out;
+  }
+
+  Instance& slot{instance()};
+  slot.x = x;
+  slot.y = y;
+  return slot.expression.value();
+}
+
+void CompiledExpression::evaluate(const double* x,
+    const double* y,
+    double* out,
+    std::size_t count) {
+  if (m_valid && m_batch.is_valid()) {
+    const std::array<const double*, 2> inputs{x, y};
+    m_batch.evaluate(inputs, out, count);
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = evaluate(x[i], y[i]);
+  }
+}
+
+Interval CompiledExpression::bounds(const Interval& x) const {
+  if (!m_valid || !m_batch.is_valid() || m_batch.variable_count() != 1) {
+    return Interval::whole();
+  }
+  const std::array<Interval, 1> inputs{x};
+  return m_batch.evaluate(inputs);
+}
+
+Interval CompiledExpression::bounds(const Interval& x, const Interval& y) const {
+  if (!m_valid || !m_batch.is_valid() || m_batch.variable_count() != 2) {
+    return Interval::whole();
+  }
+  const std::array<Interval, 2> inputs{x, y};
+  return m_batch.evaluate(inputs);
+}
+
+void CompiledExpression::evaluate_curve(const double* t, double* x, double* y, std::size_t count) {
+  if (m_kind == Kind::Parametric) {
+    evaluate_component(false, t, x, count);
+    evaluate_component(true, t, y, count);
+    return;
+  }
+
+  // Polar: r(theta) into x, then onto the plane.
+  evaluate_component(false, t, x, count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const double r{x[i]};
+    x[i] = r * std::cos(t[i]);
+    y[i] = r * std::sin(t[i]);
+  }
+}
+
+void CompiledExpression::evaluate_component(
+    bool second, const double* x, double* out, std::size_t count) {
+  if (!m_valid) {
+    std::fill(out, out + count, std::numeric_limits<double>::quiet_NaN());
+    return;
+  }
+  const BatchExpression& batch{second ? m_y_batch : m_batch};
+  if (batch.is_valid()) {
+    batch.evaluate(x, out, count);
+    return;
+  }
+
+  Instance& slot{instance()};
+  const exprtk::expression<double>& expression{second ? slot.y_expression : slot.expression};
+  for (std::size_t i = 0; i < count; ++i) {
+    slot.x = x[i];
+    out[i] = expression.value();
+  }
+}
+
+CompiledExpression::Instance& CompiledExpression::instance() {
+  // Each slot is only ever touched by its own thread, so no locking is needed.
+  auto& instance{m_instances[ThreadPool::current_slot()]};
+  if (instance == nullptr) {
+    APP_PROFILE_SCOPE("CompiledExpression::compile_instance");
+    instance = std::make_unique<Instance>();
+    instance->compile(m_source, m_y_source, m_kind, m_parameters.get(), nullptr);
+  }
+  if (m_parameters != nullptr) {
+    instance->refresh(*m_parameters);
+  }
+  return *instance;
+}
+
+bool CompiledExpression::matches_exprtk(Instance& instance) const {
+  static constexpr std::array<double, 7> PROBES{-3.7, -1.0, -0.31, 0.0, 0.5, 1.9, 4.2};
+
+  for (std::size_t i = 0; i < PROBES.size(); ++i) {
+    // Implicit expressions pair every x with a different y.
+    const double x{PROBES[i]};
+    const double y{PROBES[PROBES.size() - 1 - i]};
+    instance.x = x;
+    instance.y = y;
+    const double expected{instance.expression.value()};
+
+    double actual{0.0};
+    if (variables(m_kind).size() == 1) {
+      actual = m_batch.evaluate(x);
+    } else {
+      const std::array<const double*, 2> inputs{&x, &y};
+      m_batch.evaluate(inputs, &actual, 1);
+    }
+    if (!agrees(expected, actual)) {
+      return false;
+    }
+    if (m_kind == Kind::Parametric &&
+        !agrees(instance.y_expression.value(), m_y_batch.evaluate(x))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/BatchExpression.hpp"
+#include "Core/Interval.hpp"
+#include "Core/Parameters.hpp"
+
+namespace App::Core {
+
+// A parsed exprtk expression of `x` (of `x` and `y` for implicit plots, of `t` for parametric
+// and of `theta` for polar curves) together with the symbol table it is bound to.
+// Compiling is the expensive part of plotting, so instances are built once per source
+// text and kept alive for as long as the text does not change.
+//
+// exprtk expressions are not thread-safe with a shared `x`, so every ThreadPool slot gets its
+// own symbol table, variable and compiled expression, built lazily the first time that slot
+// evaluates. The table only holds what the source mentions: its variables, the constants it
+// uses (from the shared Constants) and the parameters it uses, bound to a copy of their value
+// that the slot refreshes whenever the Parameters change.
+//
+// Expressions in the subset supported by BatchExpression are additionally lowered to bytecode,
+// which is stateless (and thus shared by all slots) and evaluates dense batches much faster.
+// The lowering is cross-checked against exprtk at a few probe points and dropped on any
+// disagreement, so exprtk remains the reference.
+class CompiledExpression {
+ public:
+  // How the source is plotted: as y = f(x), as the zero set of f(x, y), as the region where
+  // the 0/1 result of f(x, y) is true, as the curve (x(t), y(t)) or as the polar curve
+  // r(theta). Definitions (of parameters and functions for the other rows) are compiled in
+  // `x` to validate them but not plotted.
+  enum class Kind { Explicit, Implicit, Region, Parametric, Polar, Definition };
+
+  // Parameter interval of parametric and polar curves.
+  struct Domain {
+    double min;
+    double max;
+  };
+  static constexpr Domain DEFAULT_DOMAIN{0.0, 6.283185307179586};
+
+  // Names defined in `parameters` (if any) compile as parameters of the expression.
+  explicit CompiledExpression(std::string_view source,
+      Kind kind = Kind::Explicit,
+      std::shared_ptr<const Parameters> parameters = nullptr);
+  // Parametric or polar curve over `domain`: `source` is x(t) or r(theta), `y_source` is y(t)
+  // (unused for polar curves).
+  CompiledExpression(std::string_view source,
+      std::string_view y_source,
+      Kind kind,
+      Domain domain,
+      std::shared_ptr<const Parameters> parameters = nullptr);
+  ~CompiledExpression();
+
+  CompiledExpression(const CompiledExpression&) = delete;
+  CompiledExpression(CompiledExpression&&) = delete;
+  CompiledExpression& operator=(CompiledExpression other) = delete;
+  CompiledExpression& operator=(CompiledExpression&& other) = delete;
+
+  [[nodiscard]] bool is_valid() const;
+  [[nodiscard]] const std::string& source() const;
+  [[nodiscard]] const std::string& error() const;
+  [[nodiscard]] bool is_batched() const;
+  // Bytecode of the first expression, if it was lowered (see is_batched()).
+  [[nodiscard]] const BatchExpression& batch() const;
+  [[nodiscard]] Kind kind() const;
+  [[nodiscard]] bool is_curve() const;  // parametric or polar
+  [[nodiscard]] Domain domain() const;
+  // Ids of the parameters the expression reads (ascending), and the sum of their revisions: it
+  // changes whenever one of them does, and only then.
+  [[nodiscard]] const std::vector<std::size_t>& parameters() const;
+  [[nodiscard]] std::uint64_t parameter_revision() const;
+
+  // Binds `x` and evaluates the expression on the calling thread's slot. Returns NaN if
+  // compilation failed.
+  [[nodiscard]] double evaluate(double x);
+  // Evaluates `count` points at once, through the bytecode when available.
+  void evaluate(const double* x, double* out, std::size_t count);
+
+  // Two-variable counterparts for implicit and region expressions.
+  [[nodiscard]] double evaluate(double x, double y);
+  void evaluate(const double* x, const double* y, double* out, std::size_t count);
+
+  // Bounds of the expression over `x` (and `y`), by interval arithmetic on the bytecode. Without
+  // bytecode they are Interval::whole(), which proves nothing.
+  [[nodiscard]] Interval bounds(const Interval& x) const;
+  [[nodiscard]] Interval bounds(const Interval& x, const Interval& y) const;
+
+  // Points of parametric and polar curves at `count` parameter values.
+  void evaluate_curve(const double* t, double* x, double* y, std::size_t count);
+
+ private:
+  struct Instance;
+
+  Instance& instance();
+  [[nodiscard]] bool matches_exprtk(Instance& instance) const;
+  // One-variable evaluation of the first (or, for parametric curves, the second) expression.
+  void evaluate_component(bool second, const double* x, double* out, std::size_t count);
+
+  std::string m_source;
+  std::string m_y_source;
+  Kind m_kind;
+  Domain m_domain{DEFAULT_DOMAIN};
+  std::shared_ptr<const Parameters> m_parameters;
+  std::vector<std::size_t> m_parameter_ids;
+  std::string m_error;
+  bool m_valid{false};
+  BatchExpression m_batch;
+  BatchExpression m_y_batch;
+  std::vector<std::unique_ptr<Instance>> m_instances;
+};
+
+}  // namespace App::Core
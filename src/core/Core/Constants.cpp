@@ -0,0 +1,40 @@
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <string_view>
+
+namespace App::Core {
+
+namespace {
+
+constexpr std::array<Constants::Constant, 10> CONSTANTS{{
+    {"pi", std::numbers::pi},
+    {"π", std::numbers::pi},
+    {"e", std::numbers::e},
+    {"phi", std::numbers::phi},
+    {"ϕ", std::numbers::phi},
+    {"φ", std::numbers::phi},
+    {"gamma", std::numbers::egamma},
+    {"γ", std::numbers::egamma},
+    {"epsilon", 0.0000000001},
+    {"inf", HUGE_VAL},
+}};
+
+}  // namespace
+
+std::span<const Constants::Constant> Constants::all() {
+  return CONSTANTS;
+}
+
+const Constants::Constant* Constants::find(std::string_view name) {
+  const auto* constant{std::find_if(CONSTANTS.begin(),
+      CONSTANTS.end(),
+      [name](const Constant& other) { return other.name == name; })};
+  return constant == CONSTANTS.end() ? nullptr : constant;
+}
+
+}  // namespace App::Core
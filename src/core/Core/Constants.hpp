@@ -0,0 +1,26 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+namespace App::Core {
+
+// The named constants every expression can use, shared by both backends: exprtk's own
+// (pi, epsilon, inf) plus e, phi and gamma, with their Unicode spellings.
+//
+// The table is immutable and built at compile time. exprtk expressions pull in only the
+// constants they actually mention (see CompiledExpression), instead of every expression
+// registering all of them into its own symbol table.
+class Constants {
+ public:
+  struct Constant {
+    std::string_view name;
+    double value;
+  };
+
+  [[nodiscard]] static std::span<const Constant> all();
+  // The constant called `name`, or nullptr.
+  [[nodiscard]] static const Constant* find(std::string_view name);
+};
+
+}  // namespace App::Core
@@ -0,0 +1,537 @@
+#include "CurveAnalysis.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace App::Core {
+
+namespace {
+
+std::atomic<void (*)()> g_publish_callback{nullptr};
+
+constexpr int MAX_ITERATIONS{100};
+constexpr double EPSILON{std::numeric_limits<double>::epsilon()};
+// Refined points are located to this fraction of their bracket (a sample step, about a pixel)
+// on top of the relative precision.
+constexpr double BRACKET_TOLERANCE{1e-12};
+
+constexpr float MARKER_RADIUS{4.5F};
+constexpr ImU32 MARKER_OUTLINE{IM_COL32(40, 40, 40, 255)};
+constexpr ImU32 MARKER_FILL{IM_COL32(255, 255, 255, 255)};
+
+bool is_finite(const Sample& sample) {
+  return std::isfinite(sample.y);
+}
+
+// Linear interpolation of `samples` at `x`, NaN outside them or next to a gap. `cursor` is
+// the first sample at or after the previous `x` and only moves forward, so walking increasing
+// x over the whole buffer is linear.
+double interpolate(std::span<const Sample> samples, std::size_t& cursor, double x) {
+  while (cursor < samples.size() && samples[cursor].x < x) {
+    ++cursor;
+  }
+  if (cursor == samples.size()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  const Sample& b{samples[cursor]};
+  if (b.x == x) {
+    return b.y;
+  }
+  if (cursor == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  const Sample& a{samples[cursor - 1]};
+  return a.y + (b.y - a.y) * ((x - a.x) / (b.x - a.x));
+}
+
+ImVec2 to_screen(const PlotPipeline::Viewport& viewport, const ImVec2& center, double x, double y) {
+  const double center_x{0.5 * (viewport.xmin + viewport.xmax)};
+  const double center_y{0.5 * (viewport.ymin + viewport.ymax)};
+  return {center.x + static_cast<float>((x - center_x) * viewport.pixels_per_unit),
+      center.y + static_cast<float>((center_y - y) * viewport.pixels_per_unit)};
+}
+
+bool is_inside(const PlotPipeline::Viewport& viewport, const CurveAnalysis::Marker& marker) {
+  return marker.x >= viewport.xmin && marker.x <= viewport.xmax && marker.y >= viewport.ymin &&
+         marker.y <= viewport.ymax;
+}
+
+}  // namespace
+
+CurveAnalysis::CurveAnalysis() : m_state(std::make_shared<State>()) {
+  m_state->markers = std::make_shared<const std::vector<Marker>>();
+}
+
+bool CurveAnalysis::update(const ExpressionList& functions, std::span<const std::size_t> rows) {
+  APP_PROFILE_FUNCTION();
+
+  std::vector<Input> inputs;
+  std::vector<Key> keys;
+  for (const std::size_t i : rows) {
+    const auto& compiled{functions.compiled[i]};
+    if (compiled->kind() != CompiledExpression::Kind::Explicit) {
+      continue;
+    }
+    const int id{functions.rows[i].id};
+    if (functions.curve[i].is_pending()) {
+      // Keeps the markers of its last analysed curve until the new one is sampled.
+      const auto previous{std::find_if(m_requested.begin(),
+          m_requested.end(),
+          [id](const Key& key) { return key.id == id; })};
+      if (previous != m_requested.end()) {
+        keys.push_back(*previous);
+        inputs.push_back({*previous, nullptr});
+      }
+      continue;
+    }
+    auto curve{functions.curve[i].latest()};
+    keys.push_back({id, compiled, curve->generation});
+    inputs.push_back({keys.back(), std::move(curve)});
+  }
+
+  if (keys == m_requested) {
+    return m_state->busy;
+  }
+  if (m_state->busy.exchange(true)) {
+    return true;
+  }
+  m_requested = std::move(keys);
+
+  ThreadPool::get().submit(
+      [state = m_state, inputs = std::move(inputs)] { run(state, inputs); });
+  return true;
+}
+
+void CurveAnalysis::run(const std::shared_ptr<State>& state, const std::vector<Input>& inputs) {
+  APP_PROFILE_FUNCTION();
+
+  // Results still valid for their curves are kept, the rest is analysed below. A row that is
+  // still being sampled and was never analysed has nothing to show.
+  std::vector<RowResult> rows;
+  std::vector<const Input*> row_inputs;
+  std::vector<std::size_t> row_work;
+  for (const auto& input : inputs) {
+    const auto previous{std::find_if(state->rows.begin(),
+        state->rows.end(),
+        [&](const RowResult& result) { return result.key == input.key; })};
+    if (previous != state->rows.end()) {
+      rows.push_back(std::move(*previous));
+    } else if (input.curve != nullptr) {
+      row_work.push_back(rows.size());
+      rows.push_back({input.key, {}});
+    } else {
+      continue;
+    }
+    row_inputs.push_back(&input);
+  }
+
+  std::vector<PairResult> pairs;
+  std::vector<std::pair<const Input*, const Input*>> pair_inputs;
+  std::vector<std::size_t> pair_work;
+  for (std::size_t a = 0; a < row_inputs.size(); ++a) {
+    for (std::size_t b = a + 1; b < row_inputs.size(); ++b) {
+      const Key& key_a{row_inputs[a]->key};
+      const Key& key_b{row_inputs[b]->key};
+      const auto previous{std::find_if(state->pairs.begin(),
+          state->pairs.end(),
+          [&](const PairResult& result) { return result.a == key_a && result.b == key_b; })};
+      if (previous != state->pairs.end()) {
+        pairs.push_back(std::move(*previous));
+      } else if (row_inputs[a]->curve != nullptr && row_inputs[b]->curve != nullptr) {
+        pair_work.push_back(pairs.size());
+        pairs.push_back({key_a, key_b, {}});
+      } else {
+        continue;
+      }
+      pair_inputs.emplace_back(row_inputs[a], row_inputs[b]);
+    }
+  }
+
+  // Every bracket's refinement evaluates the expression, so rows and pairs spread over the
+  // workers (each on its own slot of the expressions).
+  ThreadPool::get().parallel_for(row_work.size() + pair_work.size(), [&](std::size_t work) {
+    if (work < row_work.size()) {
+      const std::size_t k{row_work[work]};
+      const Input& input{*row_inputs[k]};
+      const Function f{[&expression = *input.key.expression](double x) {
+        return expression.evaluate(x);
+      }};
+      find_roots(f, input.curve->samples, rows[k].markers);
+      find_extrema(f, input.curve->samples, rows[k].markers);
+      return;
+    }
+    const std::size_t k{pair_work[work - row_work.size()]};
+    const auto [a, b]{pair_inputs[k]};
+    const Function f{[&expression = *a->key.expression](double x) {
+      return expression.evaluate(x);
+    }};
+    const Function g{[&expression = *b->key.expression](double x) {
+      return expression.evaluate(x);
+    }};
+    find_intersections(f, a->curve->samples, g, b->curve->samples, pairs[k].markers);
+  });
+
+  auto markers{std::make_shared<std::vector<Marker>>()};
+  for (const auto& row : rows) {
+    markers->insert(markers->end(), row.markers.begin(), row.markers.end());
+  }
+  for (const auto& pair : pairs) {
+    markers->insert(markers->end(), pair.markers.begin(), pair.markers.end());
+  }
+  state->rows = std::move(rows);
+  state->pairs = std::move(pairs);
+
+  {
+    const std::lock_guard lock(state->mutex);
+    state->markers = std::move(markers);
+  }
+
+  state->busy = false;
+
+  if (const auto callback{g_publish_callback.load(std::memory_order_acquire)}) {
+    callback();
+  }
+}
+
+std::shared_ptr<const std::vector<CurveAnalysis::Marker>> CurveAnalysis::markers() const {
+  const std::lock_guard lock(m_state->mutex);
+  return m_state->markers;
+}
+
+void CurveAnalysis::draw(ImDrawList* draw_list,
+    const PlotPipeline::Viewport& viewport,
+    const ImVec2& center) const {
+  APP_PROFILE_FUNCTION();
+
+  // Filled for roots and intersections, hollow for extrema.
+  for (const auto& marker : *markers()) {
+    if (!is_inside(viewport, marker)) {
+      continue;
+    }
+    const ImVec2 position{to_screen(viewport, center, marker.x, marker.y)};
+    if (marker.kind == Kind::Root || marker.kind == Kind::Intersection) {
+      draw_list->AddCircleFilled(position, MARKER_RADIUS, MARKER_FILL);
+    }
+    draw_list->AddCircle(position, MARKER_RADIUS, MARKER_OUTLINE, 0, 1.5F);
+  }
+}
+
+std::optional<CurveAnalysis::Marker> CurveAnalysis::hit(const PlotPipeline::Viewport& viewport,
+    const ImVec2& center,
+    const ImVec2& position,
+    float radius) const {
+  std::optional<Marker> nearest;
+  float nearest_distance{radius * radius};
+  for (const auto& marker : *markers()) {
+    if (!is_inside(viewport, marker)) {
+      continue;
+    }
+    const ImVec2 screen{to_screen(viewport, center, marker.x, marker.y)};
+    const float dx{screen.x - position.x};
+    const float dy{screen.y - position.y};
+    if (dx * dx + dy * dy <= nearest_distance) {
+      nearest_distance = dx * dx + dy * dy;
+      nearest = marker;
+    }
+  }
+  return nearest;
+}
+
+void CurveAnalysis::find_roots(
+    const Function& f, std::span<const Sample> samples, std::vector<Marker>& out) {
+  std::size_t found{0};
+  for (std::size_t i = 0; i < samples.size() && found < MAX_MARKERS_PER_CURVE; ++i) {
+    const Sample& b{samples[i]};
+    if (b.y == 0.0) {
+      out.push_back({b.x, 0.0, Kind::Root});
+      ++found;
+      continue;
+    }
+    if (i == 0) {
+      continue;
+    }
+    const Sample& a{samples[i - 1]};
+    if (!is_finite(a) || !is_finite(b) || a.y == 0.0 || (a.y > 0.0) == (b.y > 0.0)) {
+      continue;
+    }
+    const double x{refine_root(f, a.x, b.x, a.y, b.y)};
+    // A sign change across a pole (tan(x)) converges onto the pole, where |f| grows instead.
+    if (std::abs(f(x)) <= std::min(std::abs(a.y), std::abs(b.y))) {
+      out.push_back({x, 0.0, Kind::Root});
+      ++found;
+    }
+  }
+}
+
+void CurveAnalysis::find_extrema(
+    const Function& f, std::span<const Sample> samples, std::vector<Marker>& out) {
+  std::size_t found{0};
+  // Sign of the last rising or falling step (0 until there is one) and where it starts. Flat
+  // steps are skipped, so a plateau at the turn ends up inside the bracket.
+  int slope{0};
+  std::size_t left{0};
+  for (std::size_t i = 1; i < samples.size() && found < MAX_MARKERS_PER_CURVE; ++i) {
+    const Sample& a{samples[i - 1]};
+    const Sample& b{samples[i]};
+    if (!is_finite(a) || !is_finite(b)) {
+      slope = 0;
+      continue;
+    }
+    if (b.y == a.y) {
+      continue;
+    }
+    const int sign{b.y > a.y ? 1 : -1};
+    if (slope != 0 && sign != slope) {
+      const bool minimum{slope < 0};
+      const Function objective{[&f, minimum](double x) { return minimum ? f(x) : -f(x); }};
+      const double x{refine_minimum(objective, samples[left].x, b.x)};
+      const double y{f(x)};
+      // Brackets around a pole run off toward it instead of settling next to the turn.
+      const double turn{a.y};
+      const double spread{std::max(std::abs(samples[left].y - turn), std::abs(b.y - turn))};
+      if (std::isfinite(y) && std::abs(y - turn) <= spread) {
+        out.push_back({x, y, minimum ? Kind::Minimum : Kind::Maximum});
+        ++found;
+      }
+    }
+    slope = sign;
+    left = i - 1;
+  }
+}
+
+void CurveAnalysis::find_intersections(const Function& f,
+    std::span<const Sample> f_samples,
+    const Function& g,
+    std::span<const Sample> g_samples,
+    std::vector<Marker>& out) {
+  if (f_samples.empty() || g_samples.empty()) {
+    return;
+  }
+  const Function difference{[&f, &g](double x) { return f(x) - g(x); }};
+
+  // The difference of the two sampled lines at the samples of both, in increasing x over the
+  // range they share.
+  const double begin{std::max(f_samples.front().x, g_samples.front().x)};
+  const double end{std::min(f_samples.back().x, g_samples.back().x)};
+  std::size_t i{0};
+  std::size_t j{0};
+  std::size_t f_cursor{0};
+  std::size_t g_cursor{0};
+  double previous_x{std::numeric_limits<double>::quiet_NaN()};
+  double previous_difference{std::numeric_limits<double>::quiet_NaN()};
+  std::size_t found{0};
+  while ((i < f_samples.size() || j < g_samples.size()) && found < MAX_MARKERS_PER_CURVE) {
+    const bool from_f{
+        j == g_samples.size() || (i < f_samples.size() && f_samples[i].x <= g_samples[j].x)};
+    const double x{from_f ? f_samples[i++].x : g_samples[j++].x};
+    if (x < begin || x > end || x == previous_x) {
+      continue;
+    }
+    const double d{interpolate(f_samples, f_cursor, x) - interpolate(g_samples, g_cursor, x)};
+    const double a{previous_x};
+    const double d_a{previous_difference};
+    previous_x = x;
+    previous_difference = d;
+    const bool crosses{(d_a < 0.0 && d >= 0.0) || (d_a > 0.0 && d <= 0.0)};
+    if (!std::isfinite(d) || !std::isfinite(d_a) || !crosses) {
+      continue;
+    }
+
+    // The sampled lines only approximate the curves, so the bracket is checked on the curves.
+    const double h_a{difference(a)};
+    const double h_b{difference(x)};
+    if (!std::isfinite(h_a) || !std::isfinite(h_b) || (h_a > 0.0 && h_b > 0.0) ||
+        (h_a < 0.0 && h_b < 0.0)) {
+      continue;
+    }
+    const double root{refine_root(difference, a, x, h_a, h_b)};
+    const double y{f(root)};
+    if (std::isfinite(y) &&
+        std::abs(difference(root)) <= std::min(std::abs(h_a), std::abs(h_b))) {
+      out.push_back({root, y, Kind::Intersection});
+      ++found;
+    }
+  }
+}
+
+double CurveAnalysis::refine_root(const Function& f, double a, double b, double fa, double fb) {
+  if (fa == 0.0) {
+    return a;
+  }
+  if (fb == 0.0) {
+    return b;
+  }
+
+  // b is the best estimate, a the previous one and c the other end of the bracket [b, c].
+  const double bracket_tolerance{BRACKET_TOLERANCE * std::abs(b - a)};
+  double c{a};
+  double fc{fa};
+  double step{b - a};
+  double previous_step{step};
+  for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+    if ((fb > 0.0) == (fc > 0.0)) {
+      c = a;
+      fc = fa;
+      step = b - a;
+      previous_step = step;
+    }
+    if (std::abs(fc) < std::abs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+
+    const double tolerance{2.0 * EPSILON * std::abs(b) + 0.5 * bracket_tolerance};
+    const double half{0.5 * (c - b)};
+    if (std::abs(half) <= tolerance || fb == 0.0) {
+      return b;
+    }
+
+    if (std::abs(previous_step) >= tolerance && std::abs(fa) > std::abs(fb)) {
+      // Inverse quadratic interpolation, or the secant step while a and c coincide; taken only
+      // if it stays well inside the bracket and converges faster than bisection.
+      const double s{fb / fa};
+      double p{0.0};
+      double q{0.0};
+      if (a == c) {
+        p = 2.0 * half * s;
+        q = 1.0 - s;
+      } else {
+        const double r{fb / fc};
+        const double t{fa / fc};
+        p = s * (2.0 * half * t * (t - r) - (b - a) * (r - 1.0));
+        q = (t - 1.0) * (r - 1.0) * (s - 1.0);
+      }
+      if (p > 0.0) {
+        q = -q;
+      } else {
+        p = -p;
+      }
+      if (2.0 * p <
+          std::min(3.0 * half * q - std::abs(tolerance * q), std::abs(previous_step * q))) {
+        previous_step = step;
+        step = p / q;
+      } else {
+        step = half;
+        previous_step = half;
+      }
+    } else {
+      step = half;
+      previous_step = half;
+    }
+
+    a = b;
+    fa = fb;
+    b += std::abs(step) > tolerance ? step : std::copysign(tolerance, half);
+    fb = f(b);
+  }
+  return b;
+}
+
+double CurveAnalysis::refine_minimum(const Function& f, double a, double b) {
+  // 2 - golden ratio.
+  constexpr double GOLDEN_SECTION{0.3819660112501051};
+  // Near a minimum f is flat to second order, so x is only determined to about sqrt(epsilon).
+  const double relative_tolerance{std::sqrt(EPSILON)};
+  const double bracket_tolerance{BRACKET_TOLERANCE * std::abs(b - a)};
+
+  // x is the best point so far, w the second best and v the previous w.
+  double x{a + GOLDEN_SECTION * (b - a)};
+  double w{x};
+  double v{x};
+  double fx{f(x)};
+  double fw{fx};
+  double fv{fx};
+  double step{0.0};
+  double previous_step{0.0};
+  for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+    const double middle{0.5 * (a + b)};
+    const double tolerance{relative_tolerance * std::abs(x) + bracket_tolerance};
+    if (std::abs(x - middle) <= 2.0 * tolerance - 0.5 * (b - a)) {
+      return x;
+    }
+
+    bool golden{true};
+    if (std::abs(previous_step) > tolerance) {
+      // Vertex of the parabola through x, w and v, if it falls inside the bracket and the
+      // steps keep shrinking.
+      const double r{(x - w) * (fx - fv)};
+      double q{(x - v) * (fx - fw)};
+      double p{(x - v) * q - (x - w) * r};
+      q = 2.0 * (q - r);
+      if (q > 0.0) {
+        p = -p;
+      } else {
+        q = -q;
+      }
+      if (std::abs(p) < std::abs(0.5 * q * previous_step) && p > q * (a - x) && p < q * (b - x)) {
+        previous_step = step;
+        step = p / q;
+        const double u{x + step};
+        if (u - a < 2.0 * tolerance || b - u < 2.0 * tolerance) {
+          step = std::copysign(tolerance, middle - x);
+        }
+        golden = false;
+      }
+    }
+    if (golden) {
+      previous_step = (x >= middle ? a : b) - x;
+      step = GOLDEN_SECTION * previous_step;
+    }
+
+    const double u{std::abs(step) >= tolerance ? x + step : x + std::copysign(tolerance, step)};
+    const double fu{f(u)};
+    if (fu <= fx) {
+      if (u >= x) {
+        a = x;
+      } else {
+        b = x;
+      }
+      v = w;
+      fv = fw;
+      w = x;
+      fw = fx;
+      x = u;
+      fx = fu;
+    } else {
+      if (u < x) {
+        a = u;
+      } else {
+        b = u;
+      }
+      if (fu <= fw || w == x) {
+        v = w;
+        fv = fw;
+        w = u;
+        fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+  return x;
+}
+
+void CurveAnalysis::set_publish_callback(void (*callback)()) {
+  g_publish_callback.store(callback, std::memory_order_release);
+}
+
+}  // namespace App::Core
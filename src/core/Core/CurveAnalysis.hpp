@@ -0,0 +1,135 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/CompiledExpression.hpp"
+#include "Core/PlotPipeline.hpp"
+#include "Core/SampleCache.hpp"
+#include "Core/expression.hpp"
+
+namespace App::Core {
+
+// Roots, extrema and intersections of the plotted explicit curves, marked on the canvas.
+//
+// Brackets come from the sample buffers the AsyncCurves already hold: a sign change between
+// neighbouring samples brackets a root, a change in the sign of the slope an extremum and a
+// sign change of the difference of two curves an intersection. Each bracket is then refined
+// with Brent's method on the expression itself, on the worker threads. Touching roots (no
+// sign change, like x^2 at 0) show up as extrema.
+//
+// Results are kept per row and per pair of rows together with the curve they were found on,
+// so an update only analyses the rows whose curve changed (an edit, a parameter or a resample
+// for a new view range) and the pairs they are part of.
+class CurveAnalysis {
+ public:
+  enum class Kind : std::uint8_t { Root, Minimum, Maximum, Intersection };
+
+  struct Marker {
+    double x;
+    double y;
+    Kind kind;
+  };
+
+  using Function = std::function<double(double)>;
+
+  // Rows with more brackets than this (e.g. sin(1/x) near 0) keep only the first ones.
+  static constexpr std::size_t MAX_MARKERS_PER_CURVE{256};
+
+  CurveAnalysis();
+
+  // Starts a background analysis of `rows` (of `functions`; only explicit ones are analysed)
+  // if their curves changed since the last one and no analysis is running. Rows still being
+  // sampled keep their previous markers. Returns true while the markers do not match the
+  // latest curves yet.
+  bool update(const ExpressionList& functions, std::span<const std::size_t> rows);
+
+  // Markers of the last finished analysis, world space. Never null.
+  [[nodiscard]] std::shared_ptr<const std::vector<Marker>> markers() const;
+
+  // Draws the markers inside `viewport`, its center at `center` (screen space).
+  void draw(ImDrawList* draw_list,
+      const PlotPipeline::Viewport& viewport,
+      const ImVec2& center) const;
+  // The marker drawn closest to `position`, if one is within `radius` pixels.
+  [[nodiscard]] std::optional<Marker> hit(const PlotPipeline::Viewport& viewport,
+      const ImVec2& center,
+      const ImVec2& position,
+      float radius) const;
+
+  // The stages, for samples of `f` in increasing x. They append to `out`, at most
+  // MAX_MARKERS_PER_CURVE markers per call.
+  static void find_roots(
+      const Function& f, std::span<const Sample> samples, std::vector<Marker>& out);
+  static void find_extrema(
+      const Function& f, std::span<const Sample> samples, std::vector<Marker>& out);
+  static void find_intersections(const Function& f,
+      std::span<const Sample> f_samples,
+      const Function& g,
+      std::span<const Sample> g_samples,
+      std::vector<Marker>& out);
+
+  // Brent's method: the root of `f` in [a, b], where `fa` = f(a) and `fb` = f(b) have opposite
+  // signs (or one is zero).
+  static double refine_root(const Function& f, double a, double b, double fa, double fb);
+  // Brent's method: a local minimum of `f` in [a, b].
+  static double refine_minimum(const Function& f, double a, double b);
+
+  // Called on the worker thread after every finished analysis, e.g. to wake an idle UI loop.
+  // Set it before the first update.
+  static void set_publish_callback(void (*callback)());
+
+ private:
+  // What an analysed row was: its markers are valid as long as all three match.
+  struct Key {
+    int id;
+    std::shared_ptr<CompiledExpression> expression;
+    std::uint64_t generation;
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  struct Input {
+    Key key;
+    std::shared_ptr<const AsyncCurve::Curve> curve;
+  };
+
+  struct RowResult {
+    Key key;
+    std::vector<Marker> markers;
+  };
+
+  struct PairResult {
+    Key a;
+    Key b;
+    std::vector<Marker> markers;
+  };
+
+  struct State {
+    std::atomic<bool> busy{false};
+
+    // Only touched by the task that currently owns `busy`.
+    std::vector<RowResult> rows;
+    std::vector<PairResult> pairs;
+
+    mutable std::mutex mutex;
+    std::shared_ptr<const std::vector<Marker>> markers;
+  };
+
+  static void run(const std::shared_ptr<State>& state, const std::vector<Input>& inputs);
+
+  std::shared_ptr<State> m_state;
+  std::vector<Key> m_requested;
+};
+
+}  // namespace App::Core
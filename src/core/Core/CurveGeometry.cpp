@@ -0,0 +1,125 @@
+#include "CurveGeometry.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Debug/PerfStats.hpp"
+#include "Core/Polyline.hpp"
+
+namespace App::Core {
+
+bool CurveGeometry::update(const AsyncCurve::Curve& curve,
+    const AsyncCurve::View& view,
+    ImU32 color,
+    float thickness,
+    ImDrawList& scratch,
+    std::pmr::memory_resource* arena) {
+  if (m_built && curve.generation == m_generation && view == m_view && color == m_color &&
+      thickness == m_thickness) {
+    return false;
+  }
+
+  APP_PROFILE_SCOPE("CurveGeometry::update");
+  const Debug::StageTimer timer{Debug::PerfStats::Stage::Tessellate};
+
+  m_built = true;
+  m_generation = curve.generation;
+  m_view = view;
+  m_color = color;
+  m_thickness = thickness;
+
+  m_geometry.clear();
+
+  // Relative to the view center and clamped in double precision on both axes, so huge values
+  // (exp(x), poles, parametric x unbounded by the sampled range) neither overflow the float nor
+  // lose the direction of the segment leaving the view.
+  const double pixels_per_unit{view.pixels_per_unit};
+  const double center_x{0.5 * (view.xmin + view.xmax)};
+  const double center_y{0.5 * (view.ymin + view.ymax)};
+  const auto to_screen{[=](const Sample& sample) {
+    return Polyline::narrow((sample.x - center_x) * pixels_per_unit,
+        (center_y - sample.y) * pixels_per_unit,
+        MAX_SCREEN_COORDINATE);
+  }};
+
+  // Tessellate with ImGui's own primitives into a scratch list that shares the window's
+  // settings (anti-aliasing, texture lines), then keep the result.
+  const auto begin_chunk{[&scratch] {
+    const ImDrawListFlags flags{scratch.Flags};
+    scratch._ResetForNewFrame();
+    scratch.Flags = flags;
+    scratch.PushClipRectFullScreen();
+  }};
+  const auto end_chunk{[this, &scratch] { m_geometry.capture(scratch); }};
+
+  // Implicit plots: translucent regions under their contour segments.
+  if (!curve.regions.empty() || !curve.segments.empty()) {
+    const ImU32 fill{(color & ~IM_COL32_A_MASK) | (REGION_ALPHA << IM_COL32_A_SHIFT)};
+    begin_chunk();
+    for (const auto& box : curve.regions) {
+      if (scratch.VtxBuffer.Size >= MAX_VERTICES_PER_CHUNK) {
+        end_chunk();
+        begin_chunk();
+      }
+      scratch.AddRectFilled(to_screen({box.x0, box.y1}), to_screen({box.x1, box.y0}), fill);
+    }
+    for (const auto& segment : curve.segments) {
+      if (scratch.VtxBuffer.Size >= MAX_VERTICES_PER_CHUNK) {
+        end_chunk();
+        begin_chunk();
+      }
+      scratch.AddLine(to_screen(segment.a), to_screen(segment.b), color, thickness);
+    }
+    end_chunk();
+  }
+
+  // Screen positions relative to the view center.
+  std::pmr::vector<ImVec2> points{arena};
+  points.reserve(curve.samples.size());
+  for (const auto& sample : curve.samples) {
+    points.push_back(to_screen(sample));
+  }
+
+  // Only the part inside [ymin, ymax] is tessellated; breaks at gaps, edges and poles.
+  std::pmr::vector<ImVec2> clipped{arena};
+  clipped.reserve(points.size());
+  Polyline::clip(points,
+      static_cast<float>((center_y - view.ymax) * pixels_per_unit),
+      static_cast<float>((center_y - view.ymin) * pixels_per_unit),
+      clipped);
+  points.swap(clipped);
+
+  // Level of detail: drop points no one can see before they turn into triangles.
+  std::pmr::vector<ImVec2> simplified{arena};
+  simplified.reserve(points.size());
+  Polyline::simplify(points, Polyline::DEFAULT_TOLERANCE_PX, simplified, curve.ordered_by_x);
+  points.swap(simplified);
+
+  Polyline::for_each_run(points, [&](const ImVec2* run, std::size_t size) {
+    for (std::size_t begin = 0; begin + 1 < size; begin += MAX_POINTS_PER_CHUNK - 1) {
+      const std::size_t count{std::min(MAX_POINTS_PER_CHUNK, size - begin)};
+
+      begin_chunk();
+      scratch.AddPolyline(
+          run + begin, static_cast<int>(count), color, ImDrawFlags_None, thickness);
+      end_chunk();
+    }
+  });
+
+  return true;
+}
+
+void CurveGeometry::draw(ImDrawList* draw_list, const ImVec2& anchor) const {
+  m_geometry.draw(draw_list, anchor);
+}
+
+std::size_t CurveGeometry::vertex_count() const {
+  return m_geometry.vertex_count();
+}
+
+}  // namespace App::Core
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/RetainedGeometry.hpp"
+
+namespace App::Core {
+
+// Cached triangle geometry of one curve, kept on the CPU between frames.
+//
+// ImDrawList::AddPolyline turns every curve into thick-line triangles on the CPU. This class runs
+// that tessellation once per published curve, view, color and thickness, and stores the
+// vertices relative to the center of the (padded) view, which keeps them small enough for float
+// precision at any zoom and distance from the origin. Implicit curves (segments and filled
+// regions) are tessellated the same way. Drawing then only copies them into the window's draw
+// list (which ImGui rebuilds every frame) with the current pan offset applied, so a pan within
+// the padded view does not re-tessellate.
+// Curve points go through Polyline::clip and Polyline::simplify first, so only visible detail
+// is tessellated.
+class CurveGeometry {
+ public:
+  // Re-tessellates if the curve or any drawing parameter changed. Returns true if it did.
+  // `view` should be snapped (see AsyncCurve::padded_view) so that pans rarely change it; curve
+  // points are clipped to its band [ymin, ymax].
+  // `scratch` must share the target draw list's `_Data` and `Flags`; its buffers are reused
+  // from call to call. Temporary point buffers come from `arena`.
+  bool update(const AsyncCurve::Curve& curve,
+      const AsyncCurve::View& view,
+      ImU32 color,
+      float thickness,
+      ImDrawList& scratch,
+      std::pmr::memory_resource* arena);
+
+  // Appends the cached triangles, translated so that the center of the view they were built for
+  // lands on `anchor` (screen space).
+  void draw(ImDrawList* draw_list, const ImVec2& anchor) const;
+
+  [[nodiscard]] std::size_t vertex_count() const;
+
+  // Pieces are tessellated separately to stay within 16-bit indices.
+  static constexpr std::size_t MAX_POINTS_PER_CHUNK{8192};
+  // Far beyond any canvas, well within float precision for clipping.
+  static constexpr double MAX_SCREEN_COORDINATE{1.0e7};
+  // Opacity of implicit regions under their contour.
+  static constexpr ImU32 REGION_ALPHA{64};
+
+ private:
+  static constexpr int MAX_VERTICES_PER_CHUNK{60000};
+
+  std::uint64_t m_generation{0};
+  AsyncCurve::View m_view{0.0, 0.0, 0.0, 0.0, 0.0};
+  ImU32 m_color{0};
+  float m_thickness{0.0F};
+  bool m_built{false};
+
+  RetainedGeometry m_geometry;
+};
+
+}  // namespace App::Core
@@ -0,0 +1,291 @@
+#include "DataSeries.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <memory_resource>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+
+namespace App::Core {
+
+namespace {
+
+constexpr std::size_t MAX_FIELDS{2};
+
+bool is_separator(char character) {
+  return character == ',' || character == ';' || character == ' ' || character == '\t' ||
+         character == '\r';
+}
+
+}  // namespace
+
+DataSeries::Format DataSeries::format_for(const std::filesystem::path& path) {
+  const std::string extension{path.extension().string()};
+  if (extension == ".f32") {
+    return Format::Float32;
+  }
+  if (extension == ".f64" || extension == ".bin") {
+    return Format::Float64;
+  }
+  return Format::Text;
+}
+
+bool DataSeries::load(const std::filesystem::path& path) {
+  return load(path, format_for(path));
+}
+
+bool DataSeries::load(const std::filesystem::path& path, Format format) {
+  APP_PROFILE_FUNCTION();
+
+  m_path = path;
+  m_format = format;
+  m_points.clear();
+  m_levels.clear();
+  m_parsed = 0;
+  m_committed = 0;
+  m_file_size = 0;
+  m_rejected = 0;
+  m_committed_rejected = 0;
+
+  if (!read()) {
+    return false;
+  }
+  APP_INFO("Loaded {} points from {} ({} rejected)", m_points.size(), path.string(), m_rejected);
+  return true;
+}
+
+bool DataSeries::poll() {
+  if (m_path.empty()) {
+    return false;
+  }
+
+  // A file that is missing for now (being rotated) keeps its points until it comes back.
+  std::error_code error;
+  const auto size{static_cast<std::size_t>(std::filesystem::file_size(m_path, error))};
+  if (error || size == m_file_size) {
+    return false;
+  }
+
+  APP_PROFILE_FUNCTION();
+  if (size < m_parsed) {
+    load(m_path, m_format);
+    return true;
+  }
+  return read();
+}
+
+bool DataSeries::read() {
+  MappedFile file;
+  if (!file.open(m_path)) {
+    return false;
+  }
+  m_file_size = file.size();
+  if (m_file_size < m_parsed) {
+    // Truncated between the size check and the map; the next poll reloads it.
+    return false;
+  }
+
+  // The provisional last line is parsed again, now that more of it may have been written.
+  m_points.resize(m_committed);
+  m_rejected = m_committed_rejected;
+  const std::size_t first{m_committed};
+
+  const char* data{file.data() + m_parsed};
+  const std::size_t size{m_file_size - m_parsed};
+  switch (m_format) {
+    case Format::Text:
+      parse_text(data, size);
+      break;
+    case Format::Float32:
+      parse_records<float>(data, size);
+      break;
+    case Format::Float64:
+      parse_records<double>(data, size);
+      break;
+  }
+
+  extend_pyramid(first);
+  return true;
+}
+
+void DataSeries::parse_text(const char* data, std::size_t size) {
+  APP_PROFILE_FUNCTION();
+
+  const char* const end{data + size};
+  const char* line{data};
+  const char* committed{data};
+  while (line < end) {
+    const auto* newline{static_cast<const char*>(
+        std::memchr(line, '\n', static_cast<std::size_t>(end - line)))};
+    const char* line_end{newline != nullptr ? newline : end};
+
+    // Up to two numbers; a field that is not a number makes the line a header or comment.
+    std::array<double, MAX_FIELDS> fields{};
+    std::size_t count{0};
+    bool numeric{true};
+    const char* cursor{line};
+    while (count < MAX_FIELDS) {
+      while (cursor < line_end && is_separator(*cursor)) {
+        ++cursor;
+      }
+      if (cursor == line_end) {
+        break;
+      }
+      const auto [next, status]{std::from_chars(cursor, line_end, fields.at(count))};
+      if (status != std::errc{}) {
+        numeric = false;
+        break;
+      }
+      ++count;
+      cursor = next;
+    }
+
+    if (numeric && count == 1) {
+      // A single column is y over the row number (rejected rows keep their number).
+      append(static_cast<double>(m_points.size() + m_rejected), fields[0]);
+    } else if (numeric && count == MAX_FIELDS) {
+      append(fields[0], fields[1]);
+    }
+
+    if (newline == nullptr) {
+      // Unterminated: the writer may not be done with it, so it is not committed.
+      break;
+    }
+    line = newline + 1;
+    m_parsed += static_cast<std::size_t>(line - committed);
+    committed = line;
+    m_committed = m_points.size();
+    m_committed_rejected = m_rejected;
+  }
+}
+
+template <typename T>
+void DataSeries::parse_records(const char* data, std::size_t size) {
+  APP_PROFILE_FUNCTION();
+
+  // A partly written record at the end waits for the next poll.
+  constexpr std::size_t RECORD_SIZE{2 * sizeof(T)};
+  const std::size_t count{size / RECORD_SIZE};
+  m_points.reserve(m_points.size() + count);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::array<T, 2> record{};
+    std::memcpy(record.data(), data + i * RECORD_SIZE, RECORD_SIZE);
+    append(static_cast<double>(record[0]), static_cast<double>(record[1]));
+  }
+  m_parsed += count * RECORD_SIZE;
+  m_committed = m_points.size();
+  m_committed_rejected = m_rejected;
+}
+
+void DataSeries::append(double x, double y) {
+  if (!std::isfinite(x) || !std::isfinite(y) || (!m_points.empty() && x < m_points.back().x)) {
+    ++m_rejected;
+    return;
+  }
+  m_points.push_back({x, y});
+}
+
+void DataSeries::extend_pyramid(std::size_t first) {
+  APP_PROFILE_FUNCTION();
+
+  // Each level only redoes the blocks from the one containing the first new point.
+  std::size_t level{1};
+  for (;; ++level) {
+    const std::size_t below_size{level == 1 ? m_points.size() : m_levels[level - 2].size()};
+    if (below_size <= 1) {
+      break;
+    }
+    if (m_levels.size() < level) {
+      m_levels.emplace_back();
+    }
+
+    const auto below{[this, level](std::size_t i) {
+      return level == 1 ? Bucket{m_points[i], m_points[i]} : m_levels[level - 2][i];
+    }};
+    std::vector<Bucket>& buckets{m_levels[level - 1]};
+    first /= BRANCHING;
+    buckets.resize(std::min(first, buckets.size()));
+
+    for (std::size_t begin = buckets.size() * BRANCHING; begin < below_size; begin += BRANCHING) {
+      const std::size_t end{std::min(begin + BRANCHING, below_size)};
+      Bucket bucket{below(begin)};
+      for (std::size_t i = begin + 1; i < end; ++i) {
+        const Bucket next{below(i)};
+        if (next.low.y < bucket.low.y) {
+          bucket.low = next.low;
+        }
+        if (next.high.y > bucket.high.y) {
+          bucket.high = next.high;
+        }
+      }
+      buckets.push_back(bucket);
+    }
+  }
+  // Levels above a single block (left over from a longer series) are dropped.
+  m_levels.resize(level - 1);
+}
+
+void DataSeries::visible_points(double xmin,
+    double xmax,
+    double pixels_per_unit,
+    std::pmr::vector<Sample>& out) const {
+  APP_PROFILE_FUNCTION();
+
+  if (m_points.empty() || !(xmax > xmin)) {
+    return;
+  }
+
+  const auto by_x{[](const Sample& sample, double x) { return sample.x < x; }};
+  auto first{static_cast<std::size_t>(
+      std::lower_bound(m_points.begin(), m_points.end(), xmin, by_x) - m_points.begin())};
+  auto last{static_cast<std::size_t>(
+      std::upper_bound(m_points.begin(),
+          m_points.end(),
+          xmax,
+          [](double x, const Sample& sample) { return x < sample.x; }) -
+      m_points.begin())};
+  first = first > 0 ? first - 1 : 0;
+  last = std::min(last + 1, m_points.size());
+  if (first >= last) {
+    return;
+  }
+
+  // The coarsest level with at least one block per column: fewer than BRANCHING blocks per
+  // column, two points each.
+  const double columns{std::max((xmax - xmin) * pixels_per_unit, 1.0)};
+  std::size_t level{0};
+  std::size_t block{1};
+  while (level < m_levels.size() &&
+         static_cast<double>((last - first) / (block * BRANCHING)) >= columns) {
+    ++level;
+    block *= BRANCHING;
+  }
+
+  if (level == 0) {
+    out.insert(out.end(), m_points.begin() + static_cast<std::ptrdiff_t>(first),
+        m_points.begin() + static_cast<std::ptrdiff_t>(last));
+    return;
+  }
+
+  const std::vector<Bucket>& buckets{m_levels[level - 1]};
+  for (std::size_t i = first / block; i <= (last - 1) / block; ++i) {
+    const Bucket& bucket{buckets[i]};
+    const bool low_first{bucket.low.x <= bucket.high.x};
+    out.push_back(low_first ? bucket.low : bucket.high);
+    if (bucket.low.x != bucket.high.x || bucket.low.y != bucket.high.y) {
+      out.push_back(low_first ? bucket.high : bucket.low);
+    }
+  }
+}
+
+}  // namespace App::Core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+// Measured (x, y) data from a file, drawn next to the analytic curves.
+//
+// Files are memory-mapped and parsed once: text (CSV and friends: one "x,y" or "y" per line,
+// separated by commas, semicolons, tabs or spaces) or raw records of interleaved float or double
+// x and y in native byte order. Points must come in increasing x; others are dropped, as are
+// non-finite ones and lines that are not numbers (headers, comments).
+//
+// A min/max pyramid is built over the points as they are read: level k keeps the lowest and
+// highest point of every block of BRANCHING^k points. visible_points() picks the coarsest level
+// that still has a block per pixel column, so its output is O(pixels) at any zoom and keeps the
+// vertical extent of every column, however many points the file has.
+//
+// poll() picks up data appended since the last call (tail-following a logger's output); only
+// the new points and the pyramid blocks above them are processed.
+class DataSeries {
+ public:
+  enum class Format {
+    Text,
+    Float32,
+    Float64,
+  };
+
+  static constexpr std::size_t BRANCHING{4};
+
+  // .f32 is Float32, .f64 and .bin are Float64, anything else is text.
+  [[nodiscard]] static Format format_for(const std::filesystem::path& path);
+
+  // Replaces the series with the contents of `path`. Returns false (and logs why) if the file
+  // cannot be read; the series is then empty.
+  bool load(const std::filesystem::path& path);
+  bool load(const std::filesystem::path& path, Format format);
+
+  // Reads what was appended to the file since the last load or poll. A file that shrank was
+  // replaced and is loaded again. Returns true if the points changed.
+  bool poll();
+
+  // Appends the points of [xmin, xmax], plus one on either side so the line reaches the edges,
+  // at a resolution of `pixels_per_unit`: at most 2 * BRANCHING points per pixel column.
+  void visible_points(double xmin,
+      double xmax,
+      double pixels_per_unit,
+      std::pmr::vector<Sample>& out) const;
+
+  [[nodiscard]] std::size_t size() const {
+    return m_points.size();
+  }
+  [[nodiscard]] bool empty() const {
+    return m_points.empty();
+  }
+  // Points dropped so far (not finite, or x not increasing).
+  [[nodiscard]] std::size_t rejected() const {
+    return m_rejected;
+  }
+  [[nodiscard]] const std::filesystem::path& path() const {
+    return m_path;
+  }
+  [[nodiscard]] Format format() const {
+    return m_format;
+  }
+
+ private:
+  // Lowest and highest point of a block, each with its own x so the line visits them in order.
+  struct Bucket {
+    Sample low;
+    Sample high;
+  };
+
+  // Maps the file and parses it from m_parsed. Returns false if it cannot be read.
+  bool read();
+  void parse_text(const char* data, std::size_t size);
+  template <typename T>
+  void parse_records(const char* data, std::size_t size);
+  void append(double x, double y);
+  // Rebuilds the pyramid from point `first` on.
+  void extend_pyramid(std::size_t first);
+
+  std::filesystem::path m_path;
+  Format m_format{Format::Text};
+
+  std::vector<Sample> m_points;
+  // m_levels[k - 1] holds the blocks of level k (level 0 is m_points itself).
+  std::vector<std::vector<Bucket>> m_levels;
+
+  // Bytes and points of the complete lines or records read so far. A text file that does not
+  // end in a newline has its last line parsed provisionally, past m_committed, and parsed again
+  // by the next poll since the writer may still be in the middle of it.
+  std::size_t m_parsed{0};
+  std::size_t m_committed{0};
+  std::size_t m_file_size{0};
+  std::size_t m_rejected{0};
+  std::size_t m_committed_rejected{0};
+};
+
+}  // namespace App::Core
@@ -0,0 +1,39 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace App::Debug {
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+thread_local std::uint64_t t_allocations{0};
+
+}  // namespace
+
+void AllocationCounter::record() {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  ++t_allocations;
+}
+
+std::uint64_t AllocationCounter::total() {
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AllocationCounter::this_thread() {
+  return t_allocations;
+}
+
+void* AllocationCounter::imgui_alloc(std::size_t size, void* /*user_data*/) {
+  record();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void AllocationCounter::imgui_free(void* memory, void* /*user_data*/) {
+  std::free(memory);
+}
+
+}  // namespace App::Debug
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace App::Debug {
+
+// Counts heap allocations. The global operator new and delete (every form, aligned and nothrow
+// included) are replaced in AllocationHooks.cpp, which is not part of Core: only executables
+// that add the AllocationHooks object library count operator new, elsewhere the counts stay at
+// the ImGui allocations. Dear ImGui allocates through its own hooks, so pass
+// `imgui_alloc`/`imgui_free` to ImGui::SetAllocatorFunctions to include it.
+class AllocationCounter {
+ public:
+  // Counts one allocation by the calling thread.
+  static void record();
+  // Allocations since startup, all threads.
+  [[nodiscard]] static std::uint64_t total();
+  // Allocations since startup made by the calling thread.
+  [[nodiscard]] static std::uint64_t this_thread();
+
+  static void* imgui_alloc(std::size_t size, void* user_data);
+  static void imgui_free(void* memory, void* user_data);
+};
+
+}  // namespace App::Debug
@@ -0,0 +1,95 @@
+// Replacements of the global operator new and delete that count allocations (see
+// AllocationCounter). Built as the AllocationHooks object library rather than into Core, so
+// only the executables that want the counts replace the allocator of the whole program.
+//
+// Every form that does not forward to another by default is replaced: the plain and aligned
+// ones, throwing and nothrow. The array forms forward to these.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.hpp"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+void* allocate(std::size_t size) {
+  App::Debug::AllocationCounter::record();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+// Aligned blocks come from _aligned_malloc on Windows, which needs _aligned_free, and from
+// posix_memalign elsewhere (std::aligned_alloc would need the size rounded to the alignment).
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) {
+  App::Debug::AllocationCounter::record();
+  const std::size_t bytes{std::max(static_cast<std::size_t>(alignment), sizeof(void*))};
+#ifdef _WIN32
+  return _aligned_malloc(size == 0 ? 1 : size, bytes);
+#else
+  void* memory{nullptr};
+  return posix_memalign(&memory, bytes, size == 0 ? 1 : size) == 0 ? memory : nullptr;
+#endif
+}
+
+void free_aligned(void* memory) {
+#ifdef _WIN32
+  _aligned_free(memory);
+#else
+  std::free(memory);
+#endif
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (void* memory{allocate(size)}) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  if (void* memory{allocate_aligned(size, alignment)}) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(
+    std::size_t size, std::align_val_t alignment, const std::nothrow_t& /*tag*/) noexcept {
+  return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t& /*tag*/) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t /*alignment*/) noexcept {
+  free_aligned(memory);
+}
+
+void operator delete(void* memory, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+  free_aligned(memory);
+}
+
+void operator delete(
+    void* memory, std::align_val_t /*alignment*/, const std::nothrow_t& /*tag*/) noexcept {
+  free_aligned(memory);
+}
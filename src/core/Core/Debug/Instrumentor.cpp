@@ -0,0 +1,176 @@
+#include "Instrumentor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Core/Log.hpp"
+
+namespace App::Debug {
+
+void Instrumentor::begin_session(const std::string& name, const std::string& filepath) {
+  std::unique_lock lock(m_session_mutex);
+
+  if (m_current_session != nullptr) {
+    // If there is already a current session, then close it before beginning new one.
+    // Subsequent profiling output meant for the original session will end up in the
+    // newly opened session instead.  That's better than having badly formatted
+    // profiling output.
+    APP_ERROR("Instrumentor::begin_session('{0}') when session '{1}' already open.",
+        name,
+        m_current_session->name);
+    lock.unlock();
+    end_session();
+    lock.lock();
+  }
+
+  // Discard whatever was recorded after the previous session ended.
+  drain_buffers(false);
+
+  m_output_stream.open(filepath);
+  if (!m_output_stream.is_open()) {
+    APP_ERROR("Instrumentor could not open results file '{0}'.", filepath);
+    return;
+  }
+
+  m_current_session = std::make_unique<InstrumentationSession>(name);
+  m_output_stream << R"({"otherData": {},"traceEvents":[{})";
+  m_session_start_ns = now_ns();
+  m_dropped = 0;
+  {
+    const std::lock_guard flush_lock(m_flush_mutex);
+    m_stop_flusher = false;
+  }
+  m_active = true;
+  m_flusher = std::thread([this] { flush_loop(); });
+}
+
+void Instrumentor::end_session() {
+  {
+    const std::lock_guard lock(m_session_mutex);
+    if (m_current_session == nullptr) {
+      return;
+    }
+    m_active = false;
+  }
+  {
+    const std::lock_guard lock(m_flush_mutex);
+    m_stop_flusher = true;
+  }
+  m_flush_condition.notify_all();
+  if (m_flusher.joinable()) {
+    m_flusher.join();
+  }
+
+  const std::lock_guard lock(m_session_mutex);
+  internal_end_session();
+}
+
+std::uint32_t Instrumentor::intern(std::string_view name) {
+  const std::lock_guard lock(m_mutex);
+
+  std::string key{name};
+  if (const auto it{m_name_ids.find(key)}; it != m_name_ids.end()) {
+    return it->second;
+  }
+
+  // Escaped once here instead of for every event.
+  std::string escaped{key};
+  std::replace(escaped.begin(), escaped.end(), '"', '\'');
+  std::replace(escaped.begin(), escaped.end(), '\\', '/');
+
+  const auto id{static_cast<std::uint32_t>(m_names.size())};
+  m_names.push_back(std::move(escaped));
+  m_name_ids.emplace(std::move(key), id);
+  return id;
+}
+
+EventBuffer& Instrumentor::register_thread() {
+  const std::lock_guard lock(m_mutex);
+  const auto index{static_cast<std::uint32_t>(m_buffers.size())};
+  m_buffers.push_back(std::make_unique<EventBuffer>(index));
+  return *m_buffers.back();
+}
+
+// Wakes every FLUSH_INTERVAL, or earlier when a buffer reaches its high-water mark.
+void Instrumentor::flush_loop() {
+  std::unique_lock lock(m_flush_mutex);
+  while (!m_stop_flusher) {
+    m_flush_condition.wait_for(lock, FLUSH_INTERVAL, [this] {
+      return m_stop_flusher || m_flush_requested.load(std::memory_order_relaxed);
+    });
+    m_flush_requested.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    {
+      const std::lock_guard session_lock(m_session_mutex);
+      drain_buffers(true);
+    }
+    lock.lock();
+  }
+}
+
+void Instrumentor::drain_buffers(bool write) {
+  // Buffers are never removed and names are only appended, so only the new ones are copied.
+  {
+    const std::lock_guard lock(m_mutex);
+    for (std::size_t i = m_drained_buffers.size(); i < m_buffers.size(); ++i) {
+      m_drained_buffers.push_back(m_buffers[i].get());
+    }
+    m_trace_names.insert(m_trace_names.end(),
+        m_names.begin() + static_cast<std::ptrdiff_t>(m_trace_names.size()),
+        m_names.end());
+  }
+
+  std::array<char, 512> line{};
+  m_trace.clear();
+  for (EventBuffer* buffer : m_drained_buffers) {
+    buffer->drain([&](const ProfileEvent& event) {
+      if (!write || event.name_id >= m_trace_names.size()) {
+        return;
+      }
+      const int length{std::snprintf(line.data(),
+          line.size(),
+          R"(,{"cat":"function","dur":%.3f,"name":"%s","ph":"X","pid":0,"tid":%u,"ts":%.3f})",
+          static_cast<double>(event.duration_ns) / 1000.0,
+          m_trace_names[event.name_id].c_str(),
+          buffer->thread_index(),
+          static_cast<double>(event.start_ns - m_session_start_ns) / 1000.0)};
+      if (length > 0 && static_cast<std::size_t>(length) < line.size()) {
+        m_trace.append(line.data(), static_cast<std::size_t>(length));
+      }
+    });
+    m_dropped += buffer->take_dropped();
+  }
+  if (!m_trace.empty()) {
+    m_output_stream.write(m_trace.data(), static_cast<std::streamsize>(m_trace.size()));
+  }
+}
+
+// Note: you must already own lock on m_session_mutex before
+// calling internal_end_session()
+void Instrumentor::internal_end_session() {
+  if (m_current_session == nullptr) {
+    return;
+  }
+
+  drain_buffers(true);
+  m_output_stream << "]}";
+  m_output_stream.close();
+
+  if (m_dropped > 0) {
+    APP_WARN("Instrumentor dropped {} events in session '{}'; the flusher fell behind.",
+        m_dropped,
+        m_current_session->name);
+  }
+  m_current_session.reset();
+}
+
+}  // namespace App::Debug
@@ -1,25 +1,28 @@
 #pragma once
 
-#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
-#include <iomanip>
-#include <sstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <utility>
-
-#include "Core/Log.hpp"
+#include <vector>
 
 namespace App::Debug {
 
-using FloatingPointMicroseconds = std::chrono::duration<double, std::micro>;
-
-struct ProfileResult {
-  std::string name;
-  FloatingPointMicroseconds start;
-  std::chrono::microseconds elapsed_time;
-  std::thread::id thread_id;
+// One finished scope. Names are interned, so events are fixed-size and cheap to copy.
+struct ProfileEvent {
+  std::uint32_t name_id;
+  std::int64_t start_ns;  // steady_clock
+  std::int64_t duration_ns;
 };
 
 struct InstrumentationSession {
@@ -27,6 +30,61 @@ struct InstrumentationSession {
   explicit InstrumentationSession(std::string session_name) : name(std::move(session_name)) {}
 };
 
+// Single-producer/single-consumer ring of events: the owning thread appends, the flusher
+// drains. When the flusher falls behind, new events are dropped (and counted) rather than
+// blocking the instrumented thread.
+class EventBuffer {
+ public:
+  // A refinement pass on a worker records tens of thousands of scopes within one flush
+  // interval, so the ring holds 64K events (1.5 MiB per thread) and the producer wakes the
+  // flusher as soon as it is half full instead of waiting for the next tick.
+  static constexpr std::size_t CAPACITY{std::size_t{1} << 16};
+  static constexpr std::size_t HIGH_WATER{CAPACITY / 2};
+
+  explicit EventBuffer(std::uint32_t thread_index) : m_thread_index(thread_index) {}
+
+  // Returns true when this event brought the ring to HIGH_WATER.
+  bool push(const ProfileEvent& event) {
+    const std::uint64_t head{m_head.load(std::memory_order_relaxed)};
+    const std::uint64_t used{head - m_tail.load(std::memory_order_acquire)};
+    if (used >= CAPACITY) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_events[head % CAPACITY] = event;
+    m_head.store(head + 1, std::memory_order_release);
+    return used + 1 == HIGH_WATER;
+  }
+
+  template <typename Sink>
+  void drain(Sink&& sink) {
+    const std::uint64_t tail{m_tail.load(std::memory_order_relaxed)};
+    const std::uint64_t head{m_head.load(std::memory_order_acquire)};
+    for (std::uint64_t i = tail; i != head; ++i) {
+      sink(m_events[i % CAPACITY]);
+    }
+    m_tail.store(head, std::memory_order_release);
+  }
+
+  [[nodiscard]] std::uint32_t thread_index() const {
+    return m_thread_index;
+  }
+
+  std::uint64_t take_dropped() {
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  std::array<ProfileEvent, CAPACITY> m_events{};
+  alignas(64) std::atomic<std::uint64_t> m_head{0};
+  alignas(64) std::atomic<std::uint64_t> m_tail{0};
+  std::atomic<std::uint64_t> m_dropped{0};
+  std::uint32_t m_thread_index;
+};
+
+// Collects scope timings into per-thread ring buffers and writes them as a Chrome trace
+// (also readable by Perfetto) from a background thread. Recording a scope takes no lock; it
+// costs two clock reads and a store into the calling thread's buffer.
 class Instrumentor {
  public:
   Instrumentor(const Instrumentor&) = delete;
@@ -34,56 +92,31 @@ class Instrumentor {
   Instrumentor& operator=(Instrumentor other) = delete;
   Instrumentor& operator=(Instrumentor&& other) = delete;
 
-  void begin_session(const std::string& name, const std::string& filepath = "results.json") {
-    const std::lock_guard lock(m_mutex);
-
-    if (m_current_session != nullptr) {
-      // If there is already a current session, then close it before beginning new one.
-      // Subsequent profiling output meant for the original session will end up in the
-      // newly opened session instead.  That's better than having badly formatted
-      // profiling output.
-      APP_ERROR("Instrumentor::begin_session('{0}') when session '{1}' already open.",
-          name,
-          m_current_session->name);
-      internal_end_session();
-    }
-    m_output_stream.open(filepath);
+  void begin_session(const std::string& name, const std::string& filepath = "results.json");
+  void end_session();
 
-    if (m_output_stream.is_open()) {
-      m_current_session = std::make_unique<InstrumentationSession>(name);
-      write_header();
-    } else {
-      APP_ERROR("Instrumentor could not open results file '{0}'.", filepath);
-    }
-  }
+  // Stable id for `name`. Takes a lock, so call it once per call site (APP_PROFILE_SCOPE does).
+  std::uint32_t intern(std::string_view name);
 
-  void end_session() {
-    const std::lock_guard lock(m_mutex);
-    internal_end_session();
+  [[nodiscard]] bool is_active() const {
+    return m_active.load(std::memory_order_relaxed);
   }
 
-  void write_profile(const ProfileResult& result) {
-    std::stringstream json;
-
-    std::string name{result.name};
-    std::replace(name.begin(), name.end(), '"', '\'');
-
-    json << std::setprecision(3) << std::fixed;
-    json << ",{";
-    json << R"("cat":"function",)";
-    json << "\"dur\":" << (result.elapsed_time.count()) << ',';
-    json << R"("name":")" << name << "\",";
-    json << R"("ph":"X",)";
-    json << "\"pid\":0,";
-    json << R"("tid":")" << result.thread_id << "\",";
-    json << "\"ts\":" << result.start.count();
-    json << "}";
-
-    const std::lock_guard lock(m_mutex);
-    if (m_current_session != nullptr) {
-      m_output_stream << json.str();
-      m_output_stream.flush();
+  void record(const ProfileEvent& event) {
+    thread_local EventBuffer* buffer{nullptr};
+    if (buffer == nullptr) {
+      buffer = &register_thread();
     }
+    if (buffer->push(event)) {
+      m_flush_requested.store(true, std::memory_order_relaxed);
+      m_flush_condition.notify_one();
+    }
+  }
+
+  static std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
   }
 
   static Instrumentor& get() {
@@ -92,41 +125,52 @@ class Instrumentor {
   }
 
  private:
-  Instrumentor() : m_current_session(nullptr) {}
+  static constexpr std::chrono::milliseconds FLUSH_INTERVAL{10};
+
+  Instrumentor() = default;
 
   ~Instrumentor() {
     end_session();
   }
 
-  void write_header() {
-    m_output_stream << R"({"otherData": {},"traceEvents":[{})";
-    m_output_stream.flush();
-  }
-
-  void write_footer() {
-    m_output_stream << "]}";
-    m_output_stream.flush();
-  }
-
-  // Note: you must already own lock on m_Mutex before
-  // calling InternalEndSession()
-  void internal_end_session() {
-    if (m_current_session != nullptr) {
-      write_footer();
-      m_output_stream.close();
-    }
-  }
+  EventBuffer& register_thread();
+  void flush_loop();
+  // Note: you must already own the lock on m_session_mutex before calling these.
+  void drain_buffers(bool write);
+  void internal_end_session();
 
+  // Names and buffers, the only state producers lock for (once per call site and thread).
   std::mutex m_mutex;
+  std::vector<std::string> m_names;
+  std::unordered_map<std::string, std::uint32_t> m_name_ids;
+  // Buffers live as long as the Instrumentor, so threads may exit at any time.
+  std::vector<std::unique_ptr<EventBuffer>> m_buffers;
+
+  // The session and its file. Draining copies what it needs out of m_mutex first, so
+  // formatting and writing never hold up a thread registering a name.
+  std::mutex m_session_mutex;
   std::unique_ptr<InstrumentationSession> m_current_session;
   std::ofstream m_output_stream;
+  std::int64_t m_session_start_ns{0};
+  std::uint64_t m_dropped{0};
+  std::vector<EventBuffer*> m_drained_buffers;
+  std::vector<std::string> m_trace_names;
+  std::string m_trace;
+
+  std::atomic<bool> m_active{false};
+  std::thread m_flusher;
+  std::mutex m_flush_mutex;
+  std::condition_variable m_flush_condition;
+  std::atomic<bool> m_flush_requested{false};
+  bool m_stop_flusher{false};
 };
 
 class InstrumentationTimer {
  public:
-  explicit InstrumentationTimer(std::string name)
-      : m_name(std::move(name)),
-        m_start_time_point(std::chrono::steady_clock::now()) {}
+  explicit InstrumentationTimer(std::uint32_t name_id)
+      : m_name_id(name_id),
+        m_active(Instrumentor::get().is_active()),
+        m_start_ns(m_active ? Instrumentor::now_ns() : 0) {}
 
   InstrumentationTimer(const InstrumentationTimer&) = delete;
   InstrumentationTimer(InstrumentationTimer&&) = delete;
@@ -134,29 +178,15 @@ class InstrumentationTimer {
   InstrumentationTimer& operator=(InstrumentationTimer&& other) = delete;
 
   ~InstrumentationTimer() {
-    if (!m_stopped) {
-      stop();
+    if (m_active) {
+      Instrumentor::get().record({m_name_id, m_start_ns, Instrumentor::now_ns() - m_start_ns});
     }
   }
 
-  void stop() {
-    const auto end_time_point{std::chrono::steady_clock::now()};
-    const auto high_res_start{FloatingPointMicroseconds{m_start_time_point.time_since_epoch()}};
-    const auto elapsed_time{
-        std::chrono::time_point_cast<std::chrono::microseconds>(end_time_point).time_since_epoch() -
-        std::chrono::time_point_cast<std::chrono::microseconds>(m_start_time_point)
-            .time_since_epoch()};
-
-    Instrumentor::get().write_profile(
-        {m_name, high_res_start, elapsed_time, std::this_thread::get_id()});
-
-    m_stopped = true;
-  }
-
  private:
-  const std::string m_name;
-  bool m_stopped{false};
-  const std::chrono::time_point<std::chrono::steady_clock> m_start_time_point;
+  const std::uint32_t m_name_id;
+  const bool m_active;
+  const std::int64_t m_start_ns;
 };
 
 }  // namespace App::Debug
@@ -193,9 +223,12 @@ class InstrumentationTimer {
 #define APP_PROFILE_BEGIN_SESSION_WITH_FILE(name, file_path) \
   ::App::Debug::Instrumentor::get().begin_session(name, file_path)
 #define APP_PROFILE_END_SESSION() ::App::Debug::Instrumentor::get().end_session()
-#define APP_PROFILE_SCOPE(name)                                    \
-  const ::App::Debug::InstrumentationTimer JOIN(timer, __LINE__) { \
-    name                                                           \
+// The name is interned once per call site, on first use.
+#define APP_PROFILE_SCOPE(name)                                          \
+  static const std::uint32_t JOIN(profile_name, __LINE__){              \
+      ::App::Debug::Instrumentor::get().intern(name)};                  \
+  const ::App::Debug::InstrumentationTimer JOIN(timer, __LINE__) {       \
+    JOIN(profile_name, __LINE__)                                         \
   }
 #define APP_PROFILE_FUNCTION() APP_PROFILE_SCOPE(APP_FUNC_SIG)
 #else
@@ -0,0 +1,125 @@
+#include "PerfStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Core/Debug/AllocationCounter.hpp"
+
+namespace App::Debug {
+
+namespace {
+
+double to_milliseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+PerfStats& PerfStats::get() {
+  static PerfStats instance;
+  return instance;
+}
+
+void PerfStats::add_time(Stage stage, std::chrono::nanoseconds elapsed) {
+  m_pending_ns[static_cast<std::size_t>(stage)].fetch_add(
+      elapsed.count(), std::memory_order_relaxed);
+}
+
+void PerfStats::add_evaluations(std::size_t count) {
+  m_pending_evaluations.fetch_add(count, std::memory_order_relaxed);
+}
+
+void PerfStats::end_frame(std::chrono::nanoseconds frame_time, std::size_t vertex_count) {
+  m_frames[m_next] = static_cast<float>(to_milliseconds(frame_time));
+  for (std::size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+    const std::chrono::nanoseconds spent{
+        m_pending_ns[stage].exchange(0, std::memory_order_relaxed)};
+    m_stages[stage][m_next] = static_cast<float>(to_milliseconds(spent));
+  }
+
+  m_evaluations = m_pending_evaluations.exchange(0, std::memory_order_relaxed);
+  m_vertices = vertex_count;
+
+  const std::uint64_t ui_allocations{AllocationCounter::this_thread()};
+  const std::uint64_t allocations{AllocationCounter::total()};
+  m_ui_allocations = ui_allocations - m_ui_allocations_mark;
+  m_allocations = allocations - m_allocations_mark;
+  m_ui_allocations_mark = ui_allocations;
+  m_allocations_mark = allocations;
+  m_next = (m_next + 1) % HISTORY;
+  m_filled = std::min(m_filled + 1, HISTORY);
+}
+
+PerfStats::Percentiles PerfStats::frame_percentiles() const {
+  if (m_filled == 0) {
+    return {0.0, 0.0, 0.0};
+  }
+
+  // Until the history wraps, only the first `m_filled` slots hold frames.
+  std::array<float, HISTORY> sorted{m_frames};
+  const auto end{sorted.begin() + static_cast<std::ptrdiff_t>(m_filled)};
+  const auto percentile{[&sorted, end, this](double fraction) {
+    const auto rank{static_cast<std::ptrdiff_t>(fraction * static_cast<double>(m_filled - 1))};
+    std::nth_element(sorted.begin(), sorted.begin() + rank, end);
+    return static_cast<double>(sorted[static_cast<std::size_t>(rank)]);
+  }};
+
+  return {percentile(0.50), percentile(0.95), percentile(0.99)};
+}
+
+double PerfStats::stage_average(Stage stage) const {
+  if (m_filled == 0) {
+    return 0.0;
+  }
+
+  const auto& history{m_stages[static_cast<std::size_t>(stage)]};
+  double total{0.0};
+  for (std::size_t i = 0; i < m_filled; ++i) {
+    total += history[i];
+  }
+  return total / static_cast<double>(m_filled);
+}
+
+const char* PerfStats::stage_name(Stage stage) {
+  switch (stage) {
+    case Stage::Parse:
+      return "Parse";
+    case Stage::Evaluate:
+      return "Evaluate";
+    case Stage::Tessellate:
+      return "Tessellate";
+    case Stage::Render:
+      return "Render";
+    default:
+      return "?";
+  }
+}
+
+const std::array<float, PerfStats::HISTORY>& PerfStats::frame_history() const {
+  return m_frames;
+}
+
+std::size_t PerfStats::history_offset() const {
+  return m_filled < HISTORY ? 0 : m_next;
+}
+
+std::uint64_t PerfStats::evaluations_last_frame() const {
+  return m_evaluations;
+}
+
+std::size_t PerfStats::vertices_last_frame() const {
+  return m_vertices;
+}
+
+std::uint64_t PerfStats::ui_allocations_last_frame() const {
+  return m_ui_allocations;
+}
+
+std::uint64_t PerfStats::allocations_last_frame() const {
+  return m_allocations;
+}
+
+}  // namespace App::Debug
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace App::Debug {
+
+// Live counters behind the in-app performance overlay.
+//
+// Unlike the Instrumentor, which writes a trace for offline inspection, this keeps a rolling
+// window of the last frames in memory, cheap enough to stay on all the time. Stage times may be
+// reported from any thread (sampling runs on the worker pool); they are summed until the UI
+// thread closes the frame with `end_frame()`.
+class PerfStats {
+ public:
+  enum class Stage : std::size_t { Parse, Evaluate, Tessellate, Render, Count };
+
+  static constexpr std::size_t HISTORY{240};
+
+  struct Percentiles {
+    double p50;
+    double p95;
+    double p99;
+  };
+
+  PerfStats(const PerfStats&) = delete;
+  PerfStats(PerfStats&&) = delete;
+  PerfStats& operator=(PerfStats other) = delete;
+  PerfStats& operator=(PerfStats&& other) = delete;
+
+  static PerfStats& get();
+
+  // Thread-safe.
+  void add_time(Stage stage, std::chrono::nanoseconds elapsed);
+  void add_evaluations(std::size_t count);
+
+  // UI thread only.
+  void end_frame(std::chrono::nanoseconds frame_time, std::size_t vertex_count);
+
+  // Frame time percentiles over the history, in milliseconds.
+  [[nodiscard]] Percentiles frame_percentiles() const;
+  // Average time per frame spent in `stage` over the history, in milliseconds.
+  [[nodiscard]] double stage_average(Stage stage) const;
+  [[nodiscard]] static const char* stage_name(Stage stage);
+
+  // Frame times in milliseconds as a ring buffer starting at `history_offset()`, for plotting.
+  [[nodiscard]] const std::array<float, HISTORY>& frame_history() const;
+  [[nodiscard]] std::size_t history_offset() const;
+
+  [[nodiscard]] std::uint64_t evaluations_last_frame() const;
+  [[nodiscard]] std::size_t vertices_last_frame() const;
+  // Heap allocations during the last frame (see AllocationCounter): on the thread calling
+  // `end_frame()`, and on all threads.
+  [[nodiscard]] std::uint64_t ui_allocations_last_frame() const;
+  [[nodiscard]] std::uint64_t allocations_last_frame() const;
+
+ private:
+  PerfStats() = default;
+  ~PerfStats() = default;
+
+  static constexpr auto STAGE_COUNT{static_cast<std::size_t>(Stage::Count)};
+
+  std::array<std::atomic<std::int64_t>, STAGE_COUNT> m_pending_ns{};
+  std::atomic<std::uint64_t> m_pending_evaluations{0};
+
+  std::array<float, HISTORY> m_frames{};
+  std::array<std::array<float, HISTORY>, STAGE_COUNT> m_stages{};
+  std::size_t m_next{0};
+  std::size_t m_filled{0};
+  std::uint64_t m_evaluations{0};
+  std::size_t m_vertices{0};
+  std::uint64_t m_ui_allocations_mark{0};
+  std::uint64_t m_allocations_mark{0};
+  std::uint64_t m_ui_allocations{0};
+  std::uint64_t m_allocations{0};
+};
+
+// Adds the lifetime of the scope to a PerfStats stage.
+class StageTimer {
+ public:
+  explicit StageTimer(PerfStats::Stage stage)
+      : m_stage(stage),
+        m_start(std::chrono::steady_clock::now()) {}
+
+  StageTimer(const StageTimer&) = delete;
+  StageTimer(StageTimer&&) = delete;
+  StageTimer& operator=(StageTimer other) = delete;
+  StageTimer& operator=(StageTimer&& other) = delete;
+
+  ~StageTimer() {
+    PerfStats::get().add_time(m_stage, std::chrono::steady_clock::now() - m_start);
+  }
+
+ private:
+  PerfStats::Stage m_stage;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace App::Debug
@@ -0,0 +1,507 @@
+#include "Exporter.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/AxisLayer.hpp"
+#include "Core/CurveGeometry.hpp"
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/FontCache.hpp"
+#include "Core/FrameArena.hpp"
+#include "Core/Log.hpp"
+#include "Core/PlotPipeline.hpp"
+#include "Core/Polyline.hpp"
+#include "Core/Raster.hpp"
+#include "Core/Resources.hpp"
+#include "Core/Session.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Core/expression.hpp"
+
+namespace App::Core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// As in the graph view.
+constexpr float THICKNESS{3.0F};
+constexpr float FONT_SIZE{18.0F};
+constexpr ImU32 BACKGROUND{IM_COL32(255, 255, 255, 255)};
+
+double ms_since(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Coordinates with two decimals: a hundredth of a pixel is below any renderer's precision.
+void append_number(std::string& out, double value) {
+  std::array<char, 32> buffer{};
+  const auto result{std::to_chars(
+      buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, 2)};
+  out.append(buffer.data(), result.ptr);
+}
+
+void append_point(std::string& out, const ImVec2& point) {
+  append_number(out, point.x);
+  out += ',';
+  append_number(out, point.y);
+}
+
+// Color and opacity attributes, e.g. ` stroke="#C74440" stroke-opacity="1.00"`.
+void append_paint(std::string& out, const char* attribute, ImU32 color, float alpha = 1.0F) {
+  constexpr std::string_view DIGITS{"0123456789ABCDEF"};
+  out += ' ';
+  out += attribute;
+  out += "=\"#";
+  for (const int shift : {IM_COL32_R_SHIFT, IM_COL32_G_SHIFT, IM_COL32_B_SHIFT}) {
+    const unsigned channel{(color >> static_cast<unsigned>(shift)) & 0xFFU};
+    out += DIGITS[channel >> 4U];
+    out += DIGITS[channel & 0xFU];
+  }
+  out += "\" ";
+  out += attribute;
+  out += "-opacity=\"";
+  append_number(out,
+      alpha * static_cast<float>((color >> IM_COL32_A_SHIFT) & 0xFFU) / 255.0F);
+  out += '"';
+}
+
+// The plotted rows as SVG, going through the same clipping and simplification as the
+// triangles of the graph view.
+std::string to_svg(const ExpressionList& functions,
+    const std::vector<std::size_t>& plotted,
+    const PlotPipeline::Viewport& viewport,
+    int width,
+    int height) {
+  const double pixels_per_unit{viewport.pixels_per_unit};
+  const double center_x{0.5 * (viewport.xmin + viewport.xmax)};
+  const double center_y{0.5 * (viewport.ymin + viewport.ymax)};
+  const auto size_x{static_cast<float>(width)};
+  const auto size_y{static_cast<float>(height)};
+  const auto to_screen{[&](const Sample& sample) {
+    const double y{0.5 * size_y + (center_y - sample.y) * pixels_per_unit};
+    return ImVec2(static_cast<float>(0.5 * size_x + (sample.x - center_x) * pixels_per_unit),
+        static_cast<float>(std::clamp(y,
+            -CurveGeometry::MAX_SCREEN_COORDINATE,
+            CurveGeometry::MAX_SCREEN_COORDINATE)));
+  }};
+
+  std::string svg;
+  svg += "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+  svg += std::to_string(width);
+  svg += "\" height=\"";
+  svg += std::to_string(height);
+  svg += "\" viewBox=\"0 0 ";
+  svg += std::to_string(width);
+  svg += ' ';
+  svg += std::to_string(height);
+  svg += "\">\n<rect width=\"100%\" height=\"100%\"";
+  append_paint(svg, "fill", BACKGROUND);
+  svg += "/>\n";
+
+  // Grid, axes, ticks and labels, laid out like AxisLayer.
+  const double origin_x{0.5 * size_x - center_x * pixels_per_unit};
+  const double origin_y{0.5 * size_y + center_y * pixels_per_unit};
+  const double step{AxisLayer::nice_step(AxisLayer::MIN_TICK_SPACING_PX / pixels_per_unit)};
+  const double spacing{step * pixels_per_unit};
+  const auto first_x{static_cast<std::int64_t>(std::floor(-origin_x / spacing))};
+  const auto last_x{static_cast<std::int64_t>(std::ceil((size_x - origin_x) / spacing))};
+  const auto first_y{static_cast<std::int64_t>(std::floor((origin_y - size_y) / spacing))};
+  const auto last_y{static_cast<std::int64_t>(std::ceil(origin_y / spacing))};
+  const auto x_of{[&](std::int64_t tick) {
+    return static_cast<float>(origin_x + static_cast<double>(tick) * spacing);
+  }};
+  const auto y_of{[&](std::int64_t tick) {
+    return static_cast<float>(origin_y - static_cast<double>(tick) * spacing);
+  }};
+  const ImVec2 origin{static_cast<float>(std::clamp(origin_x, 0.0, static_cast<double>(size_x))),
+      static_cast<float>(std::clamp(origin_y, 0.0, static_cast<double>(size_y)))};
+  const auto line{[&svg](const ImVec2& a, const ImVec2& b) {
+    svg += 'M';
+    append_point(svg, a);
+    svg += 'L';
+    append_point(svg, b);
+  }};
+
+  svg += "<path fill=\"none\" stroke-width=\"1\"";
+  append_paint(svg, "stroke", AxisLayer::GRID_COLOR);
+  svg += " d=\"";
+  for (std::int64_t tick = first_x; tick <= last_x; ++tick) {
+    line(ImVec2(x_of(tick), 0.0F), ImVec2(x_of(tick), size_y));
+  }
+  for (std::int64_t tick = first_y; tick <= last_y; ++tick) {
+    line(ImVec2(0.0F, y_of(tick)), ImVec2(size_x, y_of(tick)));
+  }
+  svg += "\"/>\n<path fill=\"none\" stroke-width=\"1\"";
+  append_paint(svg, "stroke", AxisLayer::TICK_COLOR);
+  svg += " d=\"";
+  for (std::int64_t tick = first_x; tick <= last_x; ++tick) {
+    line(ImVec2(x_of(tick), origin.y - AxisLayer::TICK_LENGTH),
+        ImVec2(x_of(tick), origin.y + AxisLayer::TICK_LENGTH));
+  }
+  for (std::int64_t tick = first_y; tick <= last_y; ++tick) {
+    line(ImVec2(origin.x - AxisLayer::TICK_LENGTH, y_of(tick)),
+        ImVec2(origin.x + AxisLayer::TICK_LENGTH, y_of(tick)));
+  }
+  svg += "\"/>\n<path fill=\"none\" stroke-width=\"";
+  append_number(svg, THICKNESS);
+  svg += '"';
+  append_paint(svg, "stroke", AxisLayer::AXIS_COLOR);
+  svg += " d=\"";
+  if (origin_y >= 0.0 && origin_y <= static_cast<double>(size_y)) {
+    line(ImVec2(0.0F, origin.y), ImVec2(size_x, origin.y));
+  }
+  if (origin_x >= 0.0 && origin_x <= static_cast<double>(size_x)) {
+    line(ImVec2(origin.x, 0.0F), ImVec2(origin.x, size_y));
+  }
+  svg += "\"/>\n<g font-family=\"Manrope, sans-serif\" font-size=\"";
+  append_number(svg, AxisLayer::LABEL_FONT_SIZE);
+  svg += '"';
+  append_paint(svg, "fill", AxisLayer::TEXT_COLOR);
+  svg += ">\n";
+  const int decimals{AxisLayer::label_decimals(step)};
+  // ImGui places text by its top-left corner, SVG by the baseline.
+  const float ascent{0.8F * AxisLayer::LABEL_FONT_SIZE};
+  const auto label{[&](std::int64_t tick, const ImVec2& position) {
+    std::array<char, 32> text{};
+    std::snprintf(
+        text.data(), text.size(), "%.*f", decimals, static_cast<double>(tick) * step);
+    svg += "<text x=\"";
+    append_number(svg, position.x);
+    svg += "\" y=\"";
+    append_number(svg, position.y + ascent);
+    svg += "\">";
+    svg += text.data();
+    svg += "</text>\n";
+  }};
+  for (std::int64_t tick = first_x; tick <= last_x; ++tick) {
+    if (tick != 0) {
+      label(tick, ImVec2(x_of(tick) - 10.0F, origin.y + AxisLayer::LABEL_OFFSET));
+    }
+  }
+  for (std::int64_t tick = first_y; tick <= last_y; ++tick) {
+    if (tick != 0) {
+      label(tick, ImVec2(origin.x + AxisLayer::LABEL_OFFSET, y_of(tick) - 10.0F));
+    }
+  }
+  svg += "</g>\n";
+
+  std::pmr::vector<ImVec2> points;
+  std::pmr::vector<ImVec2> reduced;
+  for (const std::size_t i : plotted) {
+    const auto curve{functions.curve[i].latest()};
+    const ImU32 color{functions.color[i]};
+    const float thickness{THICKNESS * functions.thickness[i]};
+
+    if (!curve->regions.empty()) {
+      svg += "<path stroke=\"none\"";
+      append_paint(svg,
+          "fill",
+          color,
+          static_cast<float>(CurveGeometry::REGION_ALPHA) / 255.0F);
+      svg += " d=\"";
+      for (const auto& box : curve->regions) {
+        const ImVec2 a{to_screen({box.x0, box.y1})};
+        const ImVec2 b{to_screen({box.x1, box.y0})};
+        svg += 'M';
+        append_point(svg, a);
+        svg += 'H';
+        append_number(svg, b.x);
+        svg += 'V';
+        append_number(svg, b.y);
+        svg += 'H';
+        append_number(svg, a.x);
+        svg += 'Z';
+      }
+      svg += "\"/>\n";
+    }
+
+    svg += "<g fill=\"none\" stroke-linecap=\"round\" stroke-linejoin=\"round\" stroke-width=\"";
+    append_number(svg, thickness);
+    svg += '"';
+    append_paint(svg, "stroke", color);
+    svg += ">\n";
+    if (!curve->segments.empty()) {
+      svg += "<path d=\"";
+      for (const auto& segment : curve->segments) {
+        line(to_screen(segment.a), to_screen(segment.b));
+      }
+      svg += "\"/>\n";
+    }
+
+    points.clear();
+    for (const auto& sample : curve->samples) {
+      points.push_back(to_screen(sample));
+    }
+    reduced.clear();
+    Polyline::clip(points, -thickness, size_y + thickness, reduced);
+    points.clear();
+    Polyline::simplify(reduced, Polyline::DEFAULT_TOLERANCE_PX, points, curve->ordered_by_x);
+    Polyline::for_each_run(points, [&svg](const ImVec2* run, std::size_t count) {
+      svg += "<polyline points=\"";
+      for (std::size_t j = 0; j < count; ++j) {
+        if (j > 0) {
+          svg += ' ';
+        }
+        append_point(svg, run[j]);
+      }
+      svg += "\"/>\n";
+    });
+    svg += "</g>\n";
+  }
+
+  svg += "</svg>\n";
+  return svg;
+}
+
+}  // namespace
+
+struct Exporter::Plot {
+  std::filesystem::path session_path;
+  std::filesystem::path output;
+  ExpressionList functions;
+  PlotPipeline pipeline;
+  PlotPipeline::Viewport viewport{0.0, 0.0, 0.0, 0.0, 0.0};
+  double center_x{0.0};
+  double center_y{0.0};
+  AxisLayer axes;
+  ImDrawList draw_list{nullptr};
+
+  Clock::time_point start;
+  // Set once sampling is done; the next update picks up the finished geometry.
+  bool sampled{false};
+  bool done{false};
+  double sample_ms{0.0};
+  double write_ms{0.0};
+  bool written{false};
+};
+
+Exporter::Exporter() {
+  const auto start{Clock::now()};
+  APP_PROFILE_FUNCTION();
+
+  // A bare context is enough for draw lists: no platform or renderer backend.
+  ImGui::CreateContext();
+  ImGuiIO& io{ImGui::GetIO()};
+  io.IniFilename = nullptr;
+  io.DeltaTime = 1.0F / 60.0F;
+  // Raster honors the commands' vertex offsets, so large plots need not fit 16-bit indices.
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+  // The baked atlas is shared with the app's cache, so a batch does not rasterize the font.
+  const std::string font_path{Resources::font_path("Manrope.ttf").generic_string()};
+  const std::filesystem::path font_cache{FontCache::entry_path("Manrope.ttf", FONT_SIZE)};
+  bool store_font_cache{false};
+  if (Resources::exists(font_path)) {
+    m_font = FontCache::load(*io.Fonts, font_cache, font_path, FONT_SIZE);
+    if (m_font == nullptr) {
+      m_font = io.Fonts->AddFontFromFileTTF(font_path.c_str(), FONT_SIZE);
+      store_font_cache = m_font != nullptr;
+    }
+  } else {
+    APP_WARN("Could not find font file under: {}", font_path.c_str());
+  }
+  if (m_font == nullptr) {
+    m_font = io.Fonts->AddFontDefault();
+  }
+  io.FontDefault = m_font;
+
+  unsigned char* pixels{nullptr};
+  int width{0};
+  int height{0};
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+  m_atlas = {pixels, width, height};
+  if (store_font_cache) {
+    FontCache::store(*io.Fonts, font_cache, font_path, FONT_SIZE);
+  }
+
+  m_startup_ms = ms_since(start);
+}
+
+Exporter::~Exporter() {
+  ImGui::DestroyContext();
+}
+
+std::size_t Exporter::run(
+    std::span<const std::filesystem::path> sessions, const Options& options) {
+  APP_PROFILE_FUNCTION();
+
+  const auto start{Clock::now()};
+  const auto width{static_cast<float>(options.width)};
+  const auto height{static_cast<float>(options.height)};
+  const char* extension{options.format == Format::Svg ? ".svg" : ".png"};
+  std::size_t failed{0};
+
+  std::printf("%-40s %10s %10s\n", "output", "sample ms", "write ms");
+  for (std::size_t begin = 0; begin < sessions.size(); begin += MAX_PLOTS_IN_FLIGHT) {
+    const std::size_t end{std::min(sessions.size(), begin + MAX_PLOTS_IN_FLIGHT)};
+
+    std::vector<std::unique_ptr<Plot>> plots;
+    for (std::size_t i = begin; i < end; ++i) {
+      auto plot{std::make_unique<Plot>()};
+      plot->start = Clock::now();
+      plot->session_path = sessions[i];
+      plot->output = options.output_directory / sessions[i].stem();
+      plot->output += extension;
+
+      Session session;
+      if (!session.load(sessions[i])) {
+        ++failed;
+        continue;
+      }
+      for (const auto& row : session.rows) {
+        const std::size_t index{plot->functions.add(row.text, row.color)};
+        plot->functions.visible[index] = row.visible ? 1 : 0;
+      }
+      const double half_width{0.5 * width / session.pixels_per_unit};
+      const double half_height{0.5 * height / session.pixels_per_unit};
+      plot->viewport = {session.center_x - half_width,
+          session.center_x + half_width,
+          session.center_y - half_height,
+          session.center_y + half_height,
+          session.pixels_per_unit};
+      plot->center_x = session.center_x;
+      plot->center_y = session.center_y;
+      plots.push_back(std::move(plot));
+    }
+
+    sample(plots, options);
+
+    {
+      APP_PROFILE_SCOPE("Exporter::write");
+      ThreadPool::get().parallel_for(plots.size(), [&](std::size_t i) {
+        Plot& plot{*plots[i]};
+        const auto write_start{Clock::now()};
+        if (options.format == Format::Svg) {
+          const std::string svg{to_svg(plot.functions,
+              plot.pipeline.plotted(),
+              plot.viewport,
+              options.width,
+              options.height)};
+          std::ofstream file{plot.output, std::ios::binary};
+          file << svg;
+          plot.written = file.good();
+          if (!plot.written) {
+            APP_WARN("Could not write {}", plot.output.generic_string());
+          }
+        } else {
+          Raster raster{options.width, options.height, BACKGROUND};
+          raster.draw(plot.draw_list, m_atlas);
+          plot.written = raster.write_png(plot.output);
+        }
+        plot.write_ms = ms_since(write_start);
+      });
+    }
+
+    for (const auto& plot : plots) {
+      failed += plot->written ? 0U : 1U;
+      std::printf("%-40s %10.3f %10.3f\n",
+          plot->output.generic_string().c_str(),
+          plot->sample_ms,
+          plot->write_ms);
+    }
+  }
+
+  const double total_ms{ms_since(start)};
+  std::printf("%zu plots in %.3f ms (%.3f ms per plot), startup %.3f ms, %zu failed\n",
+      sessions.size(),
+      total_ms,
+      sessions.empty() ? 0.0 : total_ms / static_cast<double>(sessions.size()),
+      m_startup_ms,
+      failed);
+  return failed;
+}
+
+void Exporter::sample(std::vector<std::unique_ptr<Plot>>& plots, const Options& options) {
+  APP_PROFILE_FUNCTION();
+
+  ImGuiIO& io{ImGui::GetIO()};
+  io.DisplaySize = ImVec2(static_cast<float>(options.width), static_cast<float>(options.height));
+
+  // Every plot's sampling is queued on the pool at once; this thread only issues requests and
+  // helps with the queue while they run. Plots finish at their own pace.
+  FrameArena arena;
+  bool pending{true};
+  while (pending) {
+    pending = false;
+    ImGui::NewFrame();
+    const ImDrawList* reference{ImGui::GetForegroundDrawList()};
+    for (auto& plot : plots) {
+      if (plot->done) {
+        continue;
+      }
+      pending = true;
+      const bool sampling{plot->pipeline.update(
+          plot->functions, plot->viewport, THICKNESS, reference, &arena)};
+      if (sampling) {
+        continue;
+      }
+      if (!plot->sampled) {
+        plot->sampled = true;
+        continue;
+      }
+      plot->done = true;
+      plot->sample_ms = ms_since(plot->start);
+
+      if (options.format == Format::Png) {
+        build_draw_list(*plot, options, reference);
+      }
+    }
+    ImGui::EndFrame();
+    arena.reset();
+
+    if (pending && !ThreadPool::get().run_one()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void Exporter::build_draw_list(Plot& plot, const Options& options, const ImDrawList* reference) {
+  APP_PROFILE_FUNCTION();
+
+  const auto width{static_cast<float>(options.width)};
+  const auto height{static_cast<float>(options.height)};
+  const double zoom{plot.viewport.pixels_per_unit};
+
+  ImDrawList& draw_list{plot.draw_list};
+  draw_list._Data = reference->_Data;
+  draw_list._ResetForNewFrame();
+  draw_list.Flags = reference->Flags;
+  draw_list.PushClipRect(ImVec2(0.0F, 0.0F), ImVec2(width, height));
+  draw_list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+
+  plot.axes.update({width,
+                       height,
+                       width * 0.5 - plot.center_x * zoom,
+                       height * 0.5 + plot.center_y * zoom,
+                       zoom,
+                       THICKNESS},
+      reference,
+      m_font);
+  plot.axes.draw(&draw_list, ImVec2(0.0F, 0.0F));
+  plot.pipeline.draw(plot.functions, &draw_list, ImVec2(width * 0.5F, height * 0.5F));
+}
+
+double Exporter::startup_ms() const {
+  return m_startup_ms;
+}
+
+}  // namespace App::Core
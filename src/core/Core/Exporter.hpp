@@ -0,0 +1,66 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Core/Raster.hpp"
+
+namespace App::Core {
+
+// Headless batch export of session files (see Session) to SVG or PNG, for CI and reports.
+//
+// There is no window, renderer or SDL: like src/bench it runs the interactive PlotPipeline
+// through a bare Dear ImGui context, so the plots are sampled, clipped and simplified exactly
+// as on screen. Many plots are in flight at once and their sampling shares the worker pool;
+// writing the files runs in parallel as well. PNGs are ImGui's triangles rasterized in
+// software (see Raster); SVGs are the simplified polylines and contour segments.
+class Exporter {
+ public:
+  enum class Format { Svg, Png };
+
+  struct Options {
+    int width{1280};
+    int height{720};
+    Format format{Format::Png};
+    // Each session is written here as <session name>.svg or .png.
+    std::filesystem::path output_directory{"."};
+  };
+
+  // Creates the context and bakes its font atlas.
+  Exporter();
+  ~Exporter();
+
+  Exporter(const Exporter&) = delete;
+  Exporter(Exporter&&) = delete;
+  Exporter& operator=(const Exporter&) = delete;
+  Exporter& operator=(Exporter&&) = delete;
+
+  // Renders every session, printing the sampling and writing time of each plot in ms and a
+  // summary. Returns the number of sessions that could not be loaded or written.
+  std::size_t run(std::span<const std::filesystem::path> sessions, const Options& options);
+
+  // Time the constructor took, in ms.
+  [[nodiscard]] double startup_ms() const;
+
+ private:
+  struct Plot;
+
+  // Plots sampled together; bounds memory when exporting thousands of sessions.
+  static constexpr std::size_t MAX_PLOTS_IN_FLIGHT{64};
+
+  // Samples `plots` together until all of them are settled; builds their draw lists for PNGs.
+  void sample(std::vector<std::unique_ptr<Plot>>& plots, const Options& options);
+  // Axes and curves of a settled plot, as the graph view draws them.
+  void build_draw_list(Plot& plot, const Options& options, const ImDrawList* reference);
+
+  ImFont* m_font{nullptr};
+  Raster::Texture m_atlas{nullptr, 0, 0};
+  double m_startup_ms{0.0};
+};
+
+}  // namespace App::Core
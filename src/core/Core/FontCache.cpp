@@ -0,0 +1,219 @@
+#include "FontCache.hpp"
+
+#include <SDL2/SDL.h>
+#include <imgui.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+#include "Settings/Project.hpp"
+
+namespace App::Core {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC{'I', 'm', 'A', 't', 'l', 'a', 's', '1'};
+
+// Written as is: entries are only read back by the same build (see `matches`).
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t imgui_version;
+  std::uint32_t glyph_size;
+  std::uint64_t font_file_size;
+  std::int64_t font_file_time;
+  float size;
+  std::int32_t atlas_flags;
+  std::int32_t glyph_padding;
+
+  std::int32_t width;
+  std::int32_t height;
+  ImVec2 white_pixel;
+  std::array<ImVec4, IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1> lines;
+  float font_size;
+  float ascent;
+  float descent;
+  std::uint32_t glyph_count;
+};
+
+// The fields identifying what an entry was baked from; false if the font file is missing.
+bool key_of(const ImFontAtlas& atlas,
+    const std::filesystem::path& font_path,
+    float size,
+    Header& header) {
+  std::error_code error;
+  const auto file_size{std::filesystem::file_size(font_path, error)};
+  if (error) {
+    return false;
+  }
+  const auto file_time{std::filesystem::last_write_time(font_path, error)};
+  if (error) {
+    return false;
+  }
+
+  header.magic = MAGIC;
+  header.imgui_version = IMGUI_VERSION_NUM;
+  header.glyph_size = sizeof(ImFontGlyph);
+  header.font_file_size = file_size;
+  header.font_file_time = static_cast<std::int64_t>(file_time.time_since_epoch().count());
+  header.size = size;
+  header.atlas_flags = atlas.Flags;
+  header.glyph_padding = atlas.TexGlyphPadding;
+  return true;
+}
+
+bool matches(const Header& entry, const Header& key) {
+  return entry.magic == key.magic && entry.imgui_version == key.imgui_version &&
+         entry.glyph_size == key.glyph_size && entry.font_file_size == key.font_file_size &&
+         entry.font_file_time == key.font_file_time && entry.size == key.size &&
+         entry.atlas_flags == key.atlas_flags && entry.glyph_padding == key.glyph_padding;
+}
+
+std::size_t entry_size(const Header& header) {
+  return sizeof(Header) + std::size_t{header.glyph_count} * sizeof(ImFontGlyph) +
+         static_cast<std::size_t>(header.width) * static_cast<std::size_t>(header.height);
+}
+
+}  // namespace
+
+std::filesystem::path FontCache::entry_path(std::string_view font_file, float size) {
+  char* pref_path{SDL_GetPrefPath(COMPANY_NAMESPACE.c_str(), APP_NAME.c_str())};
+  if (pref_path == nullptr) {
+    return {};
+  }
+  std::filesystem::path path{pref_path};
+  SDL_free(pref_path);
+
+  std::array<char, 32> suffix{};
+  std::snprintf(suffix.data(), suffix.size(), "-%.2fpx.atlas", static_cast<double>(size));
+  path /= std::filesystem::path{font_file}.stem();
+  path += suffix.data();
+  return path;
+}
+
+ImFont* FontCache::load(ImFontAtlas& atlas,
+    const std::filesystem::path& entry,
+    const std::filesystem::path& font_path,
+    float size) {
+  APP_PROFILE_FUNCTION();
+
+  Header key{};
+  std::error_code error;
+  if (entry.empty() || !atlas.Fonts.empty() || !std::filesystem::exists(entry, error) ||
+      !key_of(atlas, font_path, size, key)) {
+    return nullptr;
+  }
+
+  MappedFile file;
+  if (!file.open(entry) || file.size() < sizeof(Header)) {
+    return nullptr;
+  }
+  Header header{};
+  std::memcpy(&header, file.data(), sizeof(Header));
+  if (!matches(header, key) || header.width <= 0 || header.height <= 0 ||
+      header.glyph_count == 0 || file.size() != entry_size(header)) {
+    APP_DEBUG("Font atlas cache {} is stale", entry.generic_string());
+    return nullptr;
+  }
+  const char* glyphs{file.data() + sizeof(Header)};
+  const char* pixels{glyphs + std::size_t{header.glyph_count} * sizeof(ImFontGlyph)};
+
+  // What ImFontAtlas::Build() would leave behind, minus the font data.
+  ImFontConfig config{};
+  config.FontDataOwnedByAtlas = false;
+  config.SizePixels = size;
+  atlas.ConfigData.push_back(config);
+
+  auto* font{IM_NEW(ImFont)()};
+  font->FontSize = header.font_size;
+  font->Ascent = header.ascent;
+  font->Descent = header.descent;
+  font->ContainerAtlas = &atlas;
+  font->ConfigData = &atlas.ConfigData.back();
+  font->ConfigDataCount = 1;
+  font->Glyphs.resize(static_cast<int>(header.glyph_count));
+  std::memcpy(font->Glyphs.Data, glyphs, std::size_t{header.glyph_count} * sizeof(ImFontGlyph));
+  font->BuildLookupTable();
+  atlas.Fonts.push_back(font);
+
+  const std::size_t texels{
+      static_cast<std::size_t>(header.width) * static_cast<std::size_t>(header.height)};
+  atlas.TexWidth = header.width;
+  atlas.TexHeight = header.height;
+  atlas.TexUvScale =
+      ImVec2(1.0F / static_cast<float>(header.width), 1.0F / static_cast<float>(header.height));
+  atlas.TexUvWhitePixel = header.white_pixel;
+  std::memcpy(atlas.TexUvLines, header.lines.data(), sizeof(atlas.TexUvLines));
+  atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(texels));
+  std::memcpy(atlas.TexPixelsAlpha8, pixels, texels);
+  atlas.TexReady = true;
+
+  return font;
+}
+
+bool FontCache::store(ImFontAtlas& atlas,
+    const std::filesystem::path& entry,
+    const std::filesystem::path& font_path,
+    float size) {
+  APP_PROFILE_FUNCTION();
+
+  Header header{};
+  if (entry.empty() || atlas.Fonts.Size != 1 || !key_of(atlas, font_path, size, header)) {
+    return false;
+  }
+  unsigned char* pixels{nullptr};
+  int width{0};
+  int height{0};
+  atlas.GetTexDataAsAlpha8(&pixels, &width, &height);
+  if (pixels == nullptr) {
+    return false;
+  }
+
+  const ImFont& font{*atlas.Fonts[0]};
+  header.width = width;
+  header.height = height;
+  header.white_pixel = atlas.TexUvWhitePixel;
+  std::memcpy(header.lines.data(), atlas.TexUvLines, sizeof(header.lines));
+  header.font_size = font.FontSize;
+  header.ascent = font.Ascent;
+  header.descent = font.Descent;
+  header.glyph_count = static_cast<std::uint32_t>(font.Glyphs.Size);
+
+  // Written next to the entry and renamed over it, so another instance never reads half of it.
+  std::filesystem::path temporary{entry};
+  temporary += ".tmp";
+  {
+    std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+    // NOLINTBEGIN(*-reinterpret-cast): raw bytes of trivially copyable data
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(font.Glyphs.Data),
+        static_cast<std::streamsize>(std::size_t{header.glyph_count} * sizeof(ImFontGlyph)));
+    file.write(reinterpret_cast<const char*>(pixels),
+        static_cast<std::streamsize>(width) * height);
+    // NOLINTEND(*-reinterpret-cast)
+    if (!file.good()) {
+      APP_WARN("Could not write font atlas cache {}", temporary.generic_string());
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, entry, error);
+  if (error) {
+    APP_WARN("Could not write font atlas cache {}: {}", entry.generic_string(), error.message());
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <filesystem>
+#include <string_view>
+
+namespace App::Core {
+
+// Baked font atlases on disk, so starting the app does not rasterize the TTF again.
+//
+// An entry holds the atlas of one font at one size: its 8-bit texture, the white pixel and
+// baked line coordinates, and the glyph table. It is only used if the font file's size and
+// modification time, the pixel size, the atlas flags and the ImGui version all match;
+// anything else (or a damaged file) is a miss and the caller bakes the font as usual.
+class FontCache {
+ public:
+  // Entry for `font_file` at `size` pixels in the user pref path (SDL_GetPrefPath); empty if
+  // there is none.
+  [[nodiscard]] static std::filesystem::path entry_path(std::string_view font_file, float size);
+
+  // Adds the font to the empty `atlas` from `entry` and marks the atlas built. Returns the font,
+  // or null (leaving `atlas` untouched) on a miss. The restored atlas must not be rebuilt: it
+  // has no font data to rebuild from.
+  static ImFont* load(ImFontAtlas& atlas,
+      const std::filesystem::path& entry,
+      const std::filesystem::path& font_path,
+      float size);
+
+  // Writes `atlas`, built from `font_path` at `size` and holding only that font, to `entry`.
+  // Returns false (and logs why) if it cannot.
+  static bool store(ImFontAtlas& atlas,
+      const std::filesystem::path& entry,
+      const std::filesystem::path& font_path,
+      float size);
+};
+
+}  // namespace App::Core
@@ -0,0 +1,84 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace App::Core {
+
+namespace {
+
+std::size_t align_up(std::size_t offset, std::size_t alignment) {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+FrameArena::FrameArena(std::size_t block_size) : m_block_size(block_size) {}
+
+void FrameArena::reset() {
+  m_current = 0;
+  m_offset = 0;
+  m_used = 0;
+}
+
+std::size_t FrameArena::used() const {
+  return m_used;
+}
+
+std::size_t FrameArena::capacity() const {
+  std::size_t total{0};
+  for (const Block& block : m_blocks) {
+    total += block.size;
+  }
+  return total;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  // Offsets are aligned on the address itself, so any alignment is honoured, including those
+  // above what new[] guarantees for the block storage (e.g. alignas(64) SIMD buffers).
+  const auto aligned_offset{[alignment](const Block& block, std::size_t offset) {
+    const auto base{reinterpret_cast<std::uintptr_t>(block.data.get())};
+    return align_up(base + offset, alignment) - base;
+  }};
+
+  while (m_current < m_blocks.size()) {
+    Block& block{m_blocks[m_current]};
+    const std::size_t offset{aligned_offset(block, m_offset)};
+    if (offset + bytes <= block.size) {
+      m_offset = offset + bytes;
+      m_used += bytes;
+      return block.data.get() + offset;
+    }
+    ++m_current;
+    m_offset = 0;
+  }
+
+  // Room for the padding the block's own alignment may need.
+  const std::size_t size{std::max(m_block_size, bytes + alignment - 1)};
+  m_blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+  m_current = m_blocks.size() - 1;
+  const std::size_t offset{aligned_offset(m_blocks.back(), 0)};
+  m_offset = offset + bytes;
+  m_used += bytes;
+  return m_blocks.back().data.get() + offset;
+}
+
+void FrameArena::do_deallocate(void* memory, std::size_t bytes, std::size_t /*alignment*/) {
+  if (m_current >= m_blocks.size()) {
+    return;
+  }
+  const std::byte* top{m_blocks[m_current].data.get() + m_offset};
+  if (static_cast<const std::byte*>(memory) + bytes == top) {
+    m_offset -= bytes;
+    m_used -= bytes;
+  }
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace App::Core {
+
+// Bump allocator for data that only lives until the end of the frame.
+//
+// Hand it to std::pmr containers for per-frame scratch buffers and call `reset()` once the
+// frame is rendered. Blocks are kept across resets, so once the largest frame has been seen no
+// frame touches the heap anymore. Deallocation is a no-op except for the most recent
+// allocation, which lets a growing vector reuse its space.
+class FrameArena final : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t DEFAULT_BLOCK_SIZE{std::size_t{256} * 1024};
+
+  explicit FrameArena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+  // Rewinds to empty. Everything allocated since the last reset becomes invalid.
+  void reset();
+
+  // Bytes handed out since the last reset, and bytes held in blocks.
+  [[nodiscard]] std::size_t used() const;
+  [[nodiscard]] std::size_t capacity() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    std::size_t size;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  std::size_t m_block_size;
+  std::vector<Block> m_blocks;
+  std::size_t m_current{0};
+  std::size_t m_offset{0};
+  std::size_t m_used{0};
+};
+
+}  // namespace App::Core
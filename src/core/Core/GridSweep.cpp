@@ -0,0 +1,113 @@
+#include "GridSweep.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+namespace {
+
+std::uint64_t parameter_revision(std::span<const std::shared_ptr<CompiledExpression>> expressions) {
+  std::uint64_t revision{0};
+  for (const auto& expression : expressions) {
+    revision += expression->parameter_revision();
+  }
+  return revision;
+}
+
+}  // namespace
+
+GridSweep::GridSweep(std::vector<std::shared_ptr<CompiledExpression>> expressions,
+    double xmin,
+    double xmax,
+    double pixels_per_unit)
+    : m_expressions(std::move(expressions)),
+      m_revision(parameter_revision(m_expressions)),
+      m_step(SampleCache::step_for(pixels_per_unit)),
+      m_first(static_cast<std::int64_t>(std::floor(xmin / m_step))),
+      m_count(static_cast<std::size_t>(
+          static_cast<std::int64_t>(std::ceil(xmax / m_step)) - m_first + 1)) {
+  std::vector<const BatchExpression*> code;
+  code.reserve(m_expressions.size());
+  for (const auto& expression : m_expressions) {
+    code.push_back(&expression->batch());
+  }
+  if (!m_program.compile(code)) {
+    // Not all batched; every lookup falls back to the caller.
+    m_expressions.clear();
+    return;
+  }
+
+  m_values.resize(m_expressions.size() * m_count);
+  m_filled = std::make_unique<std::once_flag[]>(  // NOLINT(*-avoid-c-arrays)
+      (m_count + BLOCK_POINTS - 1) / BLOCK_POINTS);
+}
+
+bool GridSweep::matches(std::span<const std::shared_ptr<CompiledExpression>> expressions,
+    double xmin,
+    double xmax,
+    double pixels_per_unit) const {
+  const double step{SampleCache::step_for(pixels_per_unit)};
+  const auto first{static_cast<std::int64_t>(std::floor(xmin / step))};
+  const auto last{static_cast<std::int64_t>(std::ceil(xmax / step))};
+  return step == m_step && first == m_first &&
+         static_cast<std::size_t>(last - first + 1) == m_count &&
+         std::equal(expressions.begin(),
+             expressions.end(),
+             m_expressions.begin(),
+             m_expressions.end()) &&
+         parameter_revision(expressions) == m_revision;
+}
+
+bool GridSweep::lookup(const CompiledExpression* expression,
+    const double* x,
+    double* y,
+    std::size_t count) {
+  const auto member{std::find_if(m_expressions.begin(),
+      m_expressions.end(),
+      [expression](const auto& other) { return other.get() == expression; })};
+  if (member == m_expressions.end()) {
+    return false;
+  }
+  const auto column{static_cast<std::size_t>(member - m_expressions.begin())};
+  const double* values{m_values.data() + column * m_count};
+
+  for (std::size_t i = 0; i < count; ++i) {
+    // Grid points are exact multiples of the power-of-two step.
+    const double k{x[i] / m_step};
+    const double index{k - static_cast<double>(m_first)};
+    if (k != std::floor(k) || index < 0.0 || index >= static_cast<double>(m_count)) {
+      return false;
+    }
+    const auto point{static_cast<std::size_t>(index)};
+    const std::size_t block{point / BLOCK_POINTS};
+    std::call_once(m_filled[block], [this, block] { fill_block(block); });
+    y[i] = values[point];
+  }
+  return true;
+}
+
+void GridSweep::fill_block(std::size_t block) {
+  APP_PROFILE_FUNCTION();
+
+  const std::size_t begin{block * BLOCK_POINTS};
+  const std::size_t size{std::min(BLOCK_POINTS, m_count - begin)};
+  std::array<double, BLOCK_POINTS> xs{};
+  for (std::size_t i = 0; i < size; ++i) {
+    xs[i] = static_cast<double>(m_first + static_cast<std::int64_t>(begin + i)) * m_step;
+  }
+  m_program.evaluate(xs.data(), size, m_values.data() + begin, m_count);
+}
+
+}  // namespace App::Core
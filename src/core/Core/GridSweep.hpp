@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Core/BatchExpression.hpp"
+#include "Core/CompiledExpression.hpp"
+
+namespace App::Core {
+
+// Values of several explicit functions on the SampleCache grid of one view, shared by their
+// background updates.
+//
+// Every plotted function samples the same grid points x = k * step. Instead of each update
+// evaluating its own function over its own copy of the grid, the bytecode of all batched
+// functions is fused into one BatchProgram (see there) and evaluated once per block of grid
+// points into a column-major matrix: one column per function. Blocks are computed on first use,
+// by whichever update needs them first, for all functions at once; so a pan still only
+// evaluates the newly exposed columns, and the other updates just copy their column.
+//
+// The sweep is immutable apart from that lazy fill and safe to use from any thread.
+class GridSweep {
+ public:
+  // Grid points per lazily computed block.
+  static constexpr std::size_t BLOCK_POINTS{256};
+
+  // Sweep of the grid SampleCache uses for [xmin, xmax] at `pixels_per_unit`. All expressions
+  // must be batched, explicit and valid.
+  GridSweep(std::vector<std::shared_ptr<CompiledExpression>> expressions,
+      double xmin,
+      double xmax,
+      double pixels_per_unit);
+
+  // True if the sweep covers exactly these expressions (in order), at the current values of
+  // their parameters, and this grid.
+  [[nodiscard]] bool matches(std::span<const std::shared_ptr<CompiledExpression>> expressions,
+      double xmin,
+      double xmax,
+      double pixels_per_unit) const;
+
+  // Copies the values of `expression` at `x` into `y`. Returns false, leaving `y` unspecified,
+  // if the expression is not part of the sweep or some x is not one of its grid points; the
+  // caller then evaluates them itself.
+  bool lookup(const CompiledExpression* expression, const double* x, double* y, std::size_t count);
+
+ private:
+  void fill_block(std::size_t block);
+
+  std::vector<std::shared_ptr<CompiledExpression>> m_expressions;
+  BatchProgram m_program;
+  std::uint64_t m_revision{0};  // sum of the parameter revisions of the expressions
+  double m_step;
+  std::int64_t m_first;
+  std::size_t m_count;
+
+  // m_values[column * m_count + i] is the value of column's function at grid point first + i.
+  std::vector<double> m_values;
+  std::unique_ptr<std::once_flag[]> m_filled;  // NOLINT(*-avoid-c-arrays): once_flag cannot move
+};
+
+}  // namespace App::Core
@@ -0,0 +1,446 @@
+#include "ImplicitPlot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Interval.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace App::Core {
+
+namespace {
+
+using Segment = ImplicitPlot::Segment;
+using Box = ImplicitPlot::Box;
+
+// Coarse cells per tile side, and grid points.
+constexpr int CELLS{ImplicitPlot::TILE_PIXELS / ImplicitPlot::COARSE_PIXELS};
+constexpr int POINTS{CELLS + 1};
+
+struct Cell {
+  double x0;
+  double y0;
+  double size;
+  // Corner values minus the level: bottom-left, bottom-right, top-right, top-left.
+  std::array<double, 4> values;
+};
+
+class Contourer {
+ public:
+  Contourer(const ImplicitPlot::Function& function,
+      const ImplicitPlot::Bounds& bounds,
+      double level,
+      bool fill,
+      double leaf,
+      std::vector<Segment>& segments,
+      std::vector<Box>& regions)
+      : m_function(function),
+        m_bounds(bounds),
+        m_level(level),
+        m_fill(fill),
+        m_leaf(leaf),
+        m_segments(segments),
+        m_regions(regions) {}
+
+  void refine(const Cell& cell) {
+    const auto& v{cell.values};
+    const int finite{static_cast<int>(std::count_if(
+        v.begin(), v.end(), [](double value) { return std::isfinite(value); }))};
+    const int positive{static_cast<int>(
+        std::count_if(v.begin(), v.end(), [](double value) { return value > 0.0; }))};
+
+    if (finite == 0) {
+      return;
+    }
+
+    const bool crosses{finite < 4 || (positive > 0 && positive < finite)};
+    if (!crosses && !may_cross(cell)) {
+      if (m_fill && positive == 4) {
+        m_regions.push_back({cell.x0, cell.y0, cell.x0 + cell.size, cell.y0 + cell.size});
+      }
+      return;
+    }
+
+    if (cell.size <= m_leaf) {
+      march(cell);
+      return;
+    }
+
+    // Split into four quadrants, evaluating the five new points in one call.
+    const double half{cell.size * 0.5};
+    const double x0{cell.x0};
+    const double y0{cell.y0};
+    const std::array<double, 5> xs{x0 + half, x0 + cell.size, x0 + half, x0, x0 + half};
+    const std::array<double, 5> ys{y0, y0 + half, y0 + cell.size, y0 + half, y0 + half};
+    std::array<double, 5> values{};
+    evaluate(xs.data(), ys.data(), values.data(), values.size());
+
+    const double bottom{values[0]};
+    const double right{values[1]};
+    const double top{values[2]};
+    const double left{values[3]};
+    const double center{values[4]};
+
+    refine({x0, y0, half, {v[0], bottom, center, left}});
+    refine({x0 + half, y0, half, {bottom, v[1], right, center}});
+    refine({x0 + half, y0 + half, half, {center, right, v[2], top}});
+    refine({x0, y0 + half, half, {left, center, top, v[3]}});
+  }
+
+  void evaluate(const double* x, const double* y, double* out, std::size_t count) const {
+    m_function(x, y, out, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      out[i] -= m_level;
+    }
+  }
+
+ private:
+  // Whether the curve may pass through a cell whose corners are all on one side of the level,
+  // as a loop or a spike smaller than the cell would. Only bounds of f over the cell can tell;
+  // without them, or at leaf size, the corners are trusted.
+  [[nodiscard]] bool may_cross(const Cell& cell) const {
+    if (m_bounds == nullptr || cell.size <= m_leaf) {
+      return false;
+    }
+    return m_bounds({cell.x0, cell.x0 + cell.size}, {cell.y0, cell.y0 + cell.size})
+        .contains(m_level);
+  }
+
+  // Marching squares on a leaf cell.
+  void march(const Cell& cell) {
+    const auto& v{cell.values};
+    if (!std::all_of(v.begin(), v.end(), [](double value) { return std::isfinite(value); })) {
+      return;
+    }
+
+    const double x0{cell.x0};
+    const double y0{cell.y0};
+    const double x1{cell.x0 + cell.size};
+    const double y1{cell.y0 + cell.size};
+
+    const auto crossing{[](double a, double b) { return a / (a - b); }};
+    // Edge points: bottom, right, top, left.
+    const std::array<Sample, 4> edges{{
+        {x0 + crossing(v[0], v[1]) * cell.size, y0},
+        {x1, y0 + crossing(v[1], v[2]) * cell.size},
+        {x1 - crossing(v[2], v[3]) * cell.size, y1},
+        {x0, y1 - crossing(v[3], v[0]) * cell.size},
+    }};
+
+    int index{0};
+    for (std::size_t i = 0; i < 4; ++i) {
+      if (v[i] > 0.0) {
+        index |= 1 << i;
+      }
+    }
+
+    double center{0.0};
+    const bool saddle{index == 5 || index == 10};
+    if (saddle || m_fill) {
+      const double cx{x0 + cell.size * 0.5};
+      const double cy{y0 + cell.size * 0.5};
+      evaluate(&cx, &cy, &center, 1);
+    }
+
+    const auto add{[this, &edges](std::size_t a, std::size_t b) {
+      m_segments.push_back({edges[a], edges[b]});
+    }};
+
+    switch (index) {
+      case 1:
+      case 14:
+        add(3, 0);
+        break;
+      case 2:
+      case 13:
+        add(0, 1);
+        break;
+      case 3:
+      case 12:
+        add(3, 1);
+        break;
+      case 4:
+      case 11:
+        add(1, 2);
+        break;
+      case 6:
+      case 9:
+        add(0, 2);
+        break;
+      case 7:
+      case 8:
+        add(3, 2);
+        break;
+      case 5:
+        // Corners 0 and 2 are positive; the center tells whether they are connected.
+        if (center > 0.0) {
+          add(0, 1);
+          add(2, 3);
+        } else {
+          add(3, 0);
+          add(1, 2);
+        }
+        break;
+      case 10:
+        if (center > 0.0) {
+          add(3, 0);
+          add(1, 2);
+        } else {
+          add(0, 1);
+          add(2, 3);
+        }
+        break;
+      default:
+        break;
+    }
+
+    if (m_fill && center > 0.0) {
+      m_regions.push_back({x0, y0, x1, y1});
+    }
+  }
+
+  const ImplicitPlot::Function& m_function;
+  const ImplicitPlot::Bounds& m_bounds;
+  double m_level;
+  bool m_fill;
+  double m_leaf;
+  std::vector<Segment>& m_segments;
+  std::vector<Box>& m_regions;
+};
+
+// Settles the coarse cells of a tile that bounds of f prove cannot reach the level: they are
+// skipped, or filled whole where f is above the level all over them. The others are marked
+// open for sampling. Squares of cells are tested from the whole tile down, so a tile the curve
+// does not enter costs a single bounds evaluation.
+class Culler {
+ public:
+  Culler(const ImplicitPlot::Bounds& bounds,
+      double level,
+      bool fill,
+      double x0,
+      double y0,
+      double cell_size,
+      std::array<bool, CELLS * CELLS>& open,
+      std::vector<Box>& regions)
+      : m_bounds(bounds),
+        m_level(level),
+        m_fill(fill),
+        m_x0(x0),
+        m_y0(y0),
+        m_cell_size(cell_size),
+        m_open(open),
+        m_regions(regions) {}
+
+  // The square of `span` x `span` cells from cell (i, j).
+  void cull(int i, int j, int span) {
+    const double x0{m_x0 + i * m_cell_size};
+    const double y0{m_y0 + j * m_cell_size};
+    const double x1{x0 + span * m_cell_size};
+    const double y1{y0 + span * m_cell_size};
+    const Interval value{m_bounds({x0, x1}, {y0, y1})};
+
+    if (!value.contains(m_level)) {
+      const bool above{!value.is_empty() && value.lo > m_level};
+      if (!m_fill || !above) {
+        return;
+      }
+      if (value.defined) {
+        m_regions.push_back({x0, y0, x1, y1});
+        return;
+      }
+      // Above the level where defined: sampling finds the parts to fill.
+    }
+
+    if (span == 1) {
+      m_open[static_cast<std::size_t>(j * CELLS + i)] = true;
+      return;
+    }
+    const int half{span / 2};
+    cull(i, j, half);
+    cull(i + half, j, half);
+    cull(i, j + half, half);
+    cull(i + half, j + half, half);
+  }
+
+ private:
+  const ImplicitPlot::Bounds& m_bounds;
+  double m_level;
+  bool m_fill;
+  double m_x0;
+  double m_y0;
+  double m_cell_size;
+  std::array<bool, CELLS * CELLS>& m_open;
+  std::vector<Box>& m_regions;
+};
+
+}  // namespace
+
+std::size_t ImplicitPlot::update(const Function& function,
+    double xmin,
+    double xmax,
+    double ymin,
+    double ymax,
+    double pixels_per_unit,
+    double level,
+    bool fill,
+    ThreadPool* pool,
+    const Bounds& bounds) {
+  if (!(pixels_per_unit > 0.0) || !(xmax > xmin) || !(ymax > ymin)) {
+    invalidate();
+    return 0;
+  }
+
+  // Same dyadic pixel grid as the explicit sampler.
+  const double tile_size{SampleCache::step_for(pixels_per_unit) * TILE_PIXELS};
+  if (tile_size != m_tile_size || level != m_level || fill != m_fill) {
+    m_tiles.clear();
+    m_tile_size = tile_size;
+    m_level = level;
+    m_fill = fill;
+    m_last = {-1, -1};
+  }
+
+  const TileIndex first{static_cast<std::int64_t>(std::floor(xmin / tile_size)),
+      static_cast<std::int64_t>(std::floor(ymin / tile_size))};
+  const TileIndex last{static_cast<std::int64_t>(std::floor(xmax / tile_size)),
+      static_cast<std::int64_t>(std::floor(ymax / tile_size))};
+  if (first == m_first && last == m_last) {
+    return 0;
+  }
+  m_first = first;
+  m_last = last;
+
+  APP_PROFILE_SCOPE("ImplicitPlot::update");
+
+  // Drop tiles that left the view, then compute the missing ones.
+  std::erase_if(m_tiles, [&first, &last](const auto& entry) {
+    const TileIndex& index{entry.first};
+    return index.first < first.first || index.first > last.first ||
+           index.second < first.second || index.second > last.second;
+  });
+
+  std::vector<TileIndex> missing;
+  for (std::int64_t i = first.first; i <= last.first; ++i) {
+    for (std::int64_t j = first.second; j <= last.second; ++j) {
+      if (!m_tiles.contains({i, j})) {
+        missing.emplace_back(i, j);
+      }
+    }
+  }
+
+  std::vector<Tile> computed(missing.size());
+  const auto compute{
+      [&](std::size_t n) { compute_tile(function, bounds, missing[n], computed[n]); }};
+  if (pool != nullptr) {
+    pool->parallel_for(missing.size(), compute);
+  } else {
+    for (std::size_t n = 0; n < missing.size(); ++n) {
+      compute(n);
+    }
+  }
+
+  for (std::size_t n = 0; n < missing.size(); ++n) {
+    m_tiles.emplace(missing[n], std::move(computed[n]));
+  }
+
+  m_segments.clear();
+  m_regions.clear();
+  for (const auto& [index, tile] : m_tiles) {
+    m_segments.insert(m_segments.end(), tile.segments.begin(), tile.segments.end());
+    m_regions.insert(m_regions.end(), tile.regions.begin(), tile.regions.end());
+  }
+
+  return missing.size();
+}
+
+void ImplicitPlot::compute_tile(const Function& function,
+    const Bounds& bounds,
+    const TileIndex& index,
+    Tile& tile) const {
+  const double cell_size{m_tile_size / CELLS};
+  const double leaf{m_tile_size * LEAF_PIXELS / TILE_PIXELS};
+  const double x0{static_cast<double>(index.first) * m_tile_size};
+  const double y0{static_cast<double>(index.second) * m_tile_size};
+
+  std::array<bool, CELLS * CELLS> open{};
+  if (bounds == nullptr) {
+    open.fill(true);
+  } else {
+    Culler{bounds, m_level, m_fill, x0, y0, cell_size, open, tile.regions}.cull(0, 0, CELLS);
+  }
+
+  // Corners of the open cells, evaluated in one batch.
+  std::array<bool, POINTS * POINTS> needed{};
+  for (int j = 0; j < CELLS; ++j) {
+    for (int i = 0; i < CELLS; ++i) {
+      if (open[static_cast<std::size_t>(j * CELLS + i)]) {
+        for (const int corner : {j * POINTS + i, j * POINTS + i + 1, (j + 1) * POINTS + i,
+                 (j + 1) * POINTS + i + 1}) {
+          needed[static_cast<std::size_t>(corner)] = true;
+        }
+      }
+    }
+  }
+
+  std::array<double, POINTS * POINTS> xs{};
+  std::array<double, POINTS * POINTS> ys{};
+  std::array<double, POINTS * POINTS> values{};
+  std::array<std::size_t, POINTS * POINTS> slots{};
+  std::size_t count{0};
+  for (int j = 0; j < POINTS; ++j) {
+    for (int i = 0; i < POINTS; ++i) {
+      const auto n{static_cast<std::size_t>(j * POINTS + i)};
+      if (needed[n]) {
+        xs[count] = x0 + i * cell_size;
+        ys[count] = y0 + j * cell_size;
+        slots[n] = count++;
+      }
+    }
+  }
+  if (count == 0) {
+    return;
+  }
+
+  Contourer contourer{function, bounds, m_level, m_fill, leaf, tile.segments, tile.regions};
+  contourer.evaluate(xs.data(), ys.data(), values.data(), count);
+
+  const auto at{[&values, &slots](int i, int j) {
+    return values[slots[static_cast<std::size_t>(j * POINTS + i)]];
+  }};
+  for (int j = 0; j < CELLS; ++j) {
+    for (int i = 0; i < CELLS; ++i) {
+      if (!open[static_cast<std::size_t>(j * CELLS + i)]) {
+        continue;
+      }
+      contourer.refine({x0 + i * cell_size,
+          y0 + j * cell_size,
+          cell_size,
+          {at(i, j), at(i + 1, j), at(i + 1, j + 1), at(i, j + 1)}});
+    }
+  }
+}
+
+void ImplicitPlot::invalidate() {
+  m_tiles.clear();
+  m_segments.clear();
+  m_regions.clear();
+  m_tile_size = 0.0;
+  m_first = {0, 0};
+  m_last = {-1, -1};
+}
+
+const std::vector<ImplicitPlot::Segment>& ImplicitPlot::segments() const {
+  return m_segments;
+}
+
+const std::vector<ImplicitPlot::Box>& ImplicitPlot::regions() const {
+  return m_regions;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Core/Interval.hpp"
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+class ThreadPool;
+
+// Contours of an implicit relation f(x, y) = level, plus optional filled regions f > level.
+//
+// The view is covered by square tiles at dyadic world positions (about 64 px wide). Each tile
+// samples a coarse grid and refines only the cells whose corners disagree on the side of the
+// level (a quadtree down to ~2 px leaves), where marching squares produces the line segments.
+// With interval bounds of f, squares of coarse cells they prove to be entirely on one side of
+// the level are settled without sampling, so a sparse curve costs about one bounds evaluation
+// per empty tile; cells whose corners agree are still refined while their bounds contain the
+// level, which finds loops and spikes smaller than a coarse cell.
+// Tiles are computed in parallel and cached, so a pan only computes the newly exposed tiles;
+// the cache is dropped when the zoom level or the function changes.
+class ImplicitPlot {
+ public:
+  // Evaluates f at `count` points (x[i], y[i]).
+  using Function =
+      std::function<void(const double* x, const double* y, double* out, std::size_t count)>;
+  // Bounds of f over the box of x in `x` and y in `y`.
+  using Bounds = std::function<Interval(const Interval& x, const Interval& y)>;
+
+  struct Segment {
+    Sample a;
+    Sample b;
+  };
+
+  struct Box {
+    double x0;
+    double y0;
+    double x1;
+    double y1;
+  };
+
+  static constexpr int TILE_PIXELS{64};
+  static constexpr int COARSE_PIXELS{16};
+  static constexpr int LEAF_PIXELS{2};
+
+  // Brings the tiles in line with the view. `level` is the contour value (0 for equations,
+  // 0.5 for the 0/1 result of an inequality); `fill` also collects the boxes where f > level.
+  // `bounds` is optional. Returns the number of tiles that had to be computed.
+  std::size_t update(const Function& function,
+      double xmin,
+      double xmax,
+      double ymin,
+      double ymax,
+      double pixels_per_unit,
+      double level,
+      bool fill,
+      ThreadPool* pool = nullptr,
+      const Bounds& bounds = nullptr);
+  void invalidate();
+
+  [[nodiscard]] const std::vector<Segment>& segments() const;
+  [[nodiscard]] const std::vector<Box>& regions() const;
+
+ private:
+  struct Tile {
+    std::vector<Segment> segments;
+    std::vector<Box> regions;
+  };
+
+  using TileIndex = std::pair<std::int64_t, std::int64_t>;
+
+  void compute_tile(const Function& function,
+      const Bounds& bounds,
+      const TileIndex& index,
+      Tile& tile) const;
+
+  double m_tile_size{0.0};
+  double m_level{0.0};
+  bool m_fill{false};
+  TileIndex m_first{0, 0};
+  TileIndex m_last{-1, -1};
+  std::map<TileIndex, Tile> m_tiles;
+
+  std::vector<Segment> m_segments;
+  std::vector<Box> m_regions;
+};
+
+}  // namespace App::Core
@@ -0,0 +1,312 @@
+#include "Interval.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <numbers>
+
+#include "Core/BatchExpression.hpp"
+
+namespace App::Core {
+
+namespace {
+
+using Op = BatchExpression::Op;
+
+constexpr double INF{std::numeric_limits<double>::infinity()};
+constexpr double TWO_PI{2.0 * std::numbers::pi};
+
+// Outward rounding. libm functions are accurate to a couple of ulps, so bounds computed from
+// them are widened by a few ulps (relative) on each side.
+constexpr double ROUNDING{8.0 * std::numeric_limits<double>::epsilon()};
+
+double round_down(double value) {
+  return value - std::fabs(value) * ROUNDING - std::numeric_limits<double>::denorm_min();
+}
+
+double round_up(double value) {
+  return value + std::fabs(value) * ROUNDING + std::numeric_limits<double>::denorm_min();
+}
+
+// Finishes an inexact result: rounds it outward and marks it possibly undefined if a bound
+// overflowed. NaN bounds (inf - inf, 0 * inf) mean nothing is known.
+Interval outward(Interval value) {
+  if (std::isnan(value.lo) || std::isnan(value.hi)) {
+    return Interval::whole();
+  }
+  if (!std::isfinite(value.lo) || !std::isfinite(value.hi)) {
+    value.defined = false;
+  }
+  value.lo = round_down(value.lo);
+  value.hi = round_up(value.hi);
+  return value;
+}
+
+// Exact results (negation, floor, min, ...) only need the overflow check.
+Interval exact(Interval value) {
+  if (!std::isfinite(value.lo) || !std::isfinite(value.hi)) {
+    value.defined = false;
+  }
+  return value;
+}
+
+Interval hull(std::initializer_list<double> values, bool defined) {
+  Interval result{INF, -INF, defined};
+  for (const double value : values) {
+    if (std::isnan(value)) {
+      return Interval::whole();
+    }
+    result.lo = std::min(result.lo, value);
+    result.hi = std::max(result.hi, value);
+  }
+  return outward(result);
+}
+
+double sgn(double value) {
+  if (value > 0.0) {
+    return 1.0;
+  }
+  if (value < 0.0) {
+    return -1.0;
+  }
+  return 0.0;
+}
+
+// Whether [lo, hi] may contain offset + k * period for an integer k. Arguments of periodic
+// functions can be large, so the test is done with some slack rather than risk missing one.
+bool hits_periodic(const Interval& a, double offset, double period) {
+  const double slack{1e-9 * std::max(1.0, std::max(std::fabs(a.lo), std::fabs(a.hi)))};
+  const double k{std::ceil((a.lo - slack - offset) / period)};
+  return offset + k * period <= a.hi + slack;
+}
+
+// sin and cos: their values at the ends, or 1 and -1 where the interval reaches a peak.
+template <typename Function>
+Interval periodic(const Interval& a, Function f, double max_at, double min_at) {
+  if (!(a.hi - a.lo < TWO_PI)) {
+    return {-1.0, 1.0, a.defined};
+  }
+  const double fa{f(a.lo)};
+  const double fb{f(a.hi)};
+  Interval result{hull({fa, fb}, a.defined)};
+  if (hits_periodic(a, max_at, TWO_PI)) {
+    result.hi = 1.0;
+  }
+  if (hits_periodic(a, min_at, TWO_PI)) {
+    result.lo = -1.0;
+  }
+  result.lo = std::max(result.lo, -1.0);
+  result.hi = std::min(result.hi, 1.0);
+  return result;
+}
+
+Interval multiply(const Interval& a, const Interval& b) {
+  return hull({a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi}, a.defined && b.defined);
+}
+
+Interval divide(const Interval& a, const Interval& b) {
+  if (b.lo == 0.0 && b.hi == 0.0) {
+    return Interval::empty();
+  }
+  if (b.lo <= 0.0 && b.hi >= 0.0) {
+    return Interval::whole();  // a pole inside
+  }
+  return hull({a.lo / b.lo, a.lo / b.hi, a.hi / b.lo, a.hi / b.hi}, a.defined && b.defined);
+}
+
+// |a| over a.
+Interval magnitude(const Interval& a) {
+  if (a.lo >= 0.0) {
+    return a;
+  }
+  if (a.hi <= 0.0) {
+    return {-a.hi, -a.lo, a.defined};
+  }
+  return {0.0, std::max(-a.lo, a.hi), a.defined};
+}
+
+// a^n for an integer n: monotonic in |a| for even n and in a for odd n.
+Interval integer_power(const Interval& a, double n) {
+  if (n < 0.0) {
+    return divide(Interval::point(1.0), integer_power(a, -n));
+  }
+  if (std::fmod(n, 2.0) == 0.0) {
+    const Interval abs{magnitude(a)};
+    return hull({std::pow(abs.lo, n), std::pow(abs.hi, n)}, a.defined);
+  }
+  return hull({std::pow(a.lo, n), std::pow(a.hi, n)}, a.defined);
+}
+
+Interval power(const Interval& a, const Interval& b) {
+  if (b.lo == b.hi) {
+    const double n{b.lo};
+    if (n == 0.0) {
+      return Interval::point(1.0);  // pow(x, 0) is 1 for any x, even NaN
+    }
+    if (std::nearbyint(n) == n && std::fabs(n) < 0x1p53) {
+      return integer_power(a, n);
+    }
+  }
+  // A negative base has a power wherever the exponent is an integer, which varying exponents
+  // pass through.
+  if (a.lo < 0.0 && b.lo != b.hi) {
+    return Interval::whole();
+  }
+  // Otherwise pow is only defined for a non-negative base, where it is monotonic in each
+  // argument on each side of 1 and 0, so its extremes are at the corners.
+  if (a.hi < 0.0) {
+    return Interval::empty();
+  }
+  const bool defined{a.defined && b.defined && a.lo >= 0.0};
+  const double lo{std::max(a.lo, 0.0)};
+  return hull({std::pow(lo, b.lo), std::pow(lo, b.hi), std::pow(a.hi, b.lo), std::pow(a.hi, b.hi)},
+      defined);
+}
+
+// fmod(a, b) has the sign of a and is smaller in magnitude than both a and b.
+Interval modulo(const Interval& a, const Interval& b) {
+  const double m{std::max(std::fabs(b.lo), std::fabs(b.hi))};
+  const bool defined{a.defined && b.defined && !b.contains(0.0)};
+  if (m == 0.0) {
+    return Interval::empty();
+  }
+  return exact(
+      {a.lo >= 0.0 ? 0.0 : std::max(a.lo, -m), a.hi <= 0.0 ? 0.0 : std::min(a.hi, m), defined});
+}
+
+// Functions of one argument that are non-decreasing on their domain [min, max], which the
+// argument is clipped to first.
+template <typename Function>
+Interval increasing(const Interval& a, Function f, double min = -INF, double max = INF) {
+  if (a.hi < min || a.lo > max) {
+    return Interval::empty();
+  }
+  const bool defined{a.defined && a.lo >= min && a.hi <= max};
+  return hull({f(std::max(a.lo, min)), f(std::min(a.hi, max))}, defined);
+}
+
+template <typename Function>
+Interval logarithm(const Interval& a, Function f) {
+  if (a.hi <= 0.0) {
+    return Interval::empty();
+  }
+  const bool defined{a.defined && a.lo > 0.0};
+  return hull({a.lo > 0.0 ? f(a.lo) : -INF, f(a.hi)}, defined);
+}
+
+}  // namespace
+
+Interval Interval::apply(Op op, const Interval& a, const Interval& b) {
+  // fmin and fmax return the other operand where one is NaN, so their result is not empty
+  // (and not bounded by the undefined operand) just because one operand is.
+  if (op == Op::Min || op == Op::Max) {
+    if (a.is_empty() || b.is_empty()) {
+      return a.is_empty() ? b : a;
+    }
+    const bool partial{!a.defined || !b.defined};
+    const double lo{op == Op::Min || partial ? std::min(a.lo, b.lo) : std::max(a.lo, b.lo)};
+    const double hi{op == Op::Max || partial ? std::max(a.hi, b.hi) : std::min(a.hi, b.hi)};
+    return exact({lo, hi, a.defined || b.defined});
+  }
+
+  const bool binary{op == Op::Add || op == Op::Sub || op == Op::Mul || op == Op::Div
+                    || op == Op::Mod || op == Op::Pow || op == Op::Atan2 || op == Op::Hypot};
+  if (a.is_empty() || (binary && b.is_empty())) {
+    return op == Op::Pow && b.lo == 0.0 && b.hi == 0.0 ? Interval::point(1.0) : Interval::empty();
+  }
+
+  switch (op) {
+    case Op::Add:
+      return outward({a.lo + b.lo, a.hi + b.hi, a.defined && b.defined});
+    case Op::Sub:
+      return outward({a.lo - b.hi, a.hi - b.lo, a.defined && b.defined});
+    case Op::Mul:
+      return multiply(a, b);
+    case Op::Div:
+      return divide(a, b);
+    case Op::Mod:
+      return modulo(a, b);
+    case Op::Pow:
+      return power(a, b);
+    case Op::Neg:
+      return {-a.hi, -a.lo, a.defined};
+    case Op::Sin:
+      return periodic(
+          a, [](double v) { return std::sin(v); }, std::numbers::pi / 2.0, -std::numbers::pi / 2.0);
+    case Op::Cos:
+      return periodic(a, [](double v) { return std::cos(v); }, 0.0, std::numbers::pi);
+    case Op::Tan:
+      if (!(a.hi - a.lo < std::numbers::pi)
+          || hits_periodic(a, std::numbers::pi / 2.0, std::numbers::pi)) {
+        return Interval::whole();
+      }
+      return hull({std::tan(a.lo), std::tan(a.hi)}, a.defined);
+    case Op::Asin:
+      return increasing(a, [](double v) { return std::asin(v); }, -1.0, 1.0);
+    case Op::Acos: {
+      const Interval negated{increasing(
+          {-a.hi, -a.lo, a.defined}, [](double v) { return std::asin(v); }, -1.0, 1.0)};
+      if (negated.is_empty()) {
+        return negated;
+      }
+      // acos(x) = pi/2 - asin(x)
+      return outward({std::numbers::pi / 2.0 + negated.lo,
+          std::numbers::pi / 2.0 + negated.hi,
+          negated.defined});
+    }
+    case Op::Atan:
+      return increasing(a, [](double v) { return std::atan(v); });
+    case Op::Sinh:
+      return increasing(a, [](double v) { return std::sinh(v); });
+    case Op::Cosh: {
+      const Interval abs{magnitude(a)};
+      return hull({std::cosh(abs.lo), std::cosh(abs.hi)}, a.defined);
+    }
+    case Op::Tanh:
+      return increasing(a, [](double v) { return std::tanh(v); });
+    case Op::Exp:
+      return increasing(a, [](double v) { return std::exp(v); });
+    case Op::Log:
+      return logarithm(a, [](double v) { return std::log(v); });
+    case Op::Log10:
+      return logarithm(a, [](double v) { return std::log10(v); });
+    case Op::Log2:
+      return logarithm(a, [](double v) { return std::log2(v); });
+    case Op::Sqrt:
+      return increasing(a, [](double v) { return std::sqrt(v); }, 0.0);
+    case Op::Abs:
+      return exact(magnitude(a));
+    case Op::Floor:
+      return exact({std::floor(a.lo), std::floor(a.hi), a.defined});
+    case Op::Ceil:
+      return exact({std::ceil(a.lo), std::ceil(a.hi), a.defined});
+    case Op::Sgn:
+      return {sgn(a.lo), sgn(a.hi), a.defined};
+    case Op::Atan2:
+      // atan2(y, x) is continuous away from the negative x axis; with x > 0 it is monotonic
+      // in each argument, so its extremes are at the corners.
+      if (b.lo > 0.0) {
+        return hull({std::atan2(a.lo, b.lo),
+                        std::atan2(a.lo, b.hi),
+                        std::atan2(a.hi, b.lo),
+                        std::atan2(a.hi, b.hi)},
+            a.defined && b.defined);
+      }
+      return outward({-std::numbers::pi, std::numbers::pi, a.defined && b.defined});
+    case Op::Hypot: {
+      const Interval x{magnitude(a)};
+      const Interval y{magnitude(b)};
+      return hull({std::hypot(x.lo, y.lo), std::hypot(x.hi, y.hi)}, a.defined && b.defined);
+    }
+    case Op::Min:
+    case Op::Max:
+    case Op::Constant:
+    case Op::Variable:
+    case Op::Parameter:
+      break;
+  }
+  return a;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <limits>
+
+#include "Core/BatchExpression.hpp"
+
+namespace App::Core {
+
+// Closed interval for interval arithmetic: bounds of an expression over a range of its
+// variables, enough to prove that it cannot reach a value (a contour level, the visible band)
+// anywhere in a tile without sampling it.
+//
+// The bounds enclose every value the expression takes over the range; they are rounded
+// outward, so they may be wider but never narrower. `defined` is false if the expression may
+// also be undefined or infinite somewhere in the range (a domain error, a pole); where it is
+// undefined everywhere the interval is empty (lo > hi).
+struct Interval {
+  double lo;
+  double hi;
+  bool defined{true};
+
+  [[nodiscard]] static Interval point(double value) {
+    return {value, value, true};
+  }
+  // Any value, possibly none: what is known without looking.
+  [[nodiscard]] static Interval whole() {
+    return {-std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+        false};
+  }
+  [[nodiscard]] static Interval empty() {
+    return {std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+        false};
+  }
+
+  [[nodiscard]] bool is_empty() const {
+    return !(lo <= hi);
+  }
+  [[nodiscard]] bool contains(double value) const {
+    return lo <= value && value <= hi;
+  }
+
+  // Bounds of `op` (see BatchExpression) over operands within `a` and `b` (`b` is ignored by
+  // unary operations).
+  [[nodiscard]] static Interval apply(BatchExpression::Op op, const Interval& a, const Interval& b);
+};
+
+}  // namespace App::Core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <utility>
+
+namespace App {
+
+// Read-only memory map of a whole file; implemented per platform.
+//
+// The map covers the file as it was when opened. Other processes may keep appending to it;
+// open it again to map the data they added.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_mapping(std::exchange(other.m_mapping, nullptr)) {}
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_mapping = std::exchange(other.m_mapping, nullptr);
+    }
+    return *this;
+  }
+
+  // Maps `path`, replacing any previous map. Returns false (and logs why) on failure; empty
+  // files map successfully with no data.
+  bool open(const std::filesystem::path& path);
+  void close();
+
+  [[nodiscard]] const char* data() const {
+    return m_data;
+  }
+  [[nodiscard]] std::size_t size() const {
+    return m_size;
+  }
+
+ private:
+  const char* m_data{nullptr};
+  std::size_t m_size{0};
+  void* m_mapping{nullptr};  // platform handle of the mapping, if it needs one
+};
+
+}  // namespace App
@@ -0,0 +1,98 @@
+#include "Parameters.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Core/Log.hpp"
+
+namespace App::Core {
+
+std::size_t Parameters::define(std::string_view name, double value) {
+  std::size_t id{NONE};
+  const std::size_t size{m_size.load(std::memory_order_relaxed)};
+  for (std::size_t i = 0; i < size; ++i) {
+    if (m_slots[i].name == name) {
+      id = i;
+      break;
+    }
+  }
+  if (id == NONE) {
+    if (size == MAX_PARAMETERS) {
+      APP_WARN("Cannot define parameter '{}': all {} parameters are in use", name, size);
+      return NONE;
+    }
+    id = size;
+    m_slots[id].name = name;
+  }
+
+  Slot& slot{m_slots[id]};
+  slot.value.store(value, std::memory_order_relaxed);
+  slot.defined.store(true, std::memory_order_relaxed);
+  bump(slot);
+  if (id == size) {
+    m_size.store(size + 1, std::memory_order_release);
+  }
+  return id;
+}
+
+void Parameters::undefine(std::size_t id) {
+  if (id >= size() || !is_defined(id)) {
+    return;
+  }
+  m_slots[id].defined.store(false, std::memory_order_relaxed);
+  bump(m_slots[id]);
+}
+
+void Parameters::set(std::size_t id, double value) {
+  if (id >= size() || m_slots[id].value.load(std::memory_order_relaxed) == value) {
+    return;
+  }
+  m_slots[id].value.store(value, std::memory_order_relaxed);
+  bump(m_slots[id]);
+}
+
+std::size_t Parameters::find(std::string_view name) const {
+  const std::size_t count{size()};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (m_slots[i].name == name) {
+      return is_defined(i) ? i : NONE;
+    }
+  }
+  return NONE;
+}
+
+bool Parameters::is_defined(std::size_t id) const {
+  return m_slots[id].defined.load(std::memory_order_acquire);
+}
+
+const std::string& Parameters::name(std::size_t id) const {
+  return m_slots[id].name;
+}
+
+double Parameters::value(std::size_t id) const {
+  return m_slots[id].value.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Parameters::revision(std::size_t id) const {
+  return m_slots[id].revision.load(std::memory_order_acquire);
+}
+
+std::uint64_t Parameters::revision() const {
+  return m_revision.load(std::memory_order_acquire);
+}
+
+std::size_t Parameters::size() const {
+  return m_size.load(std::memory_order_acquire);
+}
+
+// Revisions are released after the value, so a reader that sees a new revision also sees the
+// value it stands for.
+void Parameters::bump(Slot& slot) {
+  slot.revision.fetch_add(1, std::memory_order_release);
+  m_revision.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace App::Core
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace App::Core {
+
+// Named values (`a`, `b`, `k`, ...) that expressions read by reference.
+//
+// Expressions bind to a parameter when they are compiled and read its current value whenever
+// they evaluate, so changing a value never recompiles anything; it only bumps the parameter's
+// revision, which tells the sampling caches of the expressions using it to start over.
+//
+// Ids are stable for the table's lifetime: a name keeps its slot even while undefined, so
+// redefining it gets the same id back. Definitions and values are set on one thread (the UI);
+// lookups, values and revisions can be read from any thread.
+class Parameters {
+ public:
+  static constexpr std::size_t MAX_PARAMETERS{64};
+  static constexpr std::size_t NONE{static_cast<std::size_t>(-1)};
+
+  // Defines `name` with `value` and returns its id, or NONE if the table is full.
+  std::size_t define(std::string_view name, double value);
+  void undefine(std::size_t id);
+  void set(std::size_t id, double value);
+
+  // Id of the defined parameter `name`, or NONE.
+  [[nodiscard]] std::size_t find(std::string_view name) const;
+  [[nodiscard]] bool is_defined(std::size_t id) const;
+  [[nodiscard]] const std::string& name(std::size_t id) const;
+  [[nodiscard]] double value(std::size_t id) const;
+  // Increases with every change of the parameter's value or definition.
+  [[nodiscard]] std::uint64_t revision(std::size_t id) const;
+  // Increases with every change of any parameter.
+  [[nodiscard]] std::uint64_t revision() const;
+  // Number of slots ever used; ids are below it.
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  struct Slot {
+    std::string name;  // written once, before the slot is published through m_size
+    std::atomic<double> value{0.0};
+    std::atomic<std::uint64_t> revision{0};
+    std::atomic<bool> defined{false};
+  };
+
+  void bump(Slot& slot);
+
+  std::array<Slot, MAX_PARAMETERS> m_slots;
+  std::atomic<std::size_t> m_size{0};
+  std::atomic<std::uint64_t> m_revision{0};
+};
+
+}  // namespace App::Core
@@ -0,0 +1,153 @@
+#include "ParametricCurve.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace App::Core {
+
+namespace {
+
+bool is_finite(double x, double y) {
+  return std::isfinite(x) && std::isfinite(y);
+}
+
+}  // namespace
+
+std::size_t ParametricCurve::update(const Function& function,
+    double tmin,
+    double tmax,
+    double pixels_per_unit,
+    ThreadPool* pool) {
+  if (m_valid && tmin == m_tmin && tmax == m_tmax && pixels_per_unit == m_pixels_per_unit) {
+    return 0;
+  }
+
+  APP_PROFILE_FUNCTION();
+
+  m_valid = true;
+  m_tmin = tmin;
+  m_tmax = tmax;
+  m_pixels_per_unit = pixels_per_unit;
+  m_points.clear();
+  m_curve.clear();
+  if (!(tmax > tmin) || !(pixels_per_unit > 0.0)) {
+    return 0;
+  }
+
+  // Uniform start; t is computed from the index so the ends are exact.
+  for (std::size_t i = 0; i <= INITIAL_INTERVALS; ++i) {
+    const double u{static_cast<double>(i) / static_cast<double>(INITIAL_INTERVALS)};
+    m_points.push_back({tmin + (tmax - tmin) * u, 0.0, 0.0});
+  }
+  evaluate(function, m_points, pool);
+  std::size_t evaluated{m_points.size()};
+  m_active.assign(INITIAL_INTERVALS, 1);
+
+  for (int depth = 0; depth < MAX_DEPTH; ++depth) {
+    m_middles.clear();
+    for (std::size_t i = 0; i + 1 < m_points.size(); ++i) {
+      if (m_active[i] != 0) {
+        m_middles.push_back({(m_points[i].t + m_points[i + 1].t) * 0.5, 0.0, 0.0});
+      }
+    }
+    if (m_middles.empty() || m_points.size() + m_middles.size() > MAX_POINTS) {
+      break;
+    }
+    evaluate(function, m_middles, pool);
+    evaluated += m_middles.size();
+
+    // Merge the midpoints in and decide which halves keep splitting.
+    m_next.clear();
+    m_next_active.clear();
+    std::size_t middle{0};
+    for (std::size_t i = 0; i + 1 < m_points.size(); ++i) {
+      m_next.push_back(m_points[i]);
+      if (m_active[i] == 0) {
+        m_next_active.push_back(0);
+        continue;
+      }
+      const Point& mid{m_middles[middle++]};
+      const char split{needs_split(m_points[i], mid, m_points[i + 1]) ? char{1} : char{0}};
+      m_next.push_back(mid);
+      m_next_active.push_back(split);
+      m_next_active.push_back(split);
+    }
+    m_next.push_back(m_points.back());
+    m_points.swap(m_next);
+    m_active.swap(m_next_active);
+  }
+
+  m_curve.reserve(m_points.size());
+  for (const Point& point : m_points) {
+    m_curve.push_back({point.x, point.y});
+  }
+  return evaluated;
+}
+
+void ParametricCurve::invalidate() {
+  m_valid = false;
+}
+
+const std::vector<Sample>& ParametricCurve::curve() const {
+  return m_curve;
+}
+
+void ParametricCurve::evaluate(
+    const Function& function, std::vector<Point>& points, ThreadPool* pool) {
+  const auto evaluate_range{[&function, &points](std::size_t begin, std::size_t end) {
+    // Contiguous inputs and outputs for the batch path.
+    std::vector<double> t(end - begin);
+    std::vector<double> x(end - begin);
+    std::vector<double> y(end - begin);
+    for (std::size_t i = begin; i < end; ++i) {
+      t[i - begin] = points[i].t;
+    }
+    function(t.data(), x.data(), y.data(), t.size());
+    for (std::size_t i = begin; i < end; ++i) {
+      points[i].x = x[i - begin];
+      points[i].y = y[i - begin];
+    }
+  }};
+
+  if (pool == nullptr || points.size() <= CHUNK_SIZE) {
+    evaluate_range(0, points.size());
+    return;
+  }
+
+  const std::size_t chunk_count{(points.size() + CHUNK_SIZE - 1) / CHUNK_SIZE};
+  pool->parallel_for(chunk_count, [&points, &evaluate_range](std::size_t chunk) {
+    evaluate_range(chunk * CHUNK_SIZE, std::min(points.size(), (chunk + 1) * CHUNK_SIZE));
+  });
+}
+
+bool ParametricCurve::needs_split(const Point& a, const Point& middle, const Point& b) const {
+  const bool finite_a{is_finite(a.x, a.y)};
+  const bool finite_b{is_finite(b.x, b.y)};
+  const bool finite_middle{is_finite(middle.x, middle.y)};
+  if (!finite_a || !finite_b || !finite_middle) {
+    // Keep narrowing down where the curve starts or stops being defined.
+    return finite_a || finite_b || finite_middle;
+  }
+
+  const double dx{(b.x - a.x) * m_pixels_per_unit};
+  const double dy{(b.y - a.y) * m_pixels_per_unit};
+  const double chord{std::hypot(dx, dy)};
+  if (chord > MAX_CHORD_PX) {
+    return true;
+  }
+
+  // Distance of the midpoint from the chord segment; a curve that doubles back within the
+  // interval lands beyond its ends.
+  const double mx{(middle.x - a.x) * m_pixels_per_unit};
+  const double my{(middle.y - a.y) * m_pixels_per_unit};
+  const double along{chord > 0.0 ? std::clamp((mx * dx + my * dy) / (chord * chord), 0.0, 1.0)
+                                 : 0.0};
+  return std::hypot(mx - along * dx, my - along * dy) > TOLERANCE_PX;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+class ThreadPool;
+
+// Adaptive samples of a parametric curve (x(t), y(t)) over [tmin, tmax]; polar curves r(theta)
+// come in as (r cos theta, r sin theta).
+//
+// Uniform steps in t waste samples where the curve moves slowly and alias where it moves fast,
+// so sampling starts from a uniform grid and then bisects, level by level, every interval whose
+// chord is long on screen (arc length) or whose midpoint strays from the chord (curvature).
+// Intervals touching non-finite points keep bisecting to localize the gap. Each level is
+// evaluated as one batch across the pool.
+//
+// The result is in world space and does not depend on the view, only on the zoom (which sets
+// the pixel tolerances), so pans never resample.
+class ParametricCurve {
+ public:
+  // Evaluates the curve at `count` parameter values.
+  using Function =
+      std::function<void(const double* t, double* x, double* y, std::size_t count)>;
+
+  static constexpr std::size_t INITIAL_INTERVALS{512};
+  static constexpr int MAX_DEPTH{12};
+  static constexpr std::size_t MAX_POINTS{std::size_t{1} << 18};
+  // Largest chord and midpoint deviation an interval may keep without being split.
+  static constexpr double MAX_CHORD_PX{8.0};
+  static constexpr double TOLERANCE_PX{0.25};
+  static constexpr std::size_t CHUNK_SIZE{256};
+
+  // Resamples if the range, the zoom or the function (see invalidate()) changed. Returns the
+  // number of function evaluations.
+  std::size_t update(const Function& function,
+      double tmin,
+      double tmax,
+      double pixels_per_unit,
+      ThreadPool* pool = nullptr);
+  void invalidate();
+
+  // Points in order of t; non-finite ones mark gaps.
+  [[nodiscard]] const std::vector<Sample>& curve() const;
+
+ private:
+  struct Point {
+    double t;
+    double x;
+    double y;
+  };
+
+  // Fills x and y of `points` in chunks across the pool.
+  static void evaluate(const Function& function, std::vector<Point>& points, ThreadPool* pool);
+  [[nodiscard]] bool needs_split(const Point& a, const Point& middle, const Point& b) const;
+
+  bool m_valid{false};
+  double m_tmin{0.0};
+  double m_tmax{0.0};
+  double m_pixels_per_unit{0.0};
+
+  std::vector<Point> m_points;
+  std::vector<Point> m_next;
+  std::vector<Point> m_middles;
+  std::vector<char> m_active;  // per interval of m_points
+  std::vector<char> m_next_active;
+  std::vector<Sample> m_curve;
+};
+
+}  // namespace App::Core
@@ -0,0 +1,205 @@
+#include "PlotPipeline.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/CurveGeometry.hpp"
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Polyline.hpp"
+
+namespace App::Core {
+
+bool PlotPipeline::update(ExpressionList& functions,
+    const Viewport& viewport,
+    float thickness,
+    const ImDrawList* reference,
+    std::pmr::memory_resource* arena) {
+  APP_PROFILE_FUNCTION();
+
+  // Only recompiles if the text changed since the last frame. Hidden rows are compiled too, as
+  // their definitions still apply; a pass that changed the definitions is repeated, so rows
+  // before the defining one pick them up in the same frame.
+  for (int pass = 0; pass < 2; ++pass) {
+    const std::uint64_t definitions{functions.definitions()};
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+      functions.compile(i);
+    }
+    if (functions.definitions() == definitions) {
+      break;
+    }
+  }
+
+  m_plotted.clear();
+  for (std::size_t i = 0; i < functions.size(); ++i) {
+    const auto& compiled{functions.compiled[i]};
+    if (functions.visible[i] != 0 && compiled->is_valid() &&
+        compiled->kind() != CompiledExpression::Kind::Definition) {
+      m_plotted.push_back(i);
+    }
+  }
+
+  // Sampling runs in the background on the worker pool (roughly one sample per pixel column,
+  // refined where the curve bends, reusing cached samples). The curves are in world space, so
+  // the last finished one is drawn correctly even while a newer view is still being sampled.
+  // Implicit equations and regions are contoured tile by tile.
+  m_viewport = viewport;
+  m_view = AsyncCurve::padded_view(
+      viewport.xmin, viewport.xmax, viewport.ymin, viewport.ymax, viewport.pixels_per_unit);
+
+  // Batched explicit rows sample the same grid, so they share one fused evaluation of it per
+  // set of parameters they read.
+  for (auto& group : m_groups) {
+    group.members.clear();
+    group.rows.clear();
+  }
+  m_row_sweep.assign(functions.size(), nullptr);
+  for (const std::size_t i : m_plotted) {
+    const auto& compiled{functions.compiled[i]};
+    if (compiled->kind() != CompiledExpression::Kind::Explicit || !compiled->is_batched()) {
+      continue;
+    }
+    auto group{std::find_if(m_groups.begin(), m_groups.end(), [&](const SweepGroup& other) {
+      return other.parameters == compiled->parameters();
+    })};
+    if (group == m_groups.end()) {
+      group = m_groups.insert(m_groups.end(), {compiled->parameters(), {}, {}, nullptr});
+    }
+    group->members.push_back(compiled);
+    group->rows.push_back(i);
+  }
+  std::erase_if(m_groups, [](const SweepGroup& group) { return group.members.empty(); });
+
+  for (auto& group : m_groups) {
+    if (group.members.size() < 2) {
+      group.sweep.reset();
+      continue;
+    }
+    if (group.sweep == nullptr ||
+        !group.sweep->matches(
+            group.members, m_view.xmin, m_view.xmax, m_view.pixels_per_unit)) {
+      group.sweep = std::make_shared<GridSweep>(
+          group.members, m_view.xmin, m_view.xmax, m_view.pixels_per_unit);
+    }
+    for (const std::size_t i : group.rows) {
+      m_row_sweep[i] = group.sweep;
+    }
+  }
+
+  bool sampling{false};
+  for (const std::size_t i : m_plotted) {
+    functions.curve[i].request(functions.compiled[i], m_view, m_row_sweep[i]);
+    sampling = sampling || functions.curve[i].is_pending();
+  }
+
+  // The triangles are only rebuilt when the curve, style or padded view change; panning just
+  // translates them.
+  m_scratch._Data = reference->_Data;
+  m_scratch.Flags = reference->Flags;
+  for (const std::size_t i : m_plotted) {
+    functions.geometry[i].update(*functions.curve[i].latest(),
+        m_view,
+        functions.color[i],
+        thickness * functions.thickness[i],
+        m_scratch,
+        arena);
+  }
+
+  return sampling;
+}
+
+void PlotPipeline::draw(const ExpressionList& functions,
+    ImDrawList* draw_list,
+    const ImVec2& center) const {
+  // Both centers are close to each other, so their offset is small and exact enough for a
+  // float.
+  const double pixels_per_unit{m_viewport.pixels_per_unit};
+  const double dx{0.5 * ((m_view.xmin + m_view.xmax) - (m_viewport.xmin + m_viewport.xmax))};
+  const double dy{0.5 * ((m_viewport.ymin + m_viewport.ymax) - (m_view.ymin + m_view.ymax))};
+  const ImVec2 anchor{center.x + static_cast<float>(dx * pixels_per_unit),
+      center.y + static_cast<float>(dy * pixels_per_unit)};
+  for (const std::size_t i : m_plotted) {
+    functions.geometry[i].draw(draw_list, anchor);
+  }
+}
+
+const std::vector<std::size_t>& PlotPipeline::plotted() const {
+  return m_plotted;
+}
+
+void PlotPipeline::draw_data(const std::vector<DataRow>& rows,
+    const Viewport& viewport,
+    float thickness,
+    ImDrawList* draw_list,
+    const ImVec2& center,
+    std::pmr::memory_resource* arena) {
+  APP_PROFILE_FUNCTION();
+
+  // Relative to the viewport center before narrowing to float, as for the curves.
+  const double pixels_per_unit{viewport.pixels_per_unit};
+  const double center_x{0.5 * (viewport.xmin + viewport.xmax)};
+  const double center_y{0.5 * (viewport.ymin + viewport.ymax)};
+  const auto to_screen{[&](const Sample& sample) {
+    const double y{(center_y - sample.y) * pixels_per_unit};
+    return ImVec2(center.x + static_cast<float>((sample.x - center_x) * pixels_per_unit),
+        center.y + static_cast<float>(std::clamp(y,
+                       -CurveGeometry::MAX_SCREEN_COORDINATE,
+                       CurveGeometry::MAX_SCREEN_COORDINATE)));
+  }};
+  const auto half_height{
+      static_cast<float>(0.5 * (viewport.ymax - viewport.ymin) * pixels_per_unit)};
+  const float top{center.y - half_height - thickness};
+  const float bottom{center.y + half_height + thickness};
+
+  std::pmr::vector<Sample> samples{arena};
+  std::pmr::vector<ImVec2> points{arena};
+  std::pmr::vector<ImVec2> reduced{arena};
+  for (const auto& row : rows) {
+    if (!row.visible || row.series.empty()) {
+      continue;
+    }
+
+    samples.clear();
+    row.series.visible_points(viewport.xmin, viewport.xmax, pixels_per_unit, samples);
+    points.clear();
+    for (const auto& sample : samples) {
+      points.push_back(to_screen(sample));
+    }
+
+    reduced.clear();
+    Polyline::clip(points, top, bottom, reduced);
+    points.clear();
+    Polyline::simplify(reduced, Polyline::DEFAULT_TOLERANCE_PX, points);
+
+    Polyline::for_each_run(points, [&](const ImVec2* run, std::size_t size) {
+      for (std::size_t begin = 0; begin + 1 < size;
+           begin += CurveGeometry::MAX_POINTS_PER_CHUNK - 1) {
+        const std::size_t count{std::min(CurveGeometry::MAX_POINTS_PER_CHUNK, size - begin)};
+        draw_list->AddPolyline(
+            run + begin, static_cast<int>(count), row.color, ImDrawFlags_None, thickness);
+      }
+    });
+  }
+}
+
+ImU32 PlotPipeline::parse_color(const std::string& hex) {
+  unsigned int r{199};
+  unsigned int g{68};
+  unsigned int b{64};
+  unsigned int a{255};
+  if ((hex.size() == 7 || hex.size() == 9) && hex[0] == '#') {
+    // NOLINTNEXTLINE(cert-err34-c): malformed digits keep the defaults
+    std::sscanf(hex.c_str() + 1, "%02x%02x%02x%02x", &r, &g, &b, &a);
+  }
+  return IM_COL32(r, g, b, a);
+}
+
+}  // namespace App::Core
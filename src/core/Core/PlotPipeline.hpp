@@ -0,0 +1,94 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/DataSeries.hpp"
+#include "Core/GridSweep.hpp"
+#include "Core/expression.hpp"
+
+namespace App::Core {
+
+// The compile -> sample -> tessellate path of the graph view, independent of any window so it
+// can also be driven headlessly (see src/bench).
+class PlotPipeline {
+ public:
+  struct Viewport {
+    double xmin;
+    double xmax;
+    double ymin;
+    double ymax;
+    double pixels_per_unit;
+  };
+
+  // A loaded data file and how it is drawn.
+  struct DataRow {
+    DataSeries series;
+    ImU32 color;
+    // File name of `series`, shown in the list every frame; set once when the file is loaded.
+    std::string name;
+    bool visible{true};
+    // Polled for appended data every frame.
+    bool follow{false};
+  };
+
+  // Compiles edited rows, requests background sampling of the visible ones for (a padded
+  // version of) the viewport and refreshes their cached geometry from the latest finished
+  // curves. Returns true while any plotted row is still being sampled. `reference` is the draw
+  // list the rows are drawn into later; `arena` holds temporaries until the end of the frame.
+  bool update(ExpressionList& functions,
+      const Viewport& viewport,
+      float thickness,
+      const ImDrawList* reference,
+      std::pmr::memory_resource* arena);
+
+  // Appends the geometry of the rows plotted by the last update, with the center of its
+  // viewport at `center` (screen space).
+  void draw(const ExpressionList& functions,
+      ImDrawList* draw_list,
+      const ImVec2& center) const;
+
+  // Draws the visible data rows straight into `draw_list`, the viewport center at `center`.
+  // Each one only contributes the pyramid level matching the zoom, so this is rebuilt every
+  // frame at a cost bounded by the canvas width.
+  static void draw_data(const std::vector<DataRow>& rows,
+      const Viewport& viewport,
+      float thickness,
+      ImDrawList* draw_list,
+      const ImVec2& center,
+      std::pmr::memory_resource* arena);
+
+  // Rows plotted by the last update, in order.
+  [[nodiscard]] const std::vector<std::size_t>& plotted() const;
+
+  // "#RRGGBB" (opaque) or "#RRGGBBAA" to an ImU32; anything else gives the default curve color.
+  [[nodiscard]] static ImU32 parse_color(const std::string& hex);
+
+ private:
+  std::vector<std::size_t> m_plotted;
+  // Viewport and padded view of the last update; the geometry is relative to the latter's
+  // center.
+  Viewport m_viewport{0.0, 0.0, 0.0, 0.0, 0.0};
+  AsyncCurve::View m_view{0.0, 0.0, 0.0, 0.0, 0.0};
+  // Batched explicit rows reading the same parameters, and their shared grid evaluation. It is
+  // rebuilt when they, their parameter values or the view change, so changing a parameter
+  // only re-evaluates the rows that read it.
+  struct SweepGroup {
+    std::vector<std::size_t> parameters;
+    std::vector<std::shared_ptr<CompiledExpression>> members;
+    std::vector<std::size_t> rows;  // of the members
+    std::shared_ptr<GridSweep> sweep;
+  };
+  std::vector<SweepGroup> m_groups;
+  std::vector<std::shared_ptr<GridSweep>> m_row_sweep;  // per row, parallel to the rows
+  // Tessellation target shared by all rows, so rebuilding keeps its buffers.
+  ImDrawList m_scratch{nullptr};
+};
+
+}  // namespace App::Core
@@ -0,0 +1,253 @@
+#include "Polyline.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace App::Core {
+
+namespace {
+
+bool is_finite(const ImVec2& point) {
+  return std::isfinite(point.x) && std::isfinite(point.y);
+}
+
+// Squared distance from `point` to the segment [a, b].
+float distance_squared(const ImVec2& point, const ImVec2& a, const ImVec2& b) {
+  const float dx{b.x - a.x};
+  const float dy{b.y - a.y};
+  const float length_squared{dx * dx + dy * dy};
+
+  float t{0.0F};
+  if (length_squared > 0.0F) {
+    t = ((point.x - a.x) * dx + (point.y - a.y) * dy) / length_squared;
+    t = t < 0.0F ? 0.0F : (t > 1.0F ? 1.0F : t);
+  }
+  const float ex{a.x + t * dx - point.x};
+  const float ey{a.y + t * dy - point.y};
+  return ex * ex + ey * ey;
+}
+
+// -1, 0 or 1: the vertical direction of the segment from `a` to `b`.
+int direction(const ImVec2& a, const ImVec2& b) {
+  return (b.y > a.y ? 1 : 0) - (b.y < a.y ? 1 : 0);
+}
+
+// True if segment `i` (points[i] -> points[i + 1]) jumps across the band: both ends are beyond
+// opposite edges and no finite neighbour segment heads the same way, while at least one heads
+// the other way. A continuous steep curve keeps its direction through the band; a pole flips it.
+bool is_jump(std::span<const ImVec2> points, std::size_t i, float top, float bottom) {
+  const ImVec2& a{points[i]};
+  const ImVec2& b{points[i + 1]};
+  if (!((a.y < top && b.y > bottom) || (a.y > bottom && b.y < top))) {
+    return false;
+  }
+
+  const int heading{direction(a, b)};
+  bool reversed{false};
+  if (i > 0 && is_finite(points[i - 1])) {
+    const int before{direction(points[i - 1], a)};
+    if (before == heading) {
+      return false;
+    }
+    reversed = reversed || before == -heading;
+  }
+  if (i + 2 < points.size() && is_finite(points[i + 2])) {
+    const int after{direction(b, points[i + 2])};
+    if (after == heading) {
+      return false;
+    }
+    reversed = reversed || after == -heading;
+  }
+  return reversed;
+}
+
+ImVec2 lerp(const ImVec2& a, const ImVec2& b, float t) {
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+}
+
+}  // namespace
+
+void Polyline::decimate_columns(std::span<const ImVec2> points, std::pmr::vector<ImVec2>& out) {
+  std::size_t begin{0};
+  while (begin < points.size()) {
+    const float column{std::floor(points[begin].x)};
+
+    std::size_t end{begin + 1};
+    std::size_t lowest{begin};
+    std::size_t highest{begin};
+    while (end < points.size() && std::floor(points[end].x) == column) {
+      if (points[end].y < points[lowest].y) {
+        lowest = end;
+      }
+      if (points[end].y > points[highest].y) {
+        highest = end;
+      }
+      ++end;
+    }
+
+    const std::size_t last{end - 1};
+    if (lowest > highest) {
+      std::swap(lowest, highest);
+    }
+    out.push_back(points[begin]);
+    if (lowest != begin) {
+      out.push_back(points[lowest]);
+    }
+    if (highest != lowest && highest != begin) {
+      out.push_back(points[highest]);
+    }
+    if (last != highest && last != begin) {
+      out.push_back(points[last]);
+    }
+
+    begin = end;
+  }
+}
+
+void Polyline::simplify_rdp(
+    std::span<const ImVec2> points, float tolerance, std::pmr::vector<ImVec2>& out) {
+  if (points.size() <= 2) {
+    out.insert(out.end(), points.begin(), points.end());
+    return;
+  }
+
+  std::pmr::memory_resource* memory{out.get_allocator().resource()};
+  std::pmr::vector<char> keep(points.size(), 0, memory);
+  keep.front() = 1;
+  keep.back() = 1;
+
+  // Explicit stack of ranges instead of recursion, so long runs cannot overflow it.
+  std::pmr::vector<std::pair<std::size_t, std::size_t>> ranges{memory};
+  ranges.emplace_back(0, points.size() - 1);
+  const float tolerance_squared{tolerance * tolerance};
+
+  while (!ranges.empty()) {
+    const auto [first, last]{ranges.back()};
+    ranges.pop_back();
+
+    float farthest{0.0F};
+    std::size_t split{first};
+    for (std::size_t i = first + 1; i < last; ++i) {
+      const float distance{distance_squared(points[i], points[first], points[last])};
+      if (distance > farthest) {
+        farthest = distance;
+        split = i;
+      }
+    }
+
+    if (farthest > tolerance_squared) {
+      keep[split] = 1;
+      ranges.emplace_back(first, split);
+      ranges.emplace_back(split, last);
+    }
+  }
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    if (keep[i] != 0) {
+      out.push_back(points[i]);
+    }
+  }
+}
+
+void Polyline::simplify(std::span<const ImVec2> points,
+    float tolerance,
+    std::pmr::vector<ImVec2>& out,
+    bool ordered_by_x) {
+  std::pmr::vector<ImVec2> decimated{out.get_allocator().resource()};
+
+  std::size_t begin{0};
+  while (begin < points.size()) {
+    if (!is_finite(points[begin])) {
+      if (!out.empty() && is_finite(out.back())) {
+        out.push_back(points[begin]);
+      }
+      ++begin;
+      continue;
+    }
+
+    std::size_t end{begin};
+    while (end < points.size() && is_finite(points[end])) {
+      ++end;
+    }
+
+    const std::span<const ImVec2> run{points.subspan(begin, end - begin)};
+    if (ordered_by_x) {
+      decimated.clear();
+      decimate_columns(run, decimated);
+      simplify_rdp(decimated, tolerance, out);
+    } else {
+      simplify_rdp(run, tolerance, out);
+    }
+    begin = end;
+  }
+}
+
+ImVec2 Polyline::narrow(double x, double y, double limit) {
+  return {static_cast<float>(std::clamp(x, -limit, limit)),
+      static_cast<float>(std::clamp(y, -limit, limit))};
+}
+
+void Polyline::clip(
+    std::span<const ImVec2> points, float top, float bottom, std::pmr::vector<ImVec2>& out) {
+  static constexpr float NOT_A_NUMBER{std::numeric_limits<float>::quiet_NaN()};
+  const auto split{[&out] {
+    if (!out.empty() && is_finite(out.back())) {
+      out.emplace_back(NOT_A_NUMBER, NOT_A_NUMBER);
+    }
+  }};
+  const auto emit{[&out](const ImVec2& point) {
+    if (out.empty() || !is_finite(out.back()) || out.back().x != point.x ||
+        out.back().y != point.y) {
+      out.push_back(point);
+    }
+  }};
+
+  for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+    const ImVec2& a{points[i]};
+    const ImVec2& b{points[i + 1]};
+    if (!is_finite(a) || !is_finite(b) || is_jump(points, i, top, bottom)) {
+      split();
+      continue;
+    }
+
+    // The part of the segment inside the band, as parameters along it.
+    float enter{0.0F};
+    float leave{1.0F};
+    const float dy{b.y - a.y};
+    if (dy == 0.0F) {
+      if (a.y < top || a.y > bottom) {
+        split();
+        continue;
+      }
+    } else {
+      const float t_top{(top - a.y) / dy};
+      const float t_bottom{(bottom - a.y) / dy};
+      enter = std::fmax(enter, std::fmin(t_top, t_bottom));
+      leave = std::fmin(leave, std::fmax(t_top, t_bottom));
+      if (enter > leave) {
+        split();
+        continue;
+      }
+    }
+
+    emit(enter > 0.0F ? lerp(a, b, enter) : a);
+    emit(leave < 1.0F ? lerp(a, b, leave) : b);
+    if (leave < 1.0F) {
+      split();
+    }
+  }
+
+  if (!out.empty() && !is_finite(out.back())) {
+    out.pop_back();
+  }
+}
+
+}  // namespace App::Core
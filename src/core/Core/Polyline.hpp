@@ -0,0 +1,73 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace App::Core {
+
+// Screen-space clipping and reduction of curve polylines before they are tessellated.
+//
+// Sampling produces up to several points per pixel column (more where it refines), and every
+// point becomes thick-line triangles. Most of them are invisible: same pixel, or on a run that
+// is straight to well below a pixel. Points are in pixels.
+class Polyline {
+ public:
+  // Largest deviation RDP may introduce; invisible under anti-aliasing.
+  static constexpr float DEFAULT_TOLERANCE_PX{0.25F};
+
+  // Keeps at most the first, lowest, highest and last point of each integer pixel column, in
+  // their original order, which preserves the column's vertical extent. x must increase along
+  // the line.
+  static void decimate_columns(std::span<const ImVec2> points, std::pmr::vector<ImVec2>& out);
+
+  // Ramer-Douglas-Peucker: keeps the fewest points such that every dropped point lies within
+  // `tolerance` of the kept line.
+  static void simplify_rdp(
+      std::span<const ImVec2> points, float tolerance, std::pmr::vector<ImVec2>& out);
+
+  // Both stages on each run of finite points; a non-finite point between runs is kept (once)
+  // as a separator. Column decimation needs x to increase along the line, so lines that turn
+  // back (parametric curves) pass `ordered_by_x = false` and only get RDP.
+  static void simplify(std::span<const ImVec2> points,
+      float tolerance,
+      std::pmr::vector<ImVec2>& out,
+      bool ordered_by_x = true);
+
+  // Restricts the line to the band top <= y <= bottom. Segments outside it are dropped, the
+  // ones crossing its edges are cut at the edge, and the line is split (one NaN separator)
+  // wherever it leaves the band, at non-finite points and at jumps: segments that cross the
+  // whole band against the direction of both neighbours, like tan(x) across a pole.
+  static void clip(
+      std::span<const ImVec2> points, float top, float bottom, std::pmr::vector<ImVec2>& out);
+
+  // Narrows a point given in pixels in double precision to float, each coordinate clamped to
+  // [-limit, limit]: huge values (exp(x), x = tan(t) near a pole) stay finite floats and keep
+  // the direction the line leaves the view in. NaN (a gap) stays NaN.
+  [[nodiscard]] static ImVec2 narrow(double x, double y, double limit);
+
+  // Calls `draw(first, count)` for every run of at least two finite points.
+  template <typename Draw>
+  static void for_each_run(std::span<const ImVec2> points, Draw&& draw);
+};
+
+template <typename Draw>
+void Polyline::for_each_run(std::span<const ImVec2> points, Draw&& draw) {
+  std::size_t begin{0};
+  while (begin < points.size()) {
+    std::size_t end{begin};
+    while (end < points.size() && std::isfinite(points[end].x) && std::isfinite(points[end].y)) {
+      ++end;
+    }
+    if (end - begin >= 2) {
+      draw(points.data() + begin, end - begin);
+    }
+    begin = end + 1;
+  }
+}
+
+}  // namespace App::Core
@@ -0,0 +1,393 @@
+#include "Raster.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+
+namespace App::Core {
+
+namespace {
+
+struct Color {
+  float r;
+  float g;
+  float b;
+  float a;
+};
+
+Color unpack(ImU32 color) {
+  return {static_cast<float>((color >> IM_COL32_R_SHIFT) & 0xFFU),
+      static_cast<float>((color >> IM_COL32_G_SHIFT) & 0xFFU),
+      static_cast<float>((color >> IM_COL32_B_SHIFT) & 0xFFU),
+      static_cast<float>((color >> IM_COL32_A_SHIFT) & 0xFFU)};
+}
+
+ImU32 pack(const Color& color) {
+  const auto channel{[](float value) {
+    return static_cast<ImU32>(std::clamp(value + 0.5F, 0.0F, 255.0F));
+  }};
+  return IM_COL32(channel(color.r), channel(color.g), channel(color.b), channel(color.a));
+}
+
+// Twice the signed area of (a, b, p); positive on one side of a -> b, negative on the other.
+float edge(const ImVec2& a, const ImVec2& b, float x, float y) {
+  return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+// Whether pixel centers exactly on the edge a -> b belong to the triangle. The two triangles
+// sharing an edge walk it in opposite directions, so exactly one of them owns it.
+bool owns_edge(const ImVec2& a, const ImVec2& b) {
+  const float dx{b.x - a.x};
+  const float dy{b.y - a.y};
+  return dy > 0.0F || (dy == 0.0F && dx < 0.0F);
+}
+
+bool inside(float weight, bool owned) {
+  return weight > 0.0F || (weight == 0.0F && owned);
+}
+
+// Deflate output, least significant bit first.
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<std::uint8_t>& out) : m_out(out) {}
+
+  void bits(std::uint32_t value, int count) {
+    m_buffer |= value << m_count;
+    m_count += count;
+    while (m_count >= 8) {
+      m_out.push_back(static_cast<std::uint8_t>(m_buffer & 0xFFU));
+      m_buffer >>= 8U;
+      m_count -= 8;
+    }
+  }
+
+  // Huffman codes are defined most significant bit first.
+  void code(std::uint32_t value, int length) {
+    std::uint32_t reversed{0};
+    for (int i = 0; i < length; ++i) {
+      reversed = (reversed << 1U) | ((value >> static_cast<unsigned>(i)) & 1U);
+    }
+    bits(reversed, length);
+  }
+
+  void flush() {
+    if (m_count > 0) {
+      m_out.push_back(static_cast<std::uint8_t>(m_buffer & 0xFFU));
+    }
+    m_buffer = 0;
+    m_count = 0;
+  }
+
+ private:
+  std::vector<std::uint8_t>& m_out;
+  std::uint32_t m_buffer{0};
+  int m_count{0};
+};
+
+// Fixed Huffman code of a literal/length symbol (RFC 1951, 3.2.6).
+void write_symbol(BitWriter& writer, std::uint32_t symbol) {
+  if (symbol < 144) {
+    writer.code(0x30U + symbol, 8);
+  } else if (symbol < 256) {
+    writer.code(0x190U + symbol - 144, 9);
+  } else if (symbol < 280) {
+    writer.code(symbol - 256, 7);
+  } else {
+    writer.code(0xC0U + symbol - 280, 8);
+  }
+}
+
+constexpr std::array<std::uint16_t, 29> LENGTH_BASE{3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19,
+    23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<std::uint8_t, 29> LENGTH_EXTRA{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::size_t MIN_MATCH{3};
+constexpr std::size_t MAX_MATCH{258};
+
+// A zlib stream of one fixed-Huffman block. The only matches are runs of the previous byte
+// (distance 1), which is where filtered plot images spend their bytes.
+std::vector<std::uint8_t> zlib_compress(std::span<const std::uint8_t> data) {
+  std::vector<std::uint8_t> out;
+  out.reserve(data.size() / 8 + 64);
+  out.push_back(0x78);  // deflate, 32 KiB window
+  out.push_back(0x01);  // no dictionary, fastest; (0x78 << 8 | 0x01) % 31 == 0
+
+  BitWriter writer{out};
+  writer.bits(1, 1);  // final block
+  writer.bits(1, 2);  // fixed Huffman codes
+
+  std::size_t i{0};
+  while (i < data.size()) {
+    std::size_t run{0};
+    if (i > 0) {
+      while (run < MAX_MATCH && i + run < data.size() && data[i + run] == data[i - 1]) {
+        ++run;
+      }
+    }
+    if (run < MIN_MATCH) {
+      write_symbol(writer, data[i]);
+      ++i;
+      continue;
+    }
+
+    const auto code{static_cast<std::size_t>(
+        std::upper_bound(LENGTH_BASE.begin(), LENGTH_BASE.end(), run) - LENGTH_BASE.begin() - 1)};
+    write_symbol(writer, static_cast<std::uint32_t>(257 + code));
+    writer.bits(static_cast<std::uint32_t>(run - LENGTH_BASE[code]), LENGTH_EXTRA[code]);
+    writer.code(0, 5);  // distance code 0: distance 1
+    i += run;
+  }
+  write_symbol(writer, 256);  // end of block
+  writer.flush();
+
+  std::uint32_t a{1};
+  std::uint32_t b{0};
+  for (const std::uint8_t byte : data) {
+    a = (a + byte) % 65521U;
+    b = (b + a) % 65521U;
+  }
+  const std::uint32_t adler{(b << 16U) | a};
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<std::uint8_t>((adler >> static_cast<unsigned>(shift)) & 0xFFU));
+  }
+  return out;
+}
+
+std::uint32_t crc32(std::span<const std::uint8_t> data, std::uint32_t crc = 0) {
+  static const auto TABLE{[] {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t n = 0; n < table.size(); ++n) {
+      std::uint32_t c{n};
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1U) != 0 ? 0xEDB88320U ^ (c >> 1U) : c >> 1U;
+      }
+      table[n] = c;
+    }
+    return table;
+  }()};
+
+  crc = ~crc;
+  for (const std::uint8_t byte : data) {
+    crc = TABLE[(crc ^ byte) & 0xFFU] ^ (crc >> 8U);
+  }
+  return ~crc;
+}
+
+void put_u32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<std::uint8_t>((value >> static_cast<unsigned>(shift)) & 0xFFU));
+  }
+}
+
+void put_chunk(std::vector<std::uint8_t>& out,
+    const char (&type)[5],  // NOLINT(*-avoid-c-arrays): a four-letter literal
+    std::span<const std::uint8_t> data) {
+  put_u32(out, static_cast<std::uint32_t>(data.size()));
+  const std::size_t begin{out.size()};
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  put_u32(out, crc32(std::span{out}.subspan(begin)));
+}
+
+}  // namespace
+
+Raster::Raster(int width, int height, ImU32 background)
+    : m_width(std::max(width, 0)),
+      m_height(std::max(height, 0)),
+      m_pixels(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height),
+          background) {}
+
+void Raster::draw(const ImDrawList& draw_list, const Texture& texture) {
+  APP_PROFILE_FUNCTION();
+
+  const std::span<const ImDrawVert> vertices{
+      draw_list.VtxBuffer.Data, static_cast<std::size_t>(draw_list.VtxBuffer.Size)};
+  const std::span<const ImDrawIdx> indices{
+      draw_list.IdxBuffer.Data, static_cast<std::size_t>(draw_list.IdxBuffer.Size)};
+  for (const ImDrawCmd& command : draw_list.CmdBuffer) {
+    if (command.UserCallback != nullptr || command.ElemCount == 0) {
+      continue;
+    }
+    draw(vertices.subspan(command.VtxOffset),
+        indices.subspan(command.IdxOffset, command.ElemCount),
+        command.ClipRect,
+        texture);
+  }
+}
+
+void Raster::draw(std::span<const ImDrawVert> vertices,
+    std::span<const ImDrawIdx> indices,
+    const ImVec4& clip,
+    const Texture& texture) {
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    triangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], clip,
+        texture);
+  }
+}
+
+void Raster::triangle(const ImDrawVert& a,
+    const ImDrawVert& b_in,
+    const ImDrawVert& c_in,
+    const ImVec4& clip,
+    const Texture& texture) {
+  // Wind every triangle the same way, so inside is where all edge functions are positive.
+  float area{edge(a.pos, b_in.pos, c_in.pos.x, c_in.pos.y)};
+  if (area == 0.0F || !std::isfinite(area)) {
+    return;
+  }
+  const bool flip{area < 0.0F};
+  const ImDrawVert& b{flip ? c_in : b_in};
+  const ImDrawVert& c{flip ? b_in : c_in};
+  area = std::abs(area);
+
+  const float left{std::max({std::min({a.pos.x, b.pos.x, c.pos.x}), clip.x, 0.0F})};
+  const float top{std::max({std::min({a.pos.y, b.pos.y, c.pos.y}), clip.y, 0.0F})};
+  const float right{std::min(
+      {std::max({a.pos.x, b.pos.x, c.pos.x}), clip.z, static_cast<float>(m_width)})};
+  const float bottom{std::min(
+      {std::max({a.pos.y, b.pos.y, c.pos.y}), clip.w, static_cast<float>(m_height)})};
+  if (!(left < right) || !(top < bottom)) {
+    return;
+  }
+
+  // Pixels whose center lies in [left, right) x [top, bottom).
+  const auto x0{static_cast<int>(std::ceil(left - 0.5F))};
+  const auto x1{static_cast<int>(std::ceil(right - 0.5F))};
+  const auto y0{static_cast<int>(std::ceil(top - 0.5F))};
+  const auto y1{static_cast<int>(std::ceil(bottom - 0.5F))};
+
+  const bool owns_a{owns_edge(b.pos, c.pos)};
+  const bool owns_b{owns_edge(c.pos, a.pos)};
+  const bool owns_c{owns_edge(a.pos, b.pos)};
+  const Color color_a{unpack(a.col)};
+  const Color color_b{unpack(b.col)};
+  const Color color_c{unpack(c.col)};
+  const float texture_width{static_cast<float>(texture.width)};
+  const float texture_height{static_cast<float>(texture.height)};
+
+  for (int y = y0; y < y1; ++y) {
+    const float center_y{static_cast<float>(y) + 0.5F};
+    for (int x = x0; x < x1; ++x) {
+      const float center_x{static_cast<float>(x) + 0.5F};
+      const float weight_a{edge(b.pos, c.pos, center_x, center_y)};
+      const float weight_b{edge(c.pos, a.pos, center_x, center_y)};
+      const float weight_c{edge(a.pos, b.pos, center_x, center_y)};
+      if (!inside(weight_a, owns_a) || !inside(weight_b, owns_b) ||
+          !inside(weight_c, owns_c)) {
+        continue;
+      }
+
+      const float u{(weight_a * a.uv.x + weight_b * b.uv.x + weight_c * c.uv.x) / area};
+      const float v{(weight_a * a.uv.y + weight_b * b.uv.y + weight_c * c.uv.y) / area};
+      const auto interpolate{[&](float value_a, float value_b, float value_c) {
+        return (weight_a * value_a + weight_b * value_b + weight_c * value_c) / area;
+      }};
+      Color source{interpolate(color_a.r, color_b.r, color_c.r),
+          interpolate(color_a.g, color_b.g, color_c.g),
+          interpolate(color_a.b, color_b.b, color_c.b),
+          interpolate(color_a.a, color_b.a, color_c.a)};
+
+      if (texture.pixels != nullptr) {
+        const int texel_x{std::clamp(static_cast<int>(u * texture_width), 0, texture.width - 1)};
+        const int texel_y{
+            std::clamp(static_cast<int>(v * texture_height), 0, texture.height - 1)};
+        const unsigned char* texel{texture.pixels +
+                                   (static_cast<std::size_t>(texel_y) *
+                                           static_cast<std::size_t>(texture.width) +
+                                       static_cast<std::size_t>(texel_x)) *
+                                       4};
+        source.r *= static_cast<float>(texel[0]) / 255.0F;
+        source.g *= static_cast<float>(texel[1]) / 255.0F;
+        source.b *= static_cast<float>(texel[2]) / 255.0F;
+        source.a *= static_cast<float>(texel[3]) / 255.0F;
+      }
+      if (source.a <= 0.0F) {
+        continue;
+      }
+
+      ImU32& pixel{m_pixels[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) +
+                            static_cast<std::size_t>(x)]};
+      const Color target{unpack(pixel)};
+      const float alpha{source.a / 255.0F};
+      pixel = pack({source.r * alpha + target.r * (1.0F - alpha),
+          source.g * alpha + target.g * (1.0F - alpha),
+          source.b * alpha + target.b * (1.0F - alpha),
+          source.a + target.a * (1.0F - alpha)});
+    }
+  }
+}
+
+int Raster::width() const {
+  return m_width;
+}
+
+int Raster::height() const {
+  return m_height;
+}
+
+const std::vector<ImU32>& Raster::pixels() const {
+  return m_pixels;
+}
+
+bool Raster::write_png(const std::filesystem::path& path) const {
+  APP_PROFILE_FUNCTION();
+
+  const std::vector<std::uint8_t> png{encode_png(m_pixels, m_width, m_height)};
+  std::ofstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    APP_WARN("Could not write {}", path.generic_string());
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(png.data()),  // NOLINT(*-reinterpret-cast)
+      static_cast<std::streamsize>(png.size()));
+  return file.good();
+}
+
+std::vector<std::uint8_t> Raster::encode_png(
+    std::span<const ImU32> pixels, int width, int height) {
+  const auto columns{static_cast<std::size_t>(std::max(width, 0))};
+  const auto rows{static_cast<std::size_t>(std::max(height, 0))};
+  const std::size_t stride{columns * 4};
+
+  // Every scanline uses the Sub filter: each byte minus the same channel of the pixel to its
+  // left, which turns flat background into runs of zeros.
+  std::vector<std::uint8_t> filtered;
+  filtered.reserve(rows * (stride + 1));
+  std::vector<std::uint8_t> line(stride);
+  for (std::size_t y = 0; y < rows && y * columns < pixels.size(); ++y) {
+    for (std::size_t x = 0; x < columns; ++x) {
+      const ImU32 pixel{pixels[y * columns + x]};
+      line[x * 4 + 0] = static_cast<std::uint8_t>((pixel >> IM_COL32_R_SHIFT) & 0xFFU);
+      line[x * 4 + 1] = static_cast<std::uint8_t>((pixel >> IM_COL32_G_SHIFT) & 0xFFU);
+      line[x * 4 + 2] = static_cast<std::uint8_t>((pixel >> IM_COL32_B_SHIFT) & 0xFFU);
+      line[x * 4 + 3] = static_cast<std::uint8_t>((pixel >> IM_COL32_A_SHIFT) & 0xFFU);
+    }
+    filtered.push_back(1);
+    for (std::size_t i = 0; i < stride; ++i) {
+      filtered.push_back(static_cast<std::uint8_t>(line[i] - (i >= 4 ? line[i - 4] : 0)));
+    }
+  }
+
+  std::vector<std::uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<std::uint8_t> header;
+  put_u32(header, static_cast<std::uint32_t>(columns));
+  put_u32(header, static_cast<std::uint32_t>(rows));
+  header.insert(header.end(), {8, 6, 0, 0, 0});  // 8 bits per channel, RGBA, no interlace
+  put_chunk(png, "IHDR", header);
+  put_chunk(png, "IDAT", zlib_compress(filtered));
+  put_chunk(png, "IEND", {});
+  return png;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace App::Core {
+
+// Software rasterizer for ImGui draw lists, so plots can be exported to images without a
+// window or a GPU.
+//
+// Triangles are filled at pixel centers with the top-left rule (edges shared by two triangles
+// are blended once), their vertex colors interpolated, multiplied by the nearest texel and
+// blended over the image. That is enough for ImGui's output: anti-aliasing is done with
+// transparent fringe vertices and baked line textures, not with coverage.
+class Raster {
+ public:
+  // RGBA, 4 bytes per texel (as returned by ImFontAtlas::GetTexDataAsRGBA32).
+  struct Texture {
+    const unsigned char* pixels;
+    int width;
+    int height;
+  };
+
+  Raster(int width, int height, ImU32 background);
+
+  // Draws every command of `draw_list`, clipped to its clip rectangle. All of them must use
+  // `texture` (there is only one atlas); callbacks are skipped.
+  void draw(const ImDrawList& draw_list, const Texture& texture);
+
+  // Draws the triangles `indices` make of `vertices`, clipped to `clip` (x0, y0, x1, y1).
+  void draw(std::span<const ImDrawVert> vertices,
+      std::span<const ImDrawIdx> indices,
+      const ImVec4& clip,
+      const Texture& texture);
+
+  [[nodiscard]] int width() const;
+  [[nodiscard]] int height() const;
+  // Row-major, one ImU32 (IM_COL32 layout) per pixel.
+  [[nodiscard]] const std::vector<ImU32>& pixels() const;
+
+  // The image as an RGBA8 PNG file. Returns false (and logs why) if it cannot be written.
+  bool write_png(const std::filesystem::path& path) const;
+
+  // PNG encoding of `pixels` (`width` x `height`, IM_COL32 layout). Deflate uses fixed Huffman
+  // codes and run-length matches after the Sub filter, which is small for plots: mostly
+  // background with thin lines.
+  [[nodiscard]] static std::vector<std::uint8_t> encode_png(
+      std::span<const ImU32> pixels, int width, int height);
+
+ private:
+  void triangle(const ImDrawVert& a,
+      const ImDrawVert& b,
+      const ImDrawVert& c,
+      const ImVec4& clip,
+      const Texture& texture);
+
+  int m_width;
+  int m_height;
+  std::vector<ImU32> m_pixels;
+};
+
+}  // namespace App::Core
@@ -0,0 +1,62 @@
+#include "RetainedGeometry.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace App::Core {
+
+void RetainedGeometry::capture(const ImDrawList& scratch) {
+  const auto vertex_count{static_cast<std::size_t>(scratch.VtxBuffer.Size)};
+  const auto index_count{static_cast<std::size_t>(scratch.IdxBuffer.Size)};
+  if (vertex_count == 0) {
+    return;
+  }
+  m_chunks.push_back({m_vertices.size(), vertex_count, m_indices.size(), index_count});
+  m_vertices.insert(m_vertices.end(), scratch.VtxBuffer.begin(), scratch.VtxBuffer.end());
+  m_indices.insert(m_indices.end(), scratch.IdxBuffer.begin(), scratch.IdxBuffer.end());
+  m_placed_valid = false;
+}
+
+void RetainedGeometry::clear() {
+  m_vertices.clear();
+  m_indices.clear();
+  m_chunks.clear();
+  m_placed_valid = false;
+}
+
+void RetainedGeometry::draw(ImDrawList* draw_list, const ImVec2& origin) const {
+  if (!m_placed_valid || origin.x != m_placed_origin.x || origin.y != m_placed_origin.y) {
+    m_placed.resize(m_vertices.size());
+    for (std::size_t i = 0; i < m_vertices.size(); ++i) {
+      m_placed[i] = m_vertices[i];
+      m_placed[i].pos.x += origin.x;
+      m_placed[i].pos.y += origin.y;
+    }
+    m_placed_origin = origin;
+    m_placed_valid = true;
+  }
+
+  for (const Chunk& chunk : m_chunks) {
+    draw_list->PrimReserve(
+        static_cast<int>(chunk.index_count), static_cast<int>(chunk.vertex_count));
+
+    const ImDrawIdx base{static_cast<ImDrawIdx>(draw_list->_VtxCurrentIdx)};
+    std::copy_n(m_placed.data() + chunk.vertex_offset, chunk.vertex_count, draw_list->_VtxWritePtr);
+    for (std::size_t i = 0; i < chunk.index_count; ++i) {
+      draw_list->_IdxWritePtr[i] =
+          static_cast<ImDrawIdx>(base + m_indices[chunk.index_offset + i]);
+    }
+
+    draw_list->_VtxWritePtr += chunk.vertex_count;
+    draw_list->_IdxWritePtr += chunk.index_count;
+    draw_list->_VtxCurrentIdx += static_cast<unsigned int>(chunk.vertex_count);
+  }
+}
+
+std::size_t RetainedGeometry::vertex_count() const {
+  return m_vertices.size();
+}
+
+}  // namespace App::Core
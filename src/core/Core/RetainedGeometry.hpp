@@ -0,0 +1,47 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace App::Core {
+
+// CPU-side cache of triangles tessellated once with ImGui's primitives.
+//
+// Geometry is drawn into a scratch ImDrawList that shares the window's settings and captured
+// with `capture()`. ImGui rebuilds its draw lists every frame, so `draw()` still appends the
+// triangles to the real draw list (and the backend uploads them) each frame; what it saves is
+// the tessellation. The vertices placed at the last origin are kept too, so while the origin
+// holds still a frame only block-copies them and rebases the indices.
+class RetainedGeometry {
+ public:
+  // Appends everything drawn into `scratch` since its last reset. `scratch` must stay within
+  // 16-bit indices.
+  void capture(const ImDrawList& scratch);
+  void clear();
+
+  // Appends the captured triangles, translated by `origin`.
+  void draw(ImDrawList* draw_list, const ImVec2& origin) const;
+
+  [[nodiscard]] std::size_t vertex_count() const;
+
+ private:
+  struct Chunk {
+    std::size_t vertex_offset;
+    std::size_t vertex_count;
+    std::size_t index_offset;
+    std::size_t index_count;
+  };
+
+  std::vector<ImDrawVert> m_vertices;
+  std::vector<ImDrawIdx> m_indices;
+  std::vector<Chunk> m_chunks;
+
+  // m_vertices translated by m_placed_origin, refreshed by draw() when the origin moves.
+  mutable std::vector<ImDrawVert> m_placed;
+  mutable ImVec2 m_placed_origin{0.0F, 0.0F};
+  mutable bool m_placed_valid{false};
+};
+
+}  // namespace App::Core
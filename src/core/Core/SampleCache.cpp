@@ -0,0 +1,507 @@
+#include "SampleCache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Interval.hpp"
+#include "Core/ThreadPool.hpp"
+
+namespace App::Core {
+
+namespace {
+
+// Deviation (in pixels) above which an interval is bisected.
+constexpr double REFINE_TOLERANCE_PX{0.5};
+// Deviation (in pixels) below which samples of a flat run are merged.
+constexpr double MERGE_TOLERANCE_PX{0.1};
+
+// Share of the change across an interval above which, if one half holds it, the change is
+// suspected to be a jump: a smooth curve spreads it out over both halves once zoomed in.
+constexpr double JUMP_SHARE{0.9};
+
+bool is_finite(const Sample& sample) {
+  return std::isfinite(sample.y);
+}
+
+// Whether the curve provably stays above or below `band` over [a, b]. Undefined points do not
+// matter: whatever it is where it is defined is out of the band, and so is the chord.
+bool is_culled(const SampleCache::Band& band, const Sample& a, const Sample& b) {
+  if (band.bounds == nullptr || !is_finite(a) || !is_finite(b)) {
+    return false;
+  }
+  const bool above{a.y > band.ymax && b.y > band.ymax};
+  const bool below{a.y < band.ymin && b.y < band.ymin};
+  if (!above && !below) {
+    return false;
+  }
+  const Interval value{band.bounds(a.x, b.x)};
+  return above ? value.lo > band.ymax : value.hi < band.ymin;
+}
+
+// Whether [a, b], halved at `mid`, looks discontinuous: one half holds nearly all of the change
+// (a step), or the values flip sign and grow toward the flip (a pole): `mid` is further from
+// zero than the end on its side.
+bool is_suspect(const Sample& a, const Sample& mid, const Sample& b) {
+  const double left{std::fabs(mid.y - a.y)};
+  const double right{std::fabs(b.y - mid.y)};
+  const bool step{std::max(left, right) >= JUMP_SHARE * (left + right)};
+  const Sample& same_side{(mid.y < 0.0) == (a.y < 0.0) ? a : b};
+  const bool pole{(a.y < 0.0) != (b.y < 0.0) && std::fabs(mid.y) > std::fabs(same_side.y)};
+  return step || pole;
+}
+
+// Narrows a suspected jump in [a, b] (`mid` its midpoint) down to where it happens, keeping the
+// half where the sign flips, or else the one with the larger change, each time. If it is
+// still there at the end (a step or a pole), appends the samples on either side with a
+// non-finite separator between them, so the line across the jump is never drawn, and returns
+// true. Returns false with nothing appended as soon as the change spreads out: the curve is
+// merely steep.
+bool locate_jump(const SampleCache::Function& function,
+    Sample a,
+    Sample mid,
+    Sample b,
+    double tolerance,
+    std::size_t& budget,
+    std::vector<Sample>& out) {
+  const double change{std::fabs(mid.y - a.y) + std::fabs(b.y - mid.y)};
+
+  // Points approaching the jump from the left (increasing x) and from the right (decreasing).
+  std::array<Sample, SampleCache::JUMP_SEARCH_DEPTH + 1> left{};
+  std::array<Sample, SampleCache::JUMP_SEARCH_DEPTH + 1> right{};
+  std::size_t left_count{0};
+  std::size_t right_count{0};
+  for (int depth = 0;; ++depth) {
+    const bool flips{(a.y < 0.0) != (b.y < 0.0)};
+    const bool keep_left{flips ? (a.y < 0.0) != (mid.y < 0.0)
+                               : std::fabs(mid.y - a.y) >= std::fabs(b.y - mid.y)};
+    if (keep_left) {
+      right[right_count++] = mid;
+      b = mid;
+    } else {
+      left[left_count++] = mid;
+      a = mid;
+    }
+
+    const double xm{0.5 * (a.x + b.x)};
+    if (depth == SampleCache::JUMP_SEARCH_DEPTH || budget == 0 || xm <= a.x || xm >= b.x) {
+      break;
+    }
+    mid = {xm, function(xm)};
+    --budget;
+    if (!is_finite(mid) || !is_suspect(a, mid, b)) {
+      return false;
+    }
+  }
+
+  const double remaining{std::fabs(b.y - a.y)};
+  if (!(remaining >= 0.5 * change && remaining > tolerance)) {
+    return false;
+  }
+  out.insert(out.end(), left.begin(), left.begin() + static_cast<std::ptrdiff_t>(left_count));
+  out.push_back({0.5 * (a.x + b.x), std::numeric_limits<double>::quiet_NaN()});
+  for (std::size_t i = right_count; i > 0; --i) {
+    out.push_back(right[i - 1]);
+  }
+  return true;
+}
+
+// Bisects [a, b] while the midpoint is further than `tolerance` off the chord, or while the
+// interval straddles a change between finite and non-finite values. Jumps and poles are not
+// bisected but located and broken (see locate_jump()): one sample per halving, only on the
+// side of the jump, instead of refining both sides of a line that is not drawn.
+void bisect(const SampleCache::Function& function,
+    const Sample& a,
+    const Sample& b,
+    double tolerance,
+    int depth,
+    std::size_t& budget,
+    std::vector<Sample>& out) {
+  if (depth == 0 || budget == 0) {
+    return;
+  }
+
+  const double xm{0.5 * (a.x + b.x)};
+  const Sample mid{xm, function(xm)};
+  --budget;
+
+  const bool split{is_finite(a) && is_finite(b) && is_finite(mid)
+                       ? std::fabs(mid.y - 0.5 * (a.y + b.y)) > tolerance
+                       : is_finite(a) || is_finite(b) || is_finite(mid)};
+
+  if (split && is_finite(a) && is_finite(b) && is_finite(mid) && is_suspect(a, mid, b) &&
+      locate_jump(function, a, mid, b, tolerance, budget, out)) {
+    return;
+  }
+
+  if (split) {
+    bisect(function, a, mid, tolerance, depth - 1, budget, out);
+  }
+  out.push_back(mid);
+  if (split) {
+    bisect(function, mid, b, tolerance, depth - 1, budget, out);
+  }
+}
+
+}  // namespace
+
+double SampleCache::step_for(double pixels_per_unit) {
+  return std::exp2(std::round(std::log2(1.0 / pixels_per_unit)));
+}
+
+std::size_t SampleCache::update(const Function& function,
+    double xmin,
+    double xmax,
+    double pixels_per_unit,
+    ThreadPool* pool,
+    const BatchFunction& batch,
+    const Band& band) {
+  if (!(pixels_per_unit > 0.0) || !(xmax > xmin)) {
+    invalidate();
+    return 0;
+  }
+
+  const double step{step_for(pixels_per_unit)};
+
+  // One extra grid point on each side so the polyline reaches the canvas edges.
+  const auto first{static_cast<std::int64_t>(std::floor(xmin / step))};
+  const auto last{static_cast<std::int64_t>(std::ceil(xmax / step))};
+
+  const double band_ymin{band.bounds != nullptr ? band.ymin : 0.0};
+  const double band_ymax{band.bounds != nullptr ? band.ymax : 0.0};
+  const bool band_moved{band_ymin != m_band_ymin || band_ymax != m_band_ymax};
+
+  if (step == m_step && pixels_per_unit == m_pixels_per_unit && first == m_first &&
+      last == m_last && !band_moved) {
+    return 0;
+  }
+
+  APP_PROFILE_SCOPE("SampleCache::update");
+
+  // Merge the new grid with the old samples. Both are sorted by x and grid points are always
+  // computed as `k * step` with a power-of-two step, so a sample that is still on the grid
+  // compares exactly equal.
+  m_scratch.clear();
+  m_scratch.reserve(static_cast<std::size_t>(last - first + 1));
+  m_missing.clear();
+
+  std::size_t old_index{0};
+  for (std::int64_t k = first; k <= last; ++k) {
+    const double x{static_cast<double>(k) * step};
+
+    while (old_index < m_samples.size() && m_samples[old_index].x < x) {
+      ++old_index;
+    }
+
+    if (old_index < m_samples.size() && m_samples[old_index].x == x) {
+      m_scratch.push_back(m_samples[old_index]);
+    } else {
+      m_missing.push_back(m_scratch.size());
+      m_scratch.push_back({x, 0.0});
+    }
+  }
+
+  evaluate_missing(function, batch, pool);
+  std::size_t evaluated{m_missing.size()};
+  std::swap(m_samples, m_scratch);
+
+  // Refinements depend on the pixel tolerance, so they only survive a pure pan.
+  if (step != m_step || pixels_per_unit != m_pixels_per_unit) {
+    m_refined.clear();
+    m_culled.clear();
+    m_refined_first = first;
+    m_refined_last = first;
+  } else {
+    m_refined_first = std::max(m_refined_first, first);
+    m_refined_last = std::min(m_refined_last, last);
+    if (m_refined_first >= m_refined_last) {
+      m_refined.clear();
+      m_culled.clear();
+      m_refined_first = first;
+      m_refined_last = first;
+    } else {
+      const double lo{static_cast<double>(m_refined_first) * step};
+      const double hi{static_cast<double>(m_refined_last) * step};
+      std::erase_if(m_refined, [lo, hi](const Sample& sample) {
+        return sample.x < lo || sample.x > hi;
+      });
+      std::erase_if(m_culled, [this](std::int64_t k) {
+        return k < m_refined_first || k >= m_refined_last;
+      });
+    }
+  }
+
+  m_step = step;
+  m_pixels_per_unit = pixels_per_unit;
+  m_first = first;
+  m_last = last;
+
+  std::size_t budget{REFINE_BUDGET_PER_SAMPLE * m_samples.size()};
+
+  // A moved band may now see intervals culled against the old one.
+  if (band_moved) {
+    evaluated += refine_culled(function, band, budget);
+  }
+  m_band_ymin = band_ymin;
+  m_band_ymax = band_ymax;
+
+  // Refine the intervals that are not covered yet: left of and right of the kept range.
+  std::vector<Sample> left;
+  std::vector<std::int64_t> left_culled;
+  evaluated +=
+      refine_range(function, band, first, m_refined_first, budget, left, left_culled, pool);
+  evaluated +=
+      refine_range(function, band, m_refined_last, last, budget, m_refined, m_culled, pool);
+  m_refined.insert(m_refined.begin(), left.begin(), left.end());
+  m_culled.insert(m_culled.begin(), left_culled.begin(), left_culled.end());
+  m_refined_first = first;
+  m_refined_last = last;
+
+  build_curve();
+
+  return evaluated;
+}
+
+void SampleCache::evaluate_missing(const Function& function,
+    const BatchFunction& batch,
+    ThreadPool* pool) {
+  // Gathered into contiguous arrays for the batch path; zooming in leaves gaps between them.
+  if (batch != nullptr) {
+    m_missing_x.resize(m_missing.size());
+    m_missing_y.resize(m_missing.size());
+    for (std::size_t i = 0; i < m_missing.size(); ++i) {
+      m_missing_x[i] = m_scratch[m_missing[i]].x;
+    }
+  }
+
+  const auto evaluate{[this, &function, &batch](std::size_t begin, std::size_t end) {
+    if (batch != nullptr) {
+      batch(m_missing_x.data() + begin, m_missing_y.data() + begin, end - begin);
+      for (std::size_t i = begin; i < end; ++i) {
+        m_scratch[m_missing[i]].y = m_missing_y[i];
+      }
+      return;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      Sample& sample{m_scratch[m_missing[i]]};
+      sample.y = function(sample.x);
+    }
+  }};
+
+  if (pool == nullptr || m_missing.size() <= CHUNK_SIZE) {
+    evaluate(0, m_missing.size());
+    return;
+  }
+
+  const std::size_t chunk_count{(m_missing.size() + CHUNK_SIZE - 1) / CHUNK_SIZE};
+  pool->parallel_for(chunk_count, [this, &evaluate](std::size_t chunk) {
+    evaluate(chunk * CHUNK_SIZE, std::min(m_missing.size(), (chunk + 1) * CHUNK_SIZE));
+  });
+}
+
+std::size_t SampleCache::refine_range(const Function& function,
+    const Band& band,
+    std::int64_t begin,
+    std::int64_t end,
+    std::size_t& budget,
+    std::vector<Sample>& out,
+    std::vector<std::int64_t>& culled,
+    ThreadPool* pool) {
+  const auto interval_count{static_cast<std::size_t>(std::max<std::int64_t>(end - begin, 0))};
+  if (pool == nullptr || interval_count <= CHUNK_SIZE) {
+    return refine_intervals(function, band, begin, end, budget, out, culled);
+  }
+
+  // Every chunk refines into its own buffer with an equal share of the budget; the buffers
+  // are concatenated in order afterwards so the output stays sorted.
+  const std::size_t chunk_count{(interval_count + CHUNK_SIZE - 1) / CHUNK_SIZE};
+  const std::size_t chunk_budget{budget / chunk_count};
+  m_chunks.resize(chunk_count);
+  m_culled_chunks.resize(chunk_count);
+
+  std::atomic<std::size_t> evaluated{0};
+  pool->parallel_for(chunk_count, [&, this](std::size_t chunk) {
+    const auto chunk_begin{begin + static_cast<std::int64_t>(chunk * CHUNK_SIZE)};
+    const auto chunk_end{std::min(end, chunk_begin + static_cast<std::int64_t>(CHUNK_SIZE))};
+    std::size_t local_budget{chunk_budget};
+    m_chunks[chunk].clear();
+    m_culled_chunks[chunk].clear();
+    evaluated += refine_intervals(function,
+        band,
+        chunk_begin,
+        chunk_end,
+        local_budget,
+        m_chunks[chunk],
+        m_culled_chunks[chunk]);
+  });
+
+  for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+    out.insert(out.end(), m_chunks[chunk].begin(), m_chunks[chunk].end());
+    culled.insert(culled.end(), m_culled_chunks[chunk].begin(), m_culled_chunks[chunk].end());
+  }
+
+  budget -= std::min(budget, evaluated.load());
+  return evaluated.load();
+}
+
+std::size_t SampleCache::refine_intervals(const Function& function,
+    const Band& band,
+    std::int64_t begin,
+    std::int64_t end,
+    std::size_t& budget,
+    std::vector<Sample>& out,
+    std::vector<std::int64_t>& culled) const {
+  const double tolerance{REFINE_TOLERANCE_PX / m_pixels_per_unit};
+  const std::size_t budget_before{budget};
+
+  // Second difference of the base samples around grid index k; large values mean the curve
+  // bends (or jumps) within a pixel or two.
+  const auto bend{[this](std::int64_t k) {
+    if (k <= m_first || k >= m_last) {
+      return 0.0;
+    }
+    const auto index{static_cast<std::size_t>(k - m_first)};
+    const double bend_y{
+        m_samples[index - 1].y - 2.0 * m_samples[index].y + m_samples[index + 1].y};
+    return std::isnan(bend_y) ? std::numeric_limits<double>::infinity() : std::fabs(bend_y);
+  }};
+
+  for (std::int64_t k = begin; k < end && budget > 0; ++k) {
+    const auto index{static_cast<std::size_t>(k - m_first)};
+    const Sample& a{m_samples[index]};
+    const Sample& b{m_samples[index + 1]};
+
+    const bool mixed{is_finite(a) != is_finite(b)};
+    if (mixed || std::max(bend(k), bend(k + 1)) > tolerance) {
+      if (is_culled(band, a, b)) {
+        culled.push_back(k);
+        continue;
+      }
+      bisect(function, a, b, tolerance, MAX_REFINE_DEPTH, budget, out);
+    }
+  }
+
+  return budget_before - budget;
+}
+
+// Refines the culled intervals `band` no longer rules out and merges them into m_refined.
+// Serial: unlike a fresh range, only the intervals close to the band edges are usually left.
+std::size_t SampleCache::refine_culled(const Function& function,
+    const Band& band,
+    std::size_t& budget) {
+  const double tolerance{REFINE_TOLERANCE_PX / m_pixels_per_unit};
+  const std::size_t budget_before{budget};
+
+  std::vector<Sample> revealed;
+  std::erase_if(m_culled, [&, this](std::int64_t k) {
+    const auto index{static_cast<std::size_t>(k - m_first)};
+    const Sample& a{m_samples[index]};
+    const Sample& b{m_samples[index + 1]};
+    if (is_culled(band, a, b)) {
+      return false;
+    }
+    bisect(function, a, b, tolerance, MAX_REFINE_DEPTH, budget, revealed);
+    return true;
+  });
+  if (revealed.empty()) {
+    return budget_before - budget;
+  }
+
+  std::vector<Sample> merged;
+  merged.reserve(m_refined.size() + revealed.size());
+  std::merge(m_refined.begin(),
+      m_refined.end(),
+      revealed.begin(),
+      revealed.end(),
+      std::back_inserter(merged),
+      [](const Sample& lhs, const Sample& rhs) { return lhs.x < rhs.x; });
+  std::swap(m_refined, merged);
+  return budget_before - budget;
+}
+
+void SampleCache::build_curve() {
+  m_curve.clear();
+  m_curve.reserve(m_samples.size() + m_refined.size());
+
+  const double tolerance{MERGE_TOLERANCE_PX / m_pixels_per_unit};
+
+  // Merges flat runs: every sample dropped between the anchor and the last point stays within
+  // `tolerance` of the chord, tracked as the range of slopes still allowed from the anchor.
+  std::size_t anchor{0};
+  double slope_lo{-std::numeric_limits<double>::infinity()};
+  double slope_hi{std::numeric_limits<double>::infinity()};
+
+  const auto append{[&](const Sample& sample) {
+    if (!m_curve.empty() && is_finite(sample) && is_finite(m_curve.back()) &&
+        is_finite(m_curve[anchor]) && m_curve.size() - anchor >= 2) {
+      const Sample& origin{m_curve[anchor]};
+      const double dx{sample.x - origin.x};
+      const double slope{(sample.y - origin.y) / dx};
+      if (slope >= slope_lo && slope <= slope_hi) {
+        m_curve.back() = sample;
+        slope_lo = std::max(slope_lo, (sample.y - tolerance - origin.y) / dx);
+        slope_hi = std::min(slope_hi, (sample.y + tolerance - origin.y) / dx);
+        return;
+      }
+    }
+
+    if (!m_curve.empty()) {
+      anchor = m_curve.size() - 1;
+    }
+    m_curve.push_back(sample);
+
+    const Sample& origin{m_curve[anchor]};
+    const double dx{sample.x - origin.x};
+    if (dx > 0.0) {
+      slope_lo = (sample.y - tolerance - origin.y) / dx;
+      slope_hi = (sample.y + tolerance - origin.y) / dx;
+    } else {
+      slope_lo = -std::numeric_limits<double>::infinity();
+      slope_hi = std::numeric_limits<double>::infinity();
+    }
+  }};
+
+  std::size_t refined_index{0};
+  for (const Sample& sample : m_samples) {
+    while (refined_index < m_refined.size() && m_refined[refined_index].x < sample.x) {
+      append(m_refined[refined_index++]);
+    }
+    append(sample);
+  }
+  while (refined_index < m_refined.size()) {
+    append(m_refined[refined_index++]);
+  }
+}
+
+void SampleCache::invalidate() {
+  m_samples.clear();
+  m_refined.clear();
+  m_culled.clear();
+  m_curve.clear();
+  m_band_ymin = 0.0;
+  m_band_ymax = 0.0;
+  m_step = 0.0;
+  m_pixels_per_unit = 0.0;
+  m_first = 0;
+  m_last = -1;
+  m_refined_first = 0;
+  m_refined_last = 0;
+}
+
+const std::vector<Sample>& SampleCache::samples() const {
+  return m_samples;
+}
+
+const std::vector<Sample>& SampleCache::curve() const {
+  return m_curve;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Core/Interval.hpp"
+
+namespace App::Core {
+
+class ThreadPool;
+
+struct Sample {
+  double x;
+  double y;
+};
+
+// World-space samples of one function, adapted to the screen resolution.
+//
+// The base samples lie on the dyadic grid `x = k * step`, where the step is the power of two
+// closest to one pixel column. The cache only evaluates grid points it does not already hold: a
+// static view costs nothing, a pan evaluates the newly exposed columns and a zoom keeps every
+// sample that still lies on the new grid (all of them when zooming in).
+//
+// Where the base samples bend by more than a fraction of a pixel, the interval between them is
+// bisected recursively, bounded by a per-update sample budget. Flat runs are merged again when
+// the curve is assembled, so the output grows with the screen width and the curve's detail,
+// not with the world-space range.
+//
+// Jumps (floor(x)) and poles (1/x, tan(x)) would otherwise be bisected to the full depth along
+// a line that is not part of the curve. Intervals where the change stays in one half, or flips
+// sign while growing, are instead narrowed down one sample per halving (at most
+// JUMP_SEARCH_DEPTH of them) and the curve is broken there with a non-finite sample, which the
+// polyline stages treat as a gap.
+//
+// Given bounds of the function (see Interval), intervals whose ends are both above or both
+// below the visible band are not refined where the bounds prove the curve stays out of it in
+// between: the polyline is clipped to the band anyway. They are refined once the band moves.
+//
+// When given a ThreadPool, large batches of evaluations are split into chunks across its
+// workers; the function must then be safe to call concurrently. New grid points are evaluated
+// through the batch function when one is given.
+class SampleCache {
+ public:
+  using Function = std::function<double(double)>;
+  // Optional dense path: evaluates `count` points of `x` into `y`.
+  using BatchFunction = std::function<void(const double* x, double* y, std::size_t count)>;
+  // Optional bounds of the function over [x0, x1].
+  using BoundsFunction = std::function<Interval(double x0, double x1)>;
+
+  // Vertical range the curve is drawn in, for culling; off without bounds.
+  struct Band {
+    double ymin;
+    double ymax;
+    BoundsFunction bounds;
+  };
+
+  // Hard bounds on the refinement work done by a single update.
+  static constexpr int MAX_REFINE_DEPTH{6};
+  static constexpr std::size_t REFINE_BUDGET_PER_SAMPLE{4};
+  // Halvings spent narrowing down a jump, which resolves it to 2^-16 of a grid step.
+  static constexpr int JUMP_SEARCH_DEPTH{16};
+  // Number of samples (or grid intervals) handed to a worker at once.
+  static constexpr std::size_t CHUNK_SIZE{256};
+
+  // Brings the cache in line with the visible range [xmin, xmax] drawn at `pixels_per_unit`.
+  // Returns the number of function evaluations that were needed.
+  std::size_t update(const Function& function,
+      double xmin,
+      double xmax,
+      double pixels_per_unit,
+      ThreadPool* pool = nullptr,
+      const BatchFunction& batch = nullptr,
+      const Band& band = {});
+  void invalidate();
+
+  // Grid step used for a given zoom: the power of two closest to one pixel.
+  [[nodiscard]] static double step_for(double pixels_per_unit);
+
+  // Base grid samples only.
+  [[nodiscard]] const std::vector<Sample>& samples() const;
+  // Base and refined samples with flat spans merged, ready to be drawn.
+  [[nodiscard]] const std::vector<Sample>& curve() const;
+
+ private:
+  void evaluate_missing(const Function& function, const BatchFunction& batch, ThreadPool* pool);
+  std::size_t refine_intervals(const Function& function,
+      const Band& band,
+      std::int64_t begin,
+      std::int64_t end,
+      std::size_t& budget,
+      std::vector<Sample>& out,
+      std::vector<std::int64_t>& culled) const;
+  std::size_t refine_range(const Function& function,
+      const Band& band,
+      std::int64_t begin,
+      std::int64_t end,
+      std::size_t& budget,
+      std::vector<Sample>& out,
+      std::vector<std::int64_t>& culled,
+      ThreadPool* pool);
+  std::size_t refine_culled(const Function& function, const Band& band, std::size_t& budget);
+  void build_curve();
+
+  double m_step{0.0};
+  double m_pixels_per_unit{0.0};
+  std::int64_t m_first{0};
+  std::int64_t m_last{-1};
+  std::vector<Sample> m_samples;
+  std::vector<Sample> m_scratch;
+  std::vector<std::size_t> m_missing;
+  std::vector<double> m_missing_x;
+  std::vector<double> m_missing_y;
+  std::vector<std::vector<Sample>> m_chunks;
+  std::vector<std::vector<std::int64_t>> m_culled_chunks;
+
+  // Refinement points (sorted by x) for the grid intervals [k, k + 1] with k in
+  // [m_refined_first, m_refined_last).
+  std::int64_t m_refined_first{0};
+  std::int64_t m_refined_last{0};
+  std::vector<Sample> m_refined;
+  // Grid intervals in that range left unrefined by culling (ascending), and the band they were
+  // culled against.
+  std::vector<std::int64_t> m_culled;
+  double m_band_ymin{0.0};
+  double m_band_ymax{0.0};
+
+  std::vector<Sample> m_curve;
+};
+
+}  // namespace App::Core
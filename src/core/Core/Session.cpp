@@ -0,0 +1,348 @@
+#include "Session.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+
+namespace App::Core {
+
+namespace {
+
+constexpr std::array<char, 8> BINARY_MAGIC{'I', 'm', 'G', 'r', 'a', 'p', 'h', 'S'};
+// Also tells byte orders apart: a file from the other one reads as an unknown version.
+constexpr std::uint32_t BINARY_VERSION{1};
+
+struct BinaryHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t row_count;
+  double center_x;
+  double center_y;
+  double pixels_per_unit;
+};
+
+// Offsets are from the start of the file, counts in elements.
+struct BinaryRow {
+  std::uint64_t text_offset;
+  std::uint64_t text_size;
+  std::uint64_t samples_offset;
+  std::uint64_t samples_count;
+  std::uint64_t segments_offset;
+  std::uint64_t segments_count;
+  std::uint64_t regions_offset;
+  std::uint64_t regions_count;
+  std::uint32_t color;
+  std::uint8_t visible;
+  std::uint8_t ordered_by_x;
+  std::array<std::uint8_t, 2> reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 40 && sizeof(BinaryRow) == 72);
+static_assert(std::is_trivially_copyable_v<Sample> &&
+              std::is_trivially_copyable_v<ImplicitPlot::Segment> &&
+              std::is_trivially_copyable_v<ImplicitPlot::Box>);
+
+// Whether `count` elements of `element_size` bytes at `offset` fit in a file of `size` bytes.
+bool in_bounds(
+    std::size_t size, std::uint64_t offset, std::uint64_t count, std::size_t element_size) {
+  return offset <= size && count <= (size - offset) / element_size;
+}
+
+// The same, and aligned for T, so the mapping can be read as T in place.
+template <typename T>
+bool in_bounds(const char* data, std::size_t size, std::uint64_t offset, std::uint64_t count) {
+  return count == 0 ||
+         (in_bounds(size, offset, count, sizeof(T)) &&
+             reinterpret_cast<std::uintptr_t>(data + offset) % alignof(T) == 0);  // NOLINT
+}
+
+template <typename T>
+std::span<const T> view_of(const char* data, std::uint64_t offset, std::uint64_t count) {
+  if (count == 0) {
+    return {};
+  }
+  // NOLINTNEXTLINE(*-reinterpret-cast): aligned, trivially copyable data written by save()
+  return {reinterpret_cast<const T*>(data + offset), static_cast<std::size_t>(count)};
+}
+
+std::string escape(std::string_view text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const char c : text) {
+    if (c == '\\') {
+      escaped += "\\\\";
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string unescape(std::string_view text) {
+  std::string unescaped;
+  unescaped.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '\\' && i + 1 < text.size()) {
+      ++i;
+      unescaped += text[i] == 'n' ? '\n' : text[i];
+    } else {
+      unescaped += text[i];
+    }
+  }
+  return unescaped;
+}
+
+bool parse_color(const std::string& hex, ImU32& color) {
+  unsigned int r{0};
+  unsigned int g{0};
+  unsigned int b{0};
+  unsigned int a{255};
+  if ((hex.size() != 7 && hex.size() != 9) || hex[0] != '#' ||
+      hex.find_first_not_of("0123456789abcdefABCDEF", 1) != std::string::npos) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cert-err34-c): the digits were checked above
+  std::sscanf(hex.c_str() + 1, "%02x%02x%02x%02x", &r, &g, &b, &a);
+  color = IM_COL32(r, g, b, a);
+  return true;
+}
+
+}  // namespace
+
+bool Session::load(const std::filesystem::path& path) {
+  APP_PROFILE_FUNCTION();
+
+  MappedFile file;
+  if (!file.open(path)) {
+    return false;
+  }
+
+  rows.clear();
+  center_x = 0.0;
+  center_y = 0.0;
+  pixels_per_unit = 100.0;
+
+  if (file.size() >= sizeof(BinaryHeader) &&
+      std::memcmp(file.data(), BINARY_MAGIC.data(), BINARY_MAGIC.size()) == 0) {
+    return load_binary(path, std::move(file));
+  }
+  m_file.close();
+  return load_text(path);
+}
+
+bool Session::load_text(const std::filesystem::path& path) {
+  std::ifstream file{path};
+  if (!file.is_open()) {
+    APP_WARN("Could not open session {}", path.generic_string());
+    return false;
+  }
+
+  std::string line;
+  for (std::size_t number = 1; std::getline(file, line); ++number) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream fields{line};
+    std::string keyword;
+    fields >> keyword;
+    if (keyword == "view") {
+      fields >> center_x >> center_y >> pixels_per_unit;
+      if (fields.fail() || !(pixels_per_unit > 0.0)) {
+        APP_WARN("{}:{}: expected 'view <center x> <center y> <pixels per unit>'",
+            path.generic_string(),
+            number);
+        return false;
+      }
+    } else if (keyword == "row") {
+      std::string hex;
+      int visible{1};
+      Row row{};
+      fields >> hex >> visible;
+      if (fields.fail() || !parse_color(hex, row.color) || (visible != 0 && visible != 1)) {
+        APP_WARN("{}:{}: expected 'row <#RRGGBB[AA]> <0|1> <text>'", path.generic_string(), number);
+        return false;
+      }
+      row.visible = visible == 1;
+      // The text is the rest of the line after one separating space.
+      const auto position{fields.tellg()};
+      if (position != std::istringstream::pos_type(-1)) {
+        const auto begin{static_cast<std::size_t>(position)};
+        row.text = unescape(std::string_view{line}.substr(std::min(begin + 1, line.size())));
+      }
+      rows.push_back(std::move(row));
+    } else {
+      APP_WARN("{}:{}: unknown entry '{}'", path.generic_string(), number, keyword);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Session::load_binary(const std::filesystem::path& path, MappedFile file) {
+  const char* data{file.data()};
+  const std::size_t size{file.size()};
+  BinaryHeader header{};
+  std::memcpy(&header, data, sizeof(BinaryHeader));
+  if (header.version != BINARY_VERSION || !(header.pixels_per_unit > 0.0) ||
+      !in_bounds(size, sizeof(BinaryHeader), header.row_count, sizeof(BinaryRow))) {
+    APP_WARN("Session {} has an unsupported version or is truncated", path.generic_string());
+    return false;
+  }
+  center_x = header.center_x;
+  center_y = header.center_y;
+  pixels_per_unit = header.pixels_per_unit;
+
+  rows.reserve(header.row_count);
+  for (std::size_t i = 0; i < header.row_count; ++i) {
+    BinaryRow record{};
+    std::memcpy(&record, data + sizeof(BinaryHeader) + i * sizeof(BinaryRow), sizeof(BinaryRow));
+    if (!in_bounds(size, record.text_offset, record.text_size, 1) ||
+        !in_bounds<Sample>(data, size, record.samples_offset, record.samples_count) ||
+        !in_bounds<ImplicitPlot::Segment>(
+            data, size, record.segments_offset, record.segments_count) ||
+        !in_bounds<ImplicitPlot::Box>(data, size, record.regions_offset, record.regions_count)) {
+      APP_WARN("Session {}: row {} points outside the file", path.generic_string(), i + 1);
+      rows.clear();
+      return false;
+    }
+
+    Row& row{rows.emplace_back()};
+    row.text.assign(data + record.text_offset, record.text_size);
+    row.color = record.color;
+    row.visible = record.visible != 0;
+    row.curve.samples = view_of<Sample>(data, record.samples_offset, record.samples_count);
+    row.curve.segments =
+        view_of<ImplicitPlot::Segment>(data, record.segments_offset, record.segments_count);
+    row.curve.regions =
+        view_of<ImplicitPlot::Box>(data, record.regions_offset, record.regions_count);
+    row.curve.ordered_by_x = record.ordered_by_x != 0;
+  }
+
+  m_file = std::move(file);
+  return true;
+}
+
+bool Session::save(const std::filesystem::path& path, Format format) const {
+  APP_PROFILE_FUNCTION();
+
+  if (format == Format::Binary) {
+    return save_binary(path);
+  }
+
+  std::ofstream file{path};
+  if (!file.is_open()) {
+    APP_WARN("Could not write session {}", path.generic_string());
+    return false;
+  }
+
+  std::array<char, 128> view{};
+  std::snprintf(view.data(),
+      view.size(),
+      "view %.17g %.17g %.17g\n",
+      center_x,
+      center_y,
+      pixels_per_unit);
+  file << view.data();
+  for (const auto& row : rows) {
+    std::array<char, 16> hex{};
+    std::snprintf(hex.data(),
+        hex.size(),
+        "#%02X%02X%02X%02X",
+        (row.color >> IM_COL32_R_SHIFT) & 0xFFU,
+        (row.color >> IM_COL32_G_SHIFT) & 0xFFU,
+        (row.color >> IM_COL32_B_SHIFT) & 0xFFU,
+        (row.color >> IM_COL32_A_SHIFT) & 0xFFU);
+    file << "row " << hex.data() << ' ' << (row.visible ? 1 : 0) << ' ' << escape(row.text)
+         << '\n';
+  }
+  return file.good();
+}
+
+bool Session::save_binary(const std::filesystem::path& path) const {
+  // Layout: header, row records, then every row's text and cached arrays.
+  std::vector<char> out(sizeof(BinaryHeader) + rows.size() * sizeof(BinaryRow));
+  std::vector<BinaryRow> records(rows.size());
+  const auto append{[&out](const void* bytes, std::size_t count) -> std::uint64_t {
+    if (count == 0) {
+      return 0;
+    }
+    out.resize((out.size() + 7) & ~std::size_t{7});
+    const std::size_t offset{out.size()};
+    out.resize(offset + count);
+    std::memcpy(out.data() + offset, bytes, count);
+    return offset;
+  }};
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    const Row& row{rows[i]};
+    BinaryRow& record{records[i]};
+    record.text_offset = append(row.text.data(), row.text.size());
+    record.text_size = row.text.size();
+    record.samples_offset = append(row.curve.samples.data(), row.curve.samples.size_bytes());
+    record.samples_count = row.curve.samples.size();
+    record.segments_offset = append(row.curve.segments.data(), row.curve.segments.size_bytes());
+    record.segments_count = row.curve.segments.size();
+    record.regions_offset = append(row.curve.regions.data(), row.curve.regions.size_bytes());
+    record.regions_count = row.curve.regions.size();
+    record.color = row.color;
+    record.visible = row.visible ? 1 : 0;
+    record.ordered_by_x = row.curve.ordered_by_x ? 1 : 0;
+  }
+
+  BinaryHeader header{};
+  header.magic = BINARY_MAGIC;
+  header.version = BINARY_VERSION;
+  header.row_count = static_cast<std::uint32_t>(rows.size());
+  header.center_x = center_x;
+  header.center_y = center_y;
+  header.pixels_per_unit = pixels_per_unit;
+  std::memcpy(out.data(), &header, sizeof(BinaryHeader));
+  if (!records.empty()) {
+    std::memcpy(out.data() + sizeof(BinaryHeader), records.data(), records.size() * sizeof(BinaryRow));
+  }
+
+  // Written next to the file and renamed over it, so a crash never leaves half a session.
+  std::filesystem::path temporary{path};
+  temporary += ".tmp";
+  {
+    std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file.good()) {
+      APP_WARN("Could not write session {}", temporary.generic_string());
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    APP_WARN("Could not write session {}: {}", path.generic_string(), error.message());
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace App::Core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Core/ImplicitPlot.hpp"
+#include "Core/MappedFile.hpp"
+#include "Core/SampleCache.hpp"
+
+namespace App::Core {
+
+// What a plot shows: the rows of the expression pane and the view, in one of two formats.
+//
+// Text, for hand-written sessions (e.g. for exports), one entry per line:
+//
+//   view <center x> <center y> <pixels per unit>
+//   row <#RRGGBB or #RRGGBBAA> <0 or 1 (visible)> <text>
+//
+// Rows are kept in order. In their text, newlines are written as "\n" and backslashes as
+// "\\". Blank lines and lines starting with '#' are ignored.
+//
+// Binary, which the app saves between launches: a header, a fixed-size record per row and the
+// payload, every array 8-byte aligned. It can also hold the last sampled curve of a row, so a
+// heavy session is drawn at once and resampled in the background. Loading maps the file and
+// the cached curves point straight into the mapping.
+struct Session {
+  enum class Format { Text, Binary };
+
+  // A sampled curve (see AsyncCurve::Curve), world space.
+  struct CachedCurve {
+    std::span<const Sample> samples;
+    std::span<const ImplicitPlot::Segment> segments;
+    std::span<const ImplicitPlot::Box> regions;
+    bool ordered_by_x{true};
+
+    [[nodiscard]] bool empty() const {
+      return samples.empty() && segments.empty() && regions.empty();
+    }
+  };
+
+  struct Row {
+    std::string text;
+    ImU32 color;
+    bool visible{true};
+    // After loading a binary session, points into its mapping and stays valid until the next
+    // load or the end of the session. To save one, point it at the curve to keep (binary only).
+    CachedCurve curve{};
+  };
+
+  std::vector<Row> rows;
+  double center_x{0.0};
+  double center_y{0.0};
+  double pixels_per_unit{100.0};
+
+  // Replaces the contents with the file's, in either format. Returns false (and logs why) if
+  // it cannot be read or is malformed.
+  bool load(const std::filesystem::path& path);
+  bool save(const std::filesystem::path& path, Format format = Format::Text) const;
+
+ private:
+  bool load_text(const std::filesystem::path& path);
+  bool load_binary(const std::filesystem::path& path, MappedFile file);
+  bool save_binary(const std::filesystem::path& path) const;
+
+  // Mapping of the last binary session loaded, which the cached curves point into.
+  MappedFile m_file;
+};
+
+}  // namespace App::Core
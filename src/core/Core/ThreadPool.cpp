@@ -0,0 +1,145 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "Core/Debug/Instrumentor.hpp"
+
+namespace App::Core {
+
+namespace {
+
+thread_local std::size_t current_slot_index{0};
+
+}  // namespace
+
+ThreadPool::ThreadPool() {
+  const unsigned int hardware_threads{std::thread::hardware_concurrency()};
+  const std::size_t worker_count{hardware_threads > 2 ? hardware_threads - 1 : 1};
+
+  m_workers.reserve(worker_count);
+  for (std::size_t i = 0; i < worker_count; ++i) {
+    m_workers.emplace_back([this, i] { worker_loop(i + 1); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::slot_count() const {
+  return m_workers.size() + 1;
+}
+
+std::size_t ThreadPool::current_slot() {
+  return current_slot_index;
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) {
+  const std::size_t helpers{std::min(count, slot_count()) - (count > 0 ? 1 : 0)};
+  if (helpers == 0) {
+    for (std::size_t i = 0; i < count; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  APP_PROFILE_SCOPE("ThreadPool::parallel_for");
+
+  // Shared with the helper tasks, which may only start after the call returned (queued behind
+  // other work): by then every index is taken and they exit without touching `body`.
+  struct Batch {
+    std::atomic<std::size_t> next{0};
+    std::size_t count;
+    const std::function<void(std::size_t)>* body;
+    std::size_t finished{0};
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  const auto batch{std::make_shared<Batch>()};
+  batch->count = count;
+  batch->body = &body;
+
+  const auto drain{[](Batch& work) {
+    std::size_t ran{0};
+    for (std::size_t i = work.next++; i < work.count; i = work.next++) {
+      (*work.body)(i);
+      ++ran;
+    }
+    if (ran > 0) {
+      const std::lock_guard lock(work.mutex);
+      work.finished += ran;
+      if (work.finished == work.count) {
+        work.done.notify_all();
+      }
+    }
+  }};
+
+  for (std::size_t i = 0; i < helpers; ++i) {
+    submit([batch, drain] { drain(*batch); });
+  }
+
+  // Only this batch is worked on here: the calling thread takes indices until none is left and
+  // then waits for the ones other threads already started. Running unrelated queued tasks
+  // instead would stack whole jobs (and their own nested loops) on top of this one.
+  drain(*batch);
+  std::unique_lock lock(batch->mutex);
+  batch->done.wait(lock, [&batch] { return batch->finished == batch->count; });
+}
+
+void ThreadPool::submit(Task task) {
+  {
+    const std::lock_guard lock(m_mutex);
+    m_tasks.push_back(std::move(task));
+  }
+  m_condition.notify_one();
+}
+
+bool ThreadPool::run_one() {
+  Task task;
+  {
+    const std::lock_guard lock(m_mutex);
+    if (m_tasks.empty()) {
+      return false;
+    }
+    task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::worker_loop(std::size_t slot) {
+  current_slot_index = slot;
+
+  while (true) {
+    Task task;
+    {
+      std::unique_lock lock(m_mutex);
+      m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+      if (m_stopping && m_tasks.empty()) {
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace App::Core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace App::Core {
+
+// Fixed set of worker threads shared by the evaluation pipeline. There is always at least one
+// worker, so submitted tasks run in the background even on a single core.
+//
+// Every thread that touches per-thread state (e.g. compiled expressions) does so through its
+// slot: workers own slots 1..N, any other thread uses slot 0. Only one non-worker thread may
+// evaluate at a time.
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool other) = delete;
+  ThreadPool& operator=(ThreadPool&& other) = delete;
+
+  static ThreadPool& get() {
+    static ThreadPool instance;
+    return instance;
+  }
+
+  // Number of slots, i.e. workers plus the calling thread.
+  [[nodiscard]] std::size_t slot_count() const;
+  [[nodiscard]] static std::size_t current_slot();
+
+  // Calls `body(index)` for every index in [0, count) across the workers and the calling
+  // thread, and returns once all of them are done. Safe to nest: the calling thread works
+  // through the indices itself and then only waits for those other threads have started, so
+  // it never blocks on helpers still in the queue and never runs unrelated tasks.
+  void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+
+  // Queues a task to run on one of the workers and returns immediately.
+  void submit(Task task);
+
+  // Runs one queued task on the calling thread, if there is one. Threads waiting for
+  // background work call it to help instead of spinning, so waiting on every slot at once
+  // (e.g. one headless export per slot) cannot starve the queue.
+  bool run_one();
+
+ private:
+  ThreadPool();
+  ~ThreadPool();
+
+  void worker_loop(std::size_t slot);
+
+  std::vector<std::thread> m_workers;
+  std::deque<Task> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping{false};
+};
+
+}  // namespace App::Core
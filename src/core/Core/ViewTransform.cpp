@@ -0,0 +1,57 @@
+#include "ViewTransform.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace App::Core {
+
+ViewTransform::ViewTransform(double center_x, double center_y, double pixels_per_unit)
+    : m_center_x(center_x), m_center_y(center_y), m_pixels_per_unit(pixels_per_unit) {
+  clamp_zoom();
+}
+
+ImVec2 ViewTransform::to_screen(double x, double y) const {
+  return {static_cast<float>((x - m_center_x) * m_pixels_per_unit),
+      static_cast<float>((m_center_y - y) * m_pixels_per_unit)};
+}
+
+double ViewTransform::to_world_x(double dx) const {
+  return m_center_x + dx / m_pixels_per_unit;
+}
+
+double ViewTransform::to_world_y(double dy) const {
+  return m_center_y - dy / m_pixels_per_unit;
+}
+
+void ViewTransform::pan(double dx, double dy) {
+  m_center_x -= dx / m_pixels_per_unit;
+  m_center_y += dy / m_pixels_per_unit;
+  // Far out, the zoom may no longer be representable.
+  clamp_zoom();
+}
+
+void ViewTransform::zoom_at(double dx, double dy, double factor) {
+  const double x{to_world_x(dx)};
+  const double y{to_world_y(dy)};
+  m_pixels_per_unit *= factor;
+  clamp_zoom();
+  m_center_x = x - dx / m_pixels_per_unit;
+  m_center_y = y + dy / m_pixels_per_unit;
+}
+
+double ViewTransform::max_pixels_per_unit() const {
+  const double magnitude{std::max({std::abs(m_center_x), std::abs(m_center_y), 1.0})};
+  return 1.0 / (MIN_PIXEL_ULPS * magnitude * std::numeric_limits<double>::epsilon());
+}
+
+void ViewTransform::clamp_zoom() {
+  // Beyond |center| ~ 1e16 even MIN_PIXELS_PER_UNIT is finer than the precision left, and the
+  // lower bound wins.
+  const double upper{std::max(max_pixels_per_unit(), MIN_PIXELS_PER_UNIT)};
+  m_pixels_per_unit = std::clamp(m_pixels_per_unit, MIN_PIXELS_PER_UNIT, upper);
+}
+
+}  // namespace App::Core
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <imgui.h>
+
+namespace App::Core {
+
+// World <-> screen mapping of the graph view.
+//
+// The view is kept as its center in world units and a zoom, rather than as the screen position
+// of the world origin: at deep zoom or far from the origin, that position and the products
+// x * zoom no longer fit a float, and the curves jitter as they are rounded. Screen points are
+// computed relative to the center (or another anchor near the view) in double precision and
+// only narrowed to float once they are small.
+//
+// The zoom range is bounded by the precision left at the center rather than by fixed limits: a
+// pixel always spans at least MIN_PIXEL_ULPS units in the last place of the center coordinates,
+// so neighbouring pixel columns still evaluate distinct x values and the sampling grid and tick
+// indices stay well within 64 bits.
+class ViewTransform {
+ public:
+  static constexpr double MIN_PIXELS_PER_UNIT{1.0e-6};
+  static constexpr double MIN_PIXEL_ULPS{256.0};
+
+  ViewTransform() = default;
+  ViewTransform(double center_x, double center_y, double pixels_per_unit);
+
+  // Offset in pixels of world point (x, y) from the view center, y pointing down.
+  [[nodiscard]] ImVec2 to_screen(double x, double y) const;
+  // World coordinates of the point `dx`, `dy` pixels away from the view center.
+  [[nodiscard]] double to_world_x(double dx) const;
+  [[nodiscard]] double to_world_y(double dy) const;
+
+  // Follows a drag of (dx, dy) pixels.
+  void pan(double dx, double dy);
+  // Multiplies the zoom by `factor`, keeping the world point under (dx, dy) (pixels from the
+  // view center) in place.
+  void zoom_at(double dx, double dy, double factor);
+
+  // Largest zoom at which the current center keeps MIN_PIXEL_ULPS per pixel. It falls below
+  // MIN_PIXELS_PER_UNIT for huge centers, where the zoom is held at MIN_PIXELS_PER_UNIT.
+  [[nodiscard]] double max_pixels_per_unit() const;
+
+  [[nodiscard]] double center_x() const {
+    return m_center_x;
+  }
+  [[nodiscard]] double center_y() const {
+    return m_center_y;
+  }
+  [[nodiscard]] double pixels_per_unit() const {
+    return m_pixels_per_unit;
+  }
+
+ private:
+  void clamp_zoom();
+
+  double m_center_x{0.0};
+  double m_center_y{0.0};
+  double m_pixels_per_unit{100.0};
+};
+
+}  // namespace App::Core
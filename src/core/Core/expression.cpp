@@ -0,0 +1,575 @@
+#include "expression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Constants.hpp"
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Debug/PerfStats.hpp"
+#include "funcs.hpp"
+
+namespace App::Core {
+
+namespace {
+
+// Names bound by some kind of row, which therefore cannot be defined.
+constexpr std::array<std::string_view, 5> VARIABLE_NAMES{"x", "y", "r", "t", "theta"};
+
+// Deepest nesting of function calls that is expanded, which also ends recursive definitions.
+constexpr int MAX_EXPANSION_DEPTH{16};
+
+// What a row compiles to.
+struct Rewrite {
+  CompiledExpression::Kind kind{CompiledExpression::Kind::Explicit};
+  std::string source;
+  std::string y_source;    // y(t) of parametric curves
+  std::string domain_min;  // curves only; empty for the default domain
+  std::string domain_max;
+};
+
+// Bytes >= 0x80 belong to UTF-8 sequences such as `π`.
+bool is_name_char(char c) {
+  const auto byte{static_cast<unsigned char>(c)};
+  return std::isalnum(byte) != 0 || c == '_' || byte >= 0x80;
+}
+
+// A name that can be defined: ASCII letters, digits and '_', not starting with a digit.
+bool is_definable_name(std::string_view text) {
+  return !text.empty() && std::isdigit(static_cast<unsigned char>(text.front())) == 0 &&
+         std::all_of(text.begin(), text.end(), [](char c) {
+           return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+         });
+}
+
+// End of the number or name starting at `begin`, or `begin` if there is neither.
+std::size_t token_end(std::string_view text, std::size_t begin) {
+  const auto is_digit{[text](std::size_t i) {
+    return i < text.size() && std::isdigit(static_cast<unsigned char>(text[i])) != 0;
+  }};
+  std::size_t end{begin};
+  if (is_digit(begin) || (text[begin] == '.' && is_digit(begin + 1))) {
+    while (is_digit(end) || (end < text.size() && text[end] == '.')) {
+      ++end;
+    }
+    // The exponent belongs to the number: the `e` of "1e5" is not the constant.
+    if (end < text.size() && (text[end] == 'e' || text[end] == 'E')) {
+      std::size_t exponent{end + 1};
+      if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-')) {
+        ++exponent;
+      }
+      if (is_digit(exponent)) {
+        end = exponent;
+        while (is_digit(end)) {
+          ++end;
+        }
+      }
+    }
+    return end;
+  }
+  while (end < text.size() && is_name_char(text[end])) {
+    ++end;
+  }
+  return end;
+}
+
+bool mentions(std::string_view source, std::string_view name) {
+  for (std::size_t i = 0; i < source.size();) {
+    const std::size_t end{token_end(source, i)};
+    if (end == i) {
+      ++i;
+      continue;
+    }
+    if (source.substr(i, end - i) == name) {
+      return true;
+    }
+    i = end;
+  }
+  return false;
+}
+
+// Splits the arguments of the call whose '(' is at `open` into `arguments`. Returns the index
+// of the matching ')', or npos if there is none.
+std::size_t split_arguments(
+    std::string_view text, std::size_t open, std::vector<std::string>& arguments) {
+  arguments.clear();
+  int depth = 0;
+  std::size_t begin{open + 1};
+  for (std::size_t i = open; i < text.size(); ++i) {
+    if (text[i] == '(') {
+      ++depth;
+    } else if (text[i] == ')') {
+      if (--depth == 0) {
+        arguments.push_back(trim(std::string{text.substr(begin, i - begin)}));
+        return i;
+      }
+    } else if (text[i] == ',' && depth == 1) {
+      arguments.push_back(trim(std::string{text.substr(begin, i - begin)}));
+      begin = i + 1;
+    }
+  }
+  return std::string::npos;
+}
+
+// `body` with every name in `names` replaced by the matching value, in parentheses.
+std::string substitute(std::string_view body,
+    const std::vector<std::string>& names,
+    const std::vector<std::string>& values) {
+  std::string out;
+  out.reserve(body.size());
+  for (std::size_t i = 0; i < body.size();) {
+    const std::size_t end{token_end(body, i)};
+    if (end == i) {
+      out += body[i++];
+      continue;
+    }
+    const std::string_view token{body.substr(i, end - i)};
+    const auto name{std::find(names.begin(), names.end(), token)};
+    if (name == names.end()) {
+      out += token;
+    } else {
+      out += '(';
+      out += values[static_cast<std::size_t>(name - names.begin())];
+      out += ')';
+    }
+    i = end;
+  }
+  return out;
+}
+
+std::size_t find_top_level_equals_equals(const std::string& source) {
+  int depth = 0;
+  for (std::size_t i = 0; i + 1 < source.size(); ++i) {
+    if (source[i] == '(') {
+      ++depth;
+    } else if (source[i] == ')') {
+      --depth;
+    } else if (depth == 0 && source[i] == '=' && source[i + 1] == '=') {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
+// Index of the top-level comma of "(a, b)", or npos if `text` is not such a pair.
+std::size_t find_pair_comma(const std::string& text) {
+  if (text.size() < 2 || text.front() != '(' || text.back() != ')') {
+    return std::string::npos;
+  }
+  int depth = 0;
+  std::size_t comma = std::string::npos;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '(') {
+      ++depth;
+    } else if (text[i] == ')') {
+      --depth;
+      if (depth == 0 && i + 1 != text.size()) {
+        return std::string::npos;  // "(a)(b)": the outer parentheses do not match
+      }
+    } else if (depth == 1 && text[i] == ',' && comma == std::string::npos) {
+      comma = i;
+    }
+  }
+  return comma;
+}
+
+// Splits a trailing "{min <= name <= max}" (or with "<") off `text`. Returns the parameter
+// name, or an empty string (leaving `text` alone) if there is no such suffix.
+std::string split_domain(std::string& text, std::string& min, std::string& max) {
+  const std::size_t open{text.rfind('{')};
+  if (text.empty() || text.back() != '}' || open == std::string::npos) {
+    return {};
+  }
+  const std::string inner{text.substr(open + 1, text.size() - open - 2)};
+  const std::size_t first{inner.find('<')};
+  const std::size_t second{first == std::string::npos ? first : inner.find('<', first + 1)};
+  if (second == std::string::npos) {
+    return {};
+  }
+  const auto after{[&inner](std::size_t position) {
+    return position + 1 < inner.size() && inner[position + 1] == '=' ? position + 2
+                                                                      : position + 1;
+  }};
+
+  min = trim(inner.substr(0, first));
+  std::string name{trim(inner.substr(after(first), second - after(first)))};
+  max = trim(inner.substr(after(second)));
+  text = trim(text.substr(0, open));
+  return name;
+}
+
+// Replaces every UTF-8 "θ" with "theta", the name exprtk knows it by.
+std::string spell_theta(const std::string& text) {
+  static constexpr std::string_view THETA{"\xCE\xB8"};
+  std::string spelled;
+  spelled.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text.compare(i, THETA.size(), THETA) == 0) {
+      spelled += "theta";
+      i += THETA.size() - 1;
+    } else {
+      spelled += text[i];
+    }
+  }
+  return spelled;
+}
+
+// Decides how a row is plotted and rewrites it into the expression(s) that get compiled:
+//   "f(x)" and "y = f(x)"        -> explicit f(x)
+//   "lhs = rhs" / "lhs == rhs"   -> implicit (lhs) - (rhs), plotted where it is zero
+//   "x^2 + y^2 < 1"              -> region, plotted where the comparison holds
+//   "(f(t), g(t))"               -> parametric curve over t
+//   "r = f(theta)" (or θ)        -> polar curve over theta
+// Curves take an optional domain suffix such as "{0 <= t <= 4*pi}".
+Rewrite classify(const std::string& text) {
+  Rewrite rewrite;
+  const std::string trimmed{trim(spell_theta(text))};
+
+  std::string body{trimmed};
+  const std::string parameter{split_domain(body, rewrite.domain_min, rewrite.domain_max)};
+
+  const std::size_t comma{find_pair_comma(body)};
+  if (comma != std::string::npos && (parameter.empty() || parameter == "t")) {
+    rewrite.kind = CompiledExpression::Kind::Parametric;
+    rewrite.source = trim(body.substr(1, comma - 1));
+    rewrite.y_source = trim(body.substr(comma + 1, body.size() - comma - 2));
+    return rewrite;
+  }
+
+  const std::size_t equals{findTopLevelEquals(body)};
+  if (equals != std::string::npos && trim(body.substr(0, equals)) == "r" &&
+      (parameter.empty() || parameter == "theta")) {
+    rewrite.kind = CompiledExpression::Kind::Polar;
+    rewrite.source = trim(body.substr(equals + 1));
+    return rewrite;
+  }
+
+  // Not a curve: a domain suffix is left in and fails to compile.
+  rewrite.domain_min.clear();
+  rewrite.domain_max.clear();
+
+  std::size_t split{findTopLevelEquals(trimmed)};
+  std::size_t width{1};
+  if (split == std::string::npos && hasEqualsEqualsOperator(trimmed)) {
+    split = find_top_level_equals_equals(trimmed);
+    width = 2;
+  }
+
+  if (split != std::string::npos) {
+    const std::string lhs{trim(trimmed.substr(0, split))};
+    const std::string rhs{trim(trimmed.substr(split + width))};
+    if (lhs == "y" && !mentions(rhs, "y")) {
+      rewrite.source = rhs;
+      return rewrite;
+    }
+    rewrite.kind = CompiledExpression::Kind::Implicit;
+    rewrite.source = "(" + lhs + ") - (" + rhs + ")";
+    return rewrite;
+  }
+
+  rewrite.source = trimmed;
+  if (hasInequalityOperator(trimmed)) {
+    rewrite.kind = CompiledExpression::Kind::Region;
+  }
+  return rewrite;
+}
+
+// Value of a constant expression such as "2*pi" (NaN if it does not compile).
+double evaluate_constant(const std::string& text) {
+  if (mentions(text, "x")) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  CompiledExpression constant{text};
+  return constant.evaluate(0.0);
+}
+
+}  // namespace
+
+// "name = constant" defines a parameter and "name(a, b) = body" a function, unless the name is
+// taken by a variable, a constant or exprtk itself ("sin(x) = y" stays an equation).
+ExpressionList::Definition ExpressionList::parse_definition(const std::string& text) {
+  const std::string trimmed{trim(text)};
+  const std::size_t equals{findTopLevelEquals(trimmed)};
+  if (equals == std::string::npos) {
+    return {};
+  }
+  const std::string lhs{trim(trimmed.substr(0, equals))};
+  const std::size_t open{lhs.find('(')};
+  const std::string name{trim(lhs.substr(0, open))};
+  if (!is_definable_name(name) || Constants::find(name) != nullptr ||
+      std::find(VARIABLE_NAMES.begin(), VARIABLE_NAMES.end(), name) != VARIABLE_NAMES.end()) {
+    return {};
+  }
+
+  Definition definition;
+  definition.body = trim(trimmed.substr(equals + 1));
+  if (open == std::string::npos) {
+    if (CompiledExpression{name}.is_valid()) {
+      return {};  // e.g. `true`
+    }
+    definition.name = name;
+    definition.value = evaluate_constant(definition.body);
+    return definition;
+  }
+
+  if (split_arguments(lhs, open, definition.arguments) + 1 != lhs.size() ||
+      !std::all_of(
+          definition.arguments.begin(), definition.arguments.end(), is_definable_name)) {
+    return {};
+  }
+  std::string probe{name + "("};
+  for (std::size_t k = 0; k < definition.arguments.size(); ++k) {
+    probe += k == 0 ? "0" : ", 0";
+  }
+  probe += ")";
+  if (CompiledExpression{probe}.is_valid()) {
+    return {};
+  }
+  definition.name = name;
+  definition.function = true;
+  return definition;
+}
+
+std::size_t ExpressionList::size() const {
+  return rows.size();
+}
+
+std::size_t ExpressionList::add(std::string_view text, ImU32 row_color) {
+  Expression& row{rows.emplace_back()};
+  row.expr = text;
+  row.id = m_next_id++;
+  visible.push_back(1);
+  color.push_back(row_color);
+  thickness.push_back(1.0F);
+  compiled.emplace_back();
+  curve.emplace_back();
+  geometry.emplace_back();
+  return rows.size() - 1;
+}
+
+bool ExpressionList::compile(std::size_t i) {
+  Expression& row{rows[i]};
+  const bool current{compiled[i] != nullptr && row.definitions == m_definitions};
+  if (!row.dirty && current) {
+    return false;
+  }
+  row.dirty = false;
+
+  const std::string_view source{row.expr};
+  const std::size_t hash{std::hash<std::string_view>{}(source)};
+  if (current && hash == row.source_hash && source == row.compiled_source) {
+    return false;
+  }
+
+  APP_PROFILE_SCOPE("ExpressionList::compile");
+  const Debug::StageTimer timer{Debug::PerfStats::Stage::Parse};
+  const Definition definition{parse_definition(row.expr)};
+  const bool defined{define(row, definition)};
+  row.source_hash = hash;
+  row.compiled_source = row.expr;
+  row.definitions = m_definitions;
+
+  // Definitions only compile to validate them: the value, or a call with x for every argument.
+  // One that cannot be defined compiles the empty text and shows as invalid.
+  if (!definition.name.empty()) {
+    std::string check;
+    if (defined && definition.function) {
+      std::string call{definition.name + "("};
+      for (std::size_t k = 0; k < definition.arguments.size(); ++k) {
+        call += k == 0 ? "x" : ", x";
+      }
+      call += ")";
+      if (!expand(call, check)) {
+        check.clear();
+      }
+    } else if (defined && !std::isnan(definition.value)) {
+      check = definition.body;
+    }
+    compiled[i] = std::make_shared<CompiledExpression>(
+        check, CompiledExpression::Kind::Definition, parameters);
+    return true;
+  }
+
+  std::string expanded;
+  if (!expand(row.expr, expanded)) {
+    expanded.clear();
+  }
+  const Rewrite rewrite{classify(expanded)};
+  if (rewrite.kind == CompiledExpression::Kind::Parametric ||
+      rewrite.kind == CompiledExpression::Kind::Polar) {
+    CompiledExpression::Domain domain{CompiledExpression::DEFAULT_DOMAIN};
+    if (!rewrite.domain_min.empty()) {
+      domain = {evaluate_constant(rewrite.domain_min), evaluate_constant(rewrite.domain_max)};
+    }
+    compiled[i] = std::make_shared<CompiledExpression>(
+        rewrite.source, rewrite.y_source, rewrite.kind, domain, parameters);
+  } else {
+    compiled[i] = std::make_shared<CompiledExpression>(rewrite.source, rewrite.kind, parameters);
+  }
+  return true;
+}
+
+std::uint64_t ExpressionList::definitions() const {
+  return m_definitions;
+}
+
+std::size_t ExpressionList::parameter(std::size_t i) const {
+  const Expression& row{rows[i]};
+  return row.defines.empty() || row.defines_function ? Parameters::NONE
+                                                     : parameters->find(row.defines);
+}
+
+void ExpressionList::set_parameter(std::size_t i, double value) {
+  const std::size_t id{parameter(i)};
+  if (id == Parameters::NONE) {
+    return;
+  }
+  parameters->set(id, value);
+
+  // The text follows the value, recorded as compiled so that compile() sees nothing to do:
+  // the parameter is bound by reference, so the program already reads the new value.
+  std::array<char, 32> digits{};
+  // The shortest text that reads back as `value`, so that recompiling it changes nothing.
+  const auto result{std::to_chars(digits.data(), digits.data() + digits.size(), value)};
+  Expression& row{rows[i]};
+  row.expr.assign(row.defines);
+  row.expr.append(" = ");
+  row.expr.append(digits.data(), result.ptr);
+  row.source_hash = std::hash<std::string_view>{}(row.expr);
+  row.compiled_source = row.expr;
+}
+
+bool ExpressionList::animate(double seconds) {
+  bool playing{false};
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    ParameterSlider& slider{rows[i].slider};
+    const std::size_t id{slider.playing ? parameter(i) : Parameters::NONE};
+    if (id == Parameters::NONE || !(slider.max > slider.min) || !(slider.period > 0.0)) {
+      continue;
+    }
+    playing = true;
+
+    // Bounces off the ends of the range.
+    const double step{(slider.max - slider.min) * seconds / slider.period};
+    double value{std::clamp(parameters->value(id), slider.min, slider.max)};
+    value += slider.descending ? -step : step;
+    if (value >= slider.max) {
+      value = slider.max;
+      slider.descending = true;
+    } else if (value <= slider.min) {
+      value = slider.min;
+      slider.descending = false;
+    }
+    set_parameter(i, value);
+  }
+  return playing;
+}
+
+bool ExpressionList::define(Expression& row, const Definition& definition) {
+  const bool same{!definition.name.empty() && row.defines == definition.name &&
+                  row.defines_function == definition.function};
+  if (!same) {
+    release(row);
+  }
+  if (definition.name.empty()) {
+    return true;
+  }
+  if (!same && (m_functions.contains(definition.name) ||
+                   parameters->find(definition.name) != Parameters::NONE)) {
+    return false;  // defined by another row
+  }
+
+  if (definition.function) {
+    Function& function{m_functions[definition.name]};
+    if (!same || function.arguments != definition.arguments || function.body != definition.body) {
+      function = {definition.arguments, definition.body};
+      ++m_definitions;
+    }
+  } else if (std::isnan(definition.value)) {
+    // Keeps the last value while the text is being edited.
+    return same;
+  } else if (same) {
+    // Only the value changed: the rows reading it resample, none recompiles.
+    parameters->set(parameters->find(definition.name), definition.value);
+  } else if (parameters->define(definition.name, definition.value) == Parameters::NONE) {
+    return false;
+  } else {
+    ++m_definitions;
+  }
+  row.defines = definition.name;
+  row.defines_function = definition.function;
+  return true;
+}
+
+void ExpressionList::release(Expression& row) {
+  if (row.defines.empty()) {
+    return;
+  }
+  if (row.defines_function) {
+    m_functions.erase(row.defines);
+  } else {
+    parameters->undefine(parameters->find(row.defines));
+  }
+  row.defines.clear();
+  row.defines_function = false;
+  ++m_definitions;
+}
+
+bool ExpressionList::expand(std::string_view text, std::string& out, int depth) const {
+  if (depth > MAX_EXPANSION_DEPTH) {
+    return false;
+  }
+  out.clear();
+  if (m_functions.empty()) {
+    out = text;
+    return true;
+  }
+
+  std::vector<std::string> arguments;
+  std::string body;
+  for (std::size_t i = 0; i < text.size();) {
+    const std::size_t end{token_end(text, i)};
+    if (end == i) {
+      out += text[i++];
+      continue;
+    }
+    const std::string_view token{text.substr(i, end - i)};
+    std::size_t open{end};
+    while (open < text.size() && std::isspace(static_cast<unsigned char>(text[open])) != 0) {
+      ++open;
+    }
+    const auto function{m_functions.find(std::string{token})};
+    if (function == m_functions.end() || open == text.size() || text[open] != '(') {
+      out += token;
+      i = end;
+      continue;
+    }
+
+    // The call becomes the body, in parentheses, with the arguments substituted (and then
+    // expanded along with the rest of the body).
+    const std::size_t close{split_arguments(text, open, arguments)};
+    if (close == std::string::npos || arguments.size() != function->second.arguments.size() ||
+        !expand(substitute(function->second.body, function->second.arguments, arguments),
+            body,
+            depth + 1)) {
+      return false;
+    }
+    out += '(';
+    out += body;
+    out += ')';
+    i = close + 1;
+  }
+  return true;
+}
+
+}  // namespace App::Core
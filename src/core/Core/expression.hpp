@@ -1,15 +1,129 @@
 #pragma once
-#include <array>
+#include <imgui.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/CompiledExpression.hpp"
+#include "Core/CurveGeometry.hpp"
+#include "Core/Parameters.hpp"
 
 namespace App::Core {
 
+// Slider of a row that defines a parameter. Playing sweeps the value back and forth between
+// `min` and `max`, once per `period` seconds in each direction.
+struct ParameterSlider {
+  double min = -10.0;
+  double max = 10.0;
+  double period = 4.0;
+  bool playing = false;
+  bool descending = false;
+};
+
+// Editing state of one row of the expression pane.
 struct Expression {
-    std::array<char, 1024> expr;  // expression as char array
-    std::string color;            // color (hex or name)
-    bool visible = true;          // whether to render/display
-    float thickness = 1.0f;       // optional, for graphing line width
-    int id = -1;                  // optional identifier
+  std::string expr;  // source text, grown by the text field's resize callback
+  int id = -1;       // stable for the row's lifetime, used as its ImGui ID
+
+  // Text the row was last compiled from, and its hash as a quick pre-check. Set `dirty`
+  // whenever the text is edited; ExpressionList::compile() then recompiles if it differs.
+  std::string compiled_source;
+  std::size_t source_hash = 0;
+  bool dirty = true;
+  // Definitions revision of the list the row was last compiled against (see ExpressionList).
+  std::uint64_t definitions = 0;
+  // Name of the parameter or function the row defines, if any.
+  std::string defines;
+  bool defines_function = false;
+  ParameterSlider slider;
+};
+
+// All rows of the expression pane, stored as a structure of arrays.
+//
+// `rows` holds what only the editor touches. The state the plot loop reads every frame lives in
+// parallel dense arrays (one entry per row, same order), so walking it neither strides over
+// source text nor over state of the other stages.
+//
+// Rows can also define names for the others: "a = 2" a parameter (any name that is not a
+// variable or constant, with a constant value), "f(x, n) = x^n" a function. Calls of defined
+// functions are expanded into the text before it is compiled, so both backends see plain
+// expressions; parameters are bound by reference, so editing a value only resamples the rows
+// that read it. Adding, removing or redefining a name recompiles every row once.
+struct ExpressionList {
+  static constexpr ImU32 DEFAULT_COLOR{IM_COL32(199, 68, 64, 255)};
+
+  std::vector<Expression> rows;
+  std::vector<std::uint8_t> visible;  // whether to plot the row
+  std::vector<ImU32> color;           // RGBA, parsed once (see PlotPipeline::parse_color)
+  std::vector<float> thickness;       // multiplier of the plot's line thickness
+  // Compiled form of the row's text, rebuilt only when the text changes. Text with a top-level
+  // `=` (other than `y = f(x)`) compiles as an implicit equation and text with a comparison as
+  // a region, both in `x` and `y`. "(f(t), g(t))" is a parametric and "r = f(theta)" a polar
+  // curve, optionally followed by a domain like "{0 <= t <= 4*pi}" (default [0, 2 pi]).
+  std::vector<std::shared_ptr<CompiledExpression>> compiled;
+  // Background sampler (or contourer) of `compiled`; its cache resets whenever `compiled` is
+  // rebuilt.
+  std::vector<AsyncCurve> curve;
+  // Tessellated `curve`, translated on pan instead of rebuilt.
+  std::vector<CurveGeometry> geometry;
+  // Values of the parameters defined by the rows, shared with everything compiled from them.
+  std::shared_ptr<Parameters> parameters{std::make_shared<Parameters>()};
+
+  [[nodiscard]] std::size_t size() const;
+
+  // Appends a visible row and returns its index.
+  std::size_t add(std::string_view text, ImU32 row_color = DEFAULT_COLOR);
+
+  // Recompiles row `i` if its text or the definitions changed. Returns true if a new
+  // CompiledExpression was built.
+  bool compile(std::size_t i);
+
+  // Increases whenever the set of defined names (or a function body) changes.
+  [[nodiscard]] std::uint64_t definitions() const;
+
+  // Id (in `parameters`) of the parameter row `i` defines, or Parameters::NONE.
+  [[nodiscard]] std::size_t parameter(std::size_t i) const;
+  // Sets the parameter row `i` defines to `value` and rewrites the row's text to match. Nothing
+  // is recompiled; only the rows that read the parameter resample.
+  void set_parameter(std::size_t i, double value);
+  // Advances the playing sliders by `seconds`. Returns true if any is playing.
+  bool animate(double seconds);
+
+ private:
+  struct Function {
+    std::vector<std::string> arguments;
+    std::string body;
+  };
+  // What a row defines, parsed from its text.
+  struct Definition {
+    std::string name;  // empty if the row defines nothing
+    bool function{false};
+    std::vector<std::string> arguments;  // functions only
+    std::string body;
+    double value{0.0};  // parameters only; NaN if the body is not a constant expression
+  };
+
+  [[nodiscard]] static Definition parse_definition(const std::string& text);
+
+  // Makes `row` define what `definition` describes (or nothing). Returns false if it cannot,
+  // e.g. because another row already defines the name.
+  bool define(Expression& row, const Definition& definition);
+  // Drops whatever `row` defines.
+  void release(Expression& row);
+  // Replaces calls of the defined functions in `text` by their bodies. Returns false on calls
+  // with the wrong number of arguments or nested too deep (recursive definitions).
+  bool expand(std::string_view text, std::string& out, int depth = 0) const;
+
+  int m_next_id{0};
+  std::unordered_map<std::string, Function> m_functions;
+  // Bumped whenever a name is defined or dropped or a function body changes.
+  std::uint64_t m_definitions{0};
 };
 
-}  // namespace App::Core
\ No newline at end of file
+}  // namespace App::Core
@@ -0,0 +1,67 @@
+#include "Core/MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+
+namespace App {
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const std::filesystem::path& path) {
+  APP_PROFILE_FUNCTION();
+
+  close();
+  const int descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (descriptor < 0) {
+    APP_ERROR("Could not open {}: {}", path.string(), std::strerror(errno));
+    return false;
+  }
+
+  struct stat status {};
+  if (::fstat(descriptor, &status) != 0) {
+    APP_ERROR("Could not stat {}: {}", path.string(), std::strerror(errno));
+    ::close(descriptor);
+    return false;
+  }
+
+  const auto size{static_cast<std::size_t>(status.st_size)};
+  if (size > 0) {
+    void* data{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+    if (data == MAP_FAILED) {
+      APP_ERROR("Could not map {}: {}", path.string(), std::strerror(errno));
+      ::close(descriptor);
+      return false;
+    }
+    // Parsed front to back, once.
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(data);
+    m_size = size;
+  }
+
+  // The map keeps its own reference to the file.
+  ::close(descriptor);
+  return true;
+}
+
+void MappedFile::close() {
+  if (m_data != nullptr) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): munmap takes a mutable pointer
+    ::munmap(const_cast<char*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+}
+
+}  // namespace App
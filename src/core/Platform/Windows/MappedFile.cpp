@@ -0,0 +1,78 @@
+#include "Core/MappedFile.hpp"
+
+#include <windows.h>
+
+#include <cstddef>
+#include <filesystem>
+
+#include "Core/Debug/Instrumentor.hpp"
+#include "Core/Log.hpp"
+
+namespace App {
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const std::filesystem::path& path) {
+  APP_PROFILE_FUNCTION();
+
+  close();
+  // Shared for writing, so a logger can keep appending while the file is mapped.
+  HANDLE file{CreateFileW(path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr)};
+  if (file == INVALID_HANDLE_VALUE) {
+    APP_ERROR("Could not open {} (error {})", path.string(), GetLastError());
+    return false;
+  }
+
+  LARGE_INTEGER size{};
+  if (GetFileSizeEx(file, &size) == 0) {
+    APP_ERROR("Could not get the size of {} (error {})", path.string(), GetLastError());
+    CloseHandle(file);
+    return false;
+  }
+  if (size.QuadPart == 0) {
+    CloseHandle(file);
+    return true;
+  }
+
+  HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+  // The mapping keeps its own reference to the file.
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    APP_ERROR("Could not map {} (error {})", path.string(), GetLastError());
+    return false;
+  }
+
+  const void* data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+  if (data == nullptr) {
+    APP_ERROR("Could not map {} (error {})", path.string(), GetLastError());
+    CloseHandle(mapping);
+    return false;
+  }
+
+  m_data = static_cast<const char*>(data);
+  m_size = static_cast<std::size_t>(size.QuadPart);
+  m_mapping = mapping;
+  return true;
+}
+
+void MappedFile::close() {
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping != nullptr) {
+    CloseHandle(m_mapping);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_mapping = nullptr;
+}
+
+}  // namespace App
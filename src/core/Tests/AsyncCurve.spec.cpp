@@ -0,0 +1,137 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/CompiledExpression.hpp"
+#include "Core/ThreadPool.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+using App::Core::AsyncCurve;
+
+// Occupies every worker until released, so requests queue up behind it.
+class BlockedPool {
+ public:
+  BlockedPool() {
+    auto& pool{App::Core::ThreadPool::get()};
+    const std::size_t workers{pool.slot_count() - 1};
+    for (std::size_t i = 0; i < workers; ++i) {
+      pool.submit([this] {
+        ++m_blocked;
+        while (!m_released) {
+          std::this_thread::yield();
+        }
+      });
+    }
+    while (m_blocked.load() < workers) {
+      std::this_thread::yield();
+    }
+  }
+  BlockedPool(const BlockedPool&) = delete;
+  BlockedPool(BlockedPool&&) = delete;
+  BlockedPool& operator=(const BlockedPool&) = delete;
+  BlockedPool& operator=(BlockedPool&&) = delete;
+  ~BlockedPool() {
+    release();
+  }
+
+  void release() {
+    m_released = true;
+  }
+
+ private:
+  std::atomic<std::size_t> m_blocked{0};
+  std::atomic<bool> m_released{false};
+};
+
+// Waits until a curve newer than `generation` is published and returns it.
+std::shared_ptr<const AsyncCurve::Curve> wait_for_newer(
+    const AsyncCurve& curve, std::uint64_t generation) {
+  while (curve.latest()->generation <= generation) {
+    std::this_thread::yield();
+  }
+  return curve.latest();
+}
+
+void wait_until_idle(const AsyncCurve& curve) {
+  while (curve.is_pending()) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+TEST_SUITE("Core::AsyncCurve") {
+  TEST_CASE("Requests without an expression are ignored") {
+    AsyncCurve curve;
+    const auto before{curve.latest()};
+    CHECK_FALSE(curve.request(nullptr, {0.0, 1.0, 0.0, 1.0, 100.0}));
+    CHECK_FALSE(curve.is_pending());
+    CHECK_EQ(curve.latest(), before);
+  }
+
+  TEST_CASE("The latest finished curve stays while newer requests are pending") {
+    const auto expression{std::make_shared<App::Core::CompiledExpression>("x^2")};
+    REQUIRE(expression->is_valid());
+    AsyncCurve curve;
+
+    REQUIRE(curve.request(expression, {0.0, 1.0, 0.0, 1.0, 100.0}));
+    wait_until_idle(curve);
+    const auto first{curve.latest()};
+    REQUIRE_FALSE(first->samples.empty());
+    CHECK(first->samples.front().x < 2.0);
+
+    BlockedPool blocked;
+    REQUIRE(curve.request(expression, {10.0, 11.0, 0.0, 1.0, 100.0}));
+    // Superseded before it runs: an update is already queued, so these only mark it stale.
+    CHECK_FALSE(curve.request(expression, {50.0, 51.0, 0.0, 1.0, 100.0}));
+    CHECK_FALSE(curve.request(expression, {100.0, 101.0, 0.0, 1.0, 100.0}));
+    CHECK(curve.is_pending());
+    CHECK_EQ(curve.latest(), first);
+
+    blocked.release();
+    const auto second{wait_for_newer(curve, first->generation)};
+    CHECK(second->samples.front().x > 9.0);
+    CHECK(second->samples.front().x < 12.0);
+    // The request that was turned away is still owed.
+    CHECK(curve.is_pending());
+
+    // It starts as soon as the previous update has let go of the caches.
+    while (!curve.request(expression, {100.0, 101.0, 0.0, 1.0, 100.0})) {
+      std::this_thread::yield();
+    }
+    wait_until_idle(curve);
+    const auto third{curve.latest()};
+    CHECK_GT(third->generation, second->generation);
+    CHECK(third->samples.front().x > 99.0);
+    CHECK_FALSE(curve.request(expression, {100.0, 101.0, 0.0, 1.0, 100.0}));
+  }
+
+  TEST_CASE("A seeded curve is drawn until the first update replaces it") {
+    const auto expression{std::make_shared<App::Core::CompiledExpression>("2*x")};
+    REQUIRE(expression->is_valid());
+    AsyncCurve curve;
+
+    AsyncCurve::Curve seeded;
+    seeded.samples.push_back({-5.0, 7.0});
+    curve.seed(seeded);
+    const auto seed{curve.latest()};
+    REQUIRE_EQ(seed->samples.size(), 1U);
+    CHECK_EQ(seed->samples.front().y, 7.0);
+
+    REQUIRE(curve.request(expression, {0.0, 1.0, 0.0, 2.0, 100.0}));
+    const auto updated{wait_for_newer(curve, seed->generation)};
+    CHECK_NE(updated, seed);
+    REQUIRE(updated->samples.size() > 1);
+    CHECK_EQ(updated->samples.back().y, doctest::Approx(2.0 * updated->samples.back().x));
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,37 @@
+#include <doctest/doctest.h>
+
+#include "Core/AxisLayer.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::AxisLayer") {
+  TEST_CASE("Steps are 1, 2 or 5 times a power of ten") {
+    CHECK_EQ(App::Core::AxisLayer::nice_step(1.0), 1.0);
+    CHECK_EQ(App::Core::AxisLayer::nice_step(1.3), 2.0);
+    CHECK_EQ(App::Core::AxisLayer::nice_step(2.5), 5.0);
+    CHECK_EQ(App::Core::AxisLayer::nice_step(7.0), 10.0);
+    CHECK_EQ(App::Core::AxisLayer::nice_step(0.04), doctest::Approx(0.05));
+    CHECK_EQ(App::Core::AxisLayer::nice_step(0.1), doctest::Approx(0.1));
+    CHECK_EQ(App::Core::AxisLayer::nice_step(3.0e5), doctest::Approx(5.0e5));
+    CHECK_EQ(App::Core::AxisLayer::nice_step(0.0), 1.0);
+  }
+
+  TEST_CASE("Tick spacing stays within 2.5 times the minimum at every zoom") {
+    constexpr double MIN{App::Core::AxisLayer::MIN_TICK_SPACING_PX};
+    for (double zoom = 0.01; zoom < 1.0e6; zoom *= 1.07) {
+      const double spacing{App::Core::AxisLayer::nice_step(MIN / zoom) * zoom};
+      CHECK(spacing >= MIN * (1.0 - 1e-9));
+      CHECK(spacing <= MIN * 2.5 * (1.0 + 1e-9));
+    }
+  }
+
+  TEST_CASE("Labels carry just enough decimals for their step") {
+    CHECK_EQ(App::Core::AxisLayer::label_decimals(1.0), 0);
+    CHECK_EQ(App::Core::AxisLayer::label_decimals(50.0), 0);
+    CHECK_EQ(App::Core::AxisLayer::label_decimals(0.5), 1);
+    CHECK_EQ(App::Core::AxisLayer::label_decimals(0.1), 1);
+    CHECK_EQ(App::Core::AxisLayer::label_decimals(0.02), 2);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
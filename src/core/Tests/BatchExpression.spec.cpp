@@ -0,0 +1,164 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/BatchExpression.hpp"
+#include "exprtk.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::BatchExpression") {
+  TEST_CASE("Evaluates arithmetic with the usual precedence") {
+    App::Core::BatchExpression expression;
+    REQUIRE(expression.compile("1 + 2 * x ^ 2 - -x / 4"));
+
+    for (const double x : {-2.0, 0.0, 0.5, 3.0}) {
+      CHECK_EQ(expression.evaluate(x), doctest::Approx(1.0 + 2.0 * x * x + x / 4.0));
+    }
+  }
+
+  TEST_CASE("Powers associate and bind like exprtk") {
+    App::Core::BatchExpression chained;
+    REQUIRE(chained.compile("2^3^2"));
+    CHECK_EQ(chained.evaluate(0.0), 512.0);
+
+    for (const std::string_view source : {"2^3^2", "x^2^0.5", "-x^2", "2^-x", "-2^x^2 * 3"}) {
+      double x{1.5};
+      exprtk::symbol_table<double> symbols;
+      symbols.add_variable("x", x);
+      exprtk::expression<double> reference;
+      reference.register_symbol_table(symbols);
+      exprtk::parser<double> parser;
+      REQUIRE(parser.compile(std::string{source}, reference));
+
+      App::Core::BatchExpression expression;
+      REQUIRE(expression.compile(source));
+      CHECK_EQ(expression.evaluate(x), doctest::Approx(reference.value()));
+    }
+  }
+
+  TEST_CASE("Evaluates elementary functions and constants") {
+    App::Core::BatchExpression expression;
+    REQUIRE(expression.compile("sin(x) * exp(-x) + tanh(x) - log(pi) + pow(abs(x), 0.5)"));
+
+    const double x{1.25};
+    CHECK_EQ(expression.evaluate(x),
+        doctest::Approx(std::sin(x) * std::exp(-x) + std::tanh(x) - std::log(std::numbers::pi) +
+                        std::sqrt(x)));
+  }
+
+  TEST_CASE("Batch evaluation matches the scalar path across blocks") {
+    App::Core::BatchExpression expression;
+    REQUIRE(expression.compile("cos(3*x) / (1 + x^2)"));
+
+    std::vector<double> xs(App::Core::BatchExpression::BLOCK_SIZE * 3 + 7);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      xs[i] = -5.0 + 0.05 * static_cast<double>(i);
+    }
+    std::vector<double> ys(xs.size());
+    expression.evaluate(xs.data(), ys.data(), xs.size());
+
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      CHECK_EQ(ys[i], expression.evaluate(xs[i]));
+    }
+  }
+
+  TEST_CASE("Folds constants and shares subexpressions") {
+    App::Core::BatchExpression expression;
+    REQUIRE(expression.compile("sin(x) * sin(x) + 2 * 3"));
+
+    // x, sin(x), sin(x)^2, 6, sum
+    CHECK_EQ(expression.instructions().size(), 5);
+  }
+
+  TEST_CASE("Supports several variables") {
+    App::Core::BatchExpression expression;
+    const std::array<std::string_view, 2> variables{"x", "y"};
+    REQUIRE(expression.compile("x^2 + y^2 - 1", variables));
+
+    const std::array<double, 2> xs{0.0, 1.0};
+    const std::array<double, 2> ys{0.5, 1.0};
+    const std::array<const double*, 2> inputs{xs.data(), ys.data()};
+    std::array<double, 2> out{};
+    expression.evaluate(inputs, out.data(), out.size());
+
+    CHECK_EQ(out[0], doctest::Approx(-0.75));
+    CHECK_EQ(out[1], doctest::Approx(1.0));
+  }
+
+  TEST_CASE("Rejects constructs left to exprtk") {
+    App::Core::BatchExpression expression;
+    CHECK_FALSE(expression.compile("2x"));
+    CHECK_FALSE(expression.compile("x < 1"));
+    CHECK_FALSE(expression.compile("sum(x)"));
+    CHECK_FALSE(expression.compile("y + 1"));
+    CHECK_FALSE(expression.compile(""));
+    CHECK_FALSE(expression.is_valid());
+  }
+
+  TEST_CASE("Fused programs share work and match each expression") {
+    std::array<App::Core::BatchExpression, 3> expressions;
+    REQUIRE(expressions[0].compile("sin(x) + x"));
+    REQUIRE(expressions[1].compile("2 * sin(x)"));
+    REQUIRE(expressions[2].compile("x"));
+    const std::array<const App::Core::BatchExpression*, 3> members{
+        &expressions[0], &expressions[1], &expressions[2]};
+
+    App::Core::BatchProgram program;
+    REQUIRE(program.compile(members));
+    CHECK_EQ(program.output_count(), 3);
+    // x, sin(x), sin(x) + x, 2, 2 * sin(x)
+    CHECK_EQ(program.instructions().size(), 5);
+
+    const std::size_t count{App::Core::BatchExpression::BLOCK_SIZE + 9};
+    std::vector<double> xs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      xs[i] = -3.0 + 0.1 * static_cast<double>(i);
+    }
+    std::vector<double> matrix(3 * count);
+    program.evaluate(xs.data(), count, matrix.data(), count);
+
+    std::vector<double> column(count);
+    for (std::size_t j = 0; j < members.size(); ++j) {
+      members[j]->evaluate(xs.data(), column.data(), count);
+      for (std::size_t i = 0; i < count; ++i) {
+        CHECK_EQ(matrix[j * count + i], column[i]);
+      }
+    }
+
+    const std::array<std::string_view, 2> variables{"x", "y"};
+    App::Core::BatchExpression implicit;
+    REQUIRE(implicit.compile("x + y", variables));
+    const std::array<const App::Core::BatchExpression*, 2> mixed{&expressions[0], &implicit};
+    CHECK_FALSE(program.compile(mixed));
+  }
+
+  TEST_CASE("Parameters are read on every evaluation instead of folded") {
+    App::Core::Parameters parameters;
+    const std::size_t a{parameters.define("a", 2.0)};
+    const std::array<std::string_view, 1> variables{"x"};
+    App::Core::BatchExpression expression;
+    REQUIRE(expression.compile("a * sin(x) + a^2", variables, &parameters));
+    CHECK_FALSE(App::Core::BatchExpression{}.compile("b * x", variables, &parameters));
+
+    const double x{0.75};
+    CHECK_EQ(expression.evaluate(x), doctest::Approx(2.0 * std::sin(x) + 4.0));
+    parameters.set(a, -3.0);
+    CHECK_EQ(expression.evaluate(x), doctest::Approx(-3.0 * std::sin(x) + 9.0));
+
+    std::vector<double> xs(App::Core::BatchExpression::BLOCK_SIZE + 3, x);
+    std::vector<double> out(xs.size());
+    expression.evaluate(xs.data(), out.data(), xs.size());
+    for (const double y : out) {
+      CHECK_EQ(y, doctest::Approx(-3.0 * std::sin(x) + 9.0));
+    }
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
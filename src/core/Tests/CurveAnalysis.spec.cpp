@@ -0,0 +1,90 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Core/CurveAnalysis.hpp"
+#include "Core/SampleCache.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+using App::Core::CurveAnalysis;
+
+constexpr double PI{3.141592653589793};
+
+// `count` + 1 evenly spaced samples of `f` over [min, max].
+std::vector<App::Core::Sample> sample(
+    const CurveAnalysis::Function& f, double min, double max, int count) {
+  std::vector<App::Core::Sample> samples;
+  for (int i = 0; i <= count; ++i) {
+    const double x{min + (max - min) * i / count};
+    samples.push_back({x, f(x)});
+  }
+  return samples;
+}
+
+}  // namespace
+
+TEST_SUITE("Core::CurveAnalysis") {
+  TEST_CASE("Brent's method converges to machine precision") {
+    const CurveAnalysis::Function cosine{[](double x) { return std::cos(x); }};
+    CHECK_EQ(CurveAnalysis::refine_root(cosine, 1.0, 2.0, std::cos(1.0), std::cos(2.0)),
+        doctest::Approx(PI / 2.0).epsilon(1e-15));
+
+    int evaluations{0};
+    const CurveAnalysis::Function parabola{[&evaluations](double x) {
+      ++evaluations;
+      return (x - 0.3) * (x - 0.3) + 1.0;
+    }};
+    CHECK_EQ(
+        CurveAnalysis::refine_minimum(parabola, 0.0, 1.0), doctest::Approx(0.3).epsilon(1e-7));
+    // Golden-section search alone would need about 40.
+    CHECK_LT(evaluations, 30);
+  }
+
+  TEST_CASE("Roots and extrema of sampled curves are refined") {
+    const CurveAnalysis::Function sine{[](double x) { return std::sin(x); }};
+    std::vector<CurveAnalysis::Marker> markers;
+    CurveAnalysis::find_roots(sine, sample(sine, -4.0, 4.0, 101), markers);
+    REQUIRE_EQ(markers.size(), 3);
+    CHECK_EQ(markers[0].x, doctest::Approx(-PI).epsilon(1e-12));
+    CHECK_EQ(markers[1].x, doctest::Approx(0.0));
+    CHECK_EQ(markers[2].x, doctest::Approx(PI).epsilon(1e-12));
+
+    markers.clear();
+    CurveAnalysis::find_extrema(sine, sample(sine, -4.0, 4.0, 101), markers);
+    REQUIRE_EQ(markers.size(), 2);
+    CHECK_EQ(markers[0].kind, CurveAnalysis::Kind::Minimum);
+    CHECK_EQ(markers[0].x, doctest::Approx(-PI / 2.0).epsilon(1e-7));
+    CHECK_EQ(markers[0].y, doctest::Approx(-1.0).epsilon(1e-12));
+    CHECK_EQ(markers[1].kind, CurveAnalysis::Kind::Maximum);
+    CHECK_EQ(markers[1].x, doctest::Approx(PI / 2.0).epsilon(1e-7));
+  }
+
+  TEST_CASE("Poles are neither roots nor extrema") {
+    const CurveAnalysis::Function tangent{[](double x) { return std::tan(x); }};
+    std::vector<CurveAnalysis::Marker> markers;
+    CurveAnalysis::find_roots(tangent, sample(tangent, 1.0, 2.5, 40), markers);
+    CHECK(markers.empty());
+    CurveAnalysis::find_extrema(tangent, sample(tangent, 1.0, 2.5, 40), markers);
+    CHECK(markers.empty());
+  }
+
+  TEST_CASE("Intersections are found across differently sampled curves") {
+    const CurveAnalysis::Function line{[](double x) { return x; }};
+    const CurveAnalysis::Function parabola{[](double x) { return x * x; }};
+    std::vector<CurveAnalysis::Marker> markers;
+    CurveAnalysis::find_intersections(
+        line, sample(line, -2.0, 3.0, 7), parabola, sample(parabola, -1.5, 2.5, 53), markers);
+    REQUIRE_EQ(markers.size(), 2);
+    CHECK_EQ(markers[0].x, doctest::Approx(0.0));
+    CHECK_EQ(markers[1].x, doctest::Approx(1.0).epsilon(1e-12));
+    CHECK_EQ(markers[1].y, doctest::Approx(1.0).epsilon(1e-12));
+    CHECK_EQ(markers[1].kind, CurveAnalysis::Kind::Intersection);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,119 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/DataSeries.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::DataSeries") {
+  TEST_CASE("Text files skip headers and bad points") {
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "data_series_spec.csv"};
+    {
+      std::ofstream file{path};
+      file << "time,value\n0,1\n1;2\n2\t nan\n0.5,7\n3 4\n";
+    }
+
+    App::Core::DataSeries series;
+    REQUIRE(series.load(path));
+    CHECK_EQ(series.size(), 3);
+    CHECK_EQ(series.rejected(), 2);
+
+    std::pmr::vector<App::Core::Sample> points;
+    series.visible_points(-10.0, 10.0, 1.0, points);
+    REQUIRE_EQ(points.size(), 3);
+    CHECK_EQ(points[1].x, 1.0);
+    CHECK_EQ(points[1].y, 2.0);
+    CHECK_EQ(points[2].x, 3.0);
+    CHECK_EQ(points[2].y, 4.0);
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Large series are reduced to the pixels in view, keeping extremes") {
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "data_series_spec.f64"};
+    constexpr std::size_t COUNT{1'000'000};
+    {
+      std::ofstream file{path, std::ios::binary};
+      for (std::size_t i = 0; i < COUNT; ++i) {
+        const double x{static_cast<double>(i)};
+        const std::array<double, 2> record{x, i == 123'457 ? 100.0 : std::sin(x * 1e-3)};
+        file.write(reinterpret_cast<const char*>(record.data()), sizeof(record));
+      }
+    }
+
+    App::Core::DataSeries series;
+    REQUIRE(series.load(path));
+    CHECK_EQ(series.format(), App::Core::DataSeries::Format::Float64);
+    REQUIRE_EQ(series.size(), COUNT);
+
+    // The whole series over 500 columns.
+    const double pixels_per_unit{500.0 / static_cast<double>(COUNT)};
+    std::pmr::vector<App::Core::Sample> points;
+    series.visible_points(0.0, static_cast<double>(COUNT), pixels_per_unit, points);
+    CHECK(points.size() >= 500);
+    CHECK(points.size() <= 2 * App::Core::DataSeries::BRANCHING * 500 + 4);
+    double highest{0.0};
+    for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+      CHECK(points[i].x <= points[i + 1].x);
+      highest = std::fmax(highest, points[i].y);
+    }
+    CHECK_EQ(highest, 100.0);
+
+    // Zoomed in far enough, the points themselves.
+    points.clear();
+    series.visible_points(1000.0, 1100.0, 10.0, points);
+    REQUIRE_EQ(points.size(), 103);
+    CHECK_EQ(points.front().x, 999.0);
+    CHECK_EQ(points.back().x, 1101.0);
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Following a file picks up appended lines") {
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "data_series_follow_spec.csv"};
+    {
+      std::ofstream file{path};
+      file << "1\n2\n3";
+    }
+
+    App::Core::DataSeries series;
+    REQUIRE(series.load(path));
+    CHECK_EQ(series.size(), 3);
+    CHECK_FALSE(series.poll());
+
+    {
+      std::ofstream file{path, std::ios::app};
+      file << "0\n4\n";
+    }
+    CHECK(series.poll());
+    REQUIRE_EQ(series.size(), 4);
+    std::pmr::vector<App::Core::Sample> points;
+    series.visible_points(0.0, 10.0, 100.0, points);
+    REQUIRE_EQ(points.size(), 4);
+    CHECK_EQ(points[2].y, 30.0);
+    CHECK_EQ(points[3].x, 3.0);
+    CHECK_EQ(points[3].y, 4.0);
+
+    // Replaced by a shorter file: loaded again.
+    {
+      std::ofstream file{path};
+      file << "5\n";
+    }
+    CHECK(series.poll());
+    CHECK_EQ(series.size(), 1);
+
+    std::filesystem::remove(path);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <numbers>
+
+#include "Core/CompiledExpression.hpp"
+#include "Core/Parameters.hpp"
+#include "Core/expression.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+using App::Core::CompiledExpression;
+using App::Core::ExpressionList;
+using App::Core::Parameters;
+
+// Compiles every row once, in order, as a frame of the editor does.
+void compile_pass(ExpressionList& list) {
+  for (std::size_t i = 0; i < list.size(); ++i) {
+    list.compile(i);
+  }
+}
+
+double parameter_value(const ExpressionList& list, std::size_t i) {
+  return list.parameters->value(list.parameter(i));
+}
+
+}  // namespace
+
+TEST_SUITE("Core::ExpressionList") {
+  TEST_CASE("Rows define parameters and functions for the others") {
+    ExpressionList list;
+    list.add("a = 2");
+    list.add("f(x, n) = x^n");
+    list.add("f(x, 3) * a");
+    compile_pass(list);
+    compile_pass(list);
+
+    CHECK_EQ(list.rows[0].defines, "a");
+    CHECK_FALSE(list.rows[0].defines_function);
+    REQUIRE(list.parameter(0) != Parameters::NONE);
+    CHECK_EQ(parameter_value(list, 0), 2.0);
+    CHECK_EQ(list.compiled[0]->kind(), CompiledExpression::Kind::Definition);
+    CHECK(list.compiled[0]->is_valid());
+
+    CHECK_EQ(list.rows[1].defines, "f");
+    CHECK(list.rows[1].defines_function);
+    CHECK_EQ(list.parameter(1), Parameters::NONE);
+    CHECK(list.compiled[1]->is_valid());
+
+    REQUIRE(list.compiled[2]->is_valid());
+    CHECK_EQ(list.compiled[2]->kind(), CompiledExpression::Kind::Explicit);
+    CHECK_EQ(list.compiled[2]->evaluate(2.0), doctest::Approx(16.0));
+  }
+
+  TEST_CASE("A name defined by another row fails until that row lets it go") {
+    ExpressionList list;
+    list.add("a = 1");
+    list.add("a = 2");
+    compile_pass(list);
+
+    CHECK_FALSE(list.compiled[1]->is_valid());
+    CHECK(list.rows[1].defines.empty());
+    CHECK_EQ(parameter_value(list, 0), 1.0);
+
+    list.rows[0].expr = "b = 5";
+    list.rows[0].dirty = true;
+    compile_pass(list);
+
+    CHECK_EQ(list.rows[0].defines, "b");
+    CHECK(list.compiled[1]->is_valid());
+    CHECK_EQ(list.rows[1].defines, "a");
+    CHECK_EQ(parameter_value(list, 1), 2.0);
+  }
+
+  TEST_CASE("Calls with the wrong arity and recursive definitions do not expand") {
+    ExpressionList list;
+    list.add("f(x) = x + 1");
+    list.add("f(x, 2)");
+    list.add("f(2)");
+    list.add("g(x) = g(x) + 1");
+    list.add("g(1)");
+    compile_pass(list);
+    compile_pass(list);
+
+    CHECK(list.compiled[0]->is_valid());
+    CHECK_FALSE(list.compiled[1]->is_valid());
+    REQUIRE(list.compiled[2]->is_valid());
+    CHECK_EQ(list.compiled[2]->evaluate(0.0), doctest::Approx(3.0));
+    CHECK_FALSE(list.compiled[3]->is_valid());
+    CHECK_FALSE(list.compiled[4]->is_valid());
+  }
+
+  TEST_CASE("Exponents are part of their number, not the constant e") {
+    ExpressionList list;
+    list.add("k = 2e3");
+    list.add("g(e) = e + 1e2");
+    list.add("g(3)");
+    compile_pass(list);
+    compile_pass(list);
+
+    CHECK_EQ(parameter_value(list, 0), 2000.0);
+    REQUIRE(list.compiled[2]->is_valid());
+    CHECK_EQ(list.compiled[2]->evaluate(0.0), doctest::Approx(103.0));
+  }
+
+  TEST_CASE("Functions defined on a later row resolve on the next pass") {
+    ExpressionList list;
+    list.add("h(2) + x");
+    list.add("h(x) = 3*x");
+    compile_pass(list);
+    CHECK_FALSE(list.compiled[0]->is_valid());
+
+    const auto definitions{list.definitions()};
+    compile_pass(list);
+    CHECK_EQ(list.definitions(), definitions);
+    REQUIRE(list.compiled[0]->is_valid());
+    CHECK_EQ(list.compiled[0]->evaluate(1.0), doctest::Approx(7.0));
+  }
+
+  TEST_CASE("Rows are classified by their shape") {
+    using Kind = CompiledExpression::Kind;
+    ExpressionList list;
+    list.add("y = x^2");
+    list.add("x^2 + y^2 = 1");
+    list.add("x^2 + y^2 < 1");
+    list.add("(cos(t), sin(t)) {0 <= t <= pi}");
+    list.add("r = 1 + theta");
+    list.add("r = \xCE\xB8 {0 < \xCE\xB8 < 4*pi}");
+    list.add("x^2 {0 <= t <= 1}");
+    compile_pass(list);
+
+    REQUIRE(list.compiled[0]->is_valid());
+    CHECK_EQ(list.compiled[0]->kind(), Kind::Explicit);
+    CHECK_EQ(list.compiled[0]->evaluate(3.0), doctest::Approx(9.0));
+
+    REQUIRE(list.compiled[1]->is_valid());
+    CHECK_EQ(list.compiled[1]->kind(), Kind::Implicit);
+    CHECK_EQ(list.compiled[1]->evaluate(1.0, 0.0), doctest::Approx(0.0));
+    CHECK_EQ(list.compiled[1]->evaluate(2.0, 0.0), doctest::Approx(3.0));
+
+    REQUIRE(list.compiled[2]->is_valid());
+    CHECK_EQ(list.compiled[2]->kind(), Kind::Region);
+    CHECK_EQ(list.compiled[2]->evaluate(0.0, 0.0), 1.0);
+    CHECK_EQ(list.compiled[2]->evaluate(2.0, 0.0), 0.0);
+
+    REQUIRE(list.compiled[3]->is_valid());
+    CHECK_EQ(list.compiled[3]->kind(), Kind::Parametric);
+    CHECK_EQ(list.compiled[3]->domain().min, 0.0);
+    CHECK_EQ(list.compiled[3]->domain().max, doctest::Approx(std::numbers::pi));
+
+    REQUIRE(list.compiled[4]->is_valid());
+    CHECK_EQ(list.compiled[4]->kind(), Kind::Polar);
+    CHECK_EQ(list.compiled[4]->domain().max, CompiledExpression::DEFAULT_DOMAIN.max);
+
+    REQUIRE(list.compiled[5]->is_valid());
+    CHECK_EQ(list.compiled[5]->kind(), Kind::Polar);
+    CHECK_EQ(list.compiled[5]->domain().max, doctest::Approx(4.0 * std::numbers::pi));
+
+    // A domain only belongs to curves; elsewhere it is left in and fails to compile.
+    CHECK_FALSE(list.compiled[6]->is_valid());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
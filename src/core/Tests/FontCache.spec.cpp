@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Core/FontCache.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::FontCache") {
+  TEST_CASE("Restores the baked atlas until the font file changes") {
+    const std::filesystem::path directory{std::filesystem::temp_directory_path()};
+    const std::filesystem::path entry{directory / "font_cache_spec.atlas"};
+    // Only its size and modification time are part of the key.
+    const std::filesystem::path font_path{directory / "font_cache_spec.ttf"};
+    {
+      std::ofstream file{font_path};
+      file << "font";
+    }
+
+    ImFontAtlas baked;
+    const ImFont* font{baked.AddFontDefault()};
+    unsigned char* pixels{nullptr};
+    int width{0};
+    int height{0};
+    baked.GetTexDataAsAlpha8(&pixels, &width, &height);
+    REQUIRE(App::Core::FontCache::store(baked, entry, font_path, 13.0F));
+
+    ImFontAtlas other_size;
+    CHECK_EQ(App::Core::FontCache::load(other_size, entry, font_path, 14.0F), nullptr);
+    CHECK(other_size.Fonts.empty());
+
+    ImFontAtlas restored;
+    const ImFont* restored_font{App::Core::FontCache::load(restored, entry, font_path, 13.0F)};
+    REQUIRE(restored_font != nullptr);
+    CHECK(restored.IsBuilt());
+    CHECK_EQ(restored_font->FontSize, font->FontSize);
+    CHECK_EQ(restored_font->Glyphs.Size, font->Glyphs.Size);
+    CHECK_EQ(restored_font->FindGlyph('A')->AdvanceX, font->FindGlyph('A')->AdvanceX);
+
+    unsigned char* restored_pixels{nullptr};
+    int restored_width{0};
+    int restored_height{0};
+    restored.GetTexDataAsAlpha8(&restored_pixels, &restored_width, &restored_height);
+    REQUIRE_EQ(restored_width, width);
+    REQUIRE_EQ(restored_height, height);
+    CHECK_EQ(std::memcmp(restored_pixels, pixels, static_cast<std::size_t>(width * height)), 0);
+
+    {
+      std::ofstream file{font_path, std::ios::app};
+      file << "changed";
+    }
+    ImFontAtlas stale;
+    CHECK_EQ(App::Core::FontCache::load(stale, entry, font_path, 13.0F), nullptr);
+
+    std::filesystem::remove(entry);
+    std::filesystem::remove(font_path);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
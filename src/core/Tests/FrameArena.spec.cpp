@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "Core/Debug/AllocationCounter.hpp"
+#include "Core/FrameArena.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::FrameArena") {
+  TEST_CASE("Allocations are aligned and rewound by reset") {
+    App::Core::FrameArena arena{1024};
+
+    void* first{arena.allocate(3, 1)};
+    void* second{arena.allocate(16, 16)};
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(second) % 16, 0);
+    CHECK_NE(first, second);
+    CHECK_EQ(arena.used(), 19);
+
+    arena.reset();
+    CHECK_EQ(arena.used(), 0);
+    CHECK_EQ(arena.allocate(3, 1), first);
+  }
+
+  TEST_CASE("Over-aligned requests are honoured") {
+    App::Core::FrameArena arena{256};
+    const auto address{[](void* memory) { return reinterpret_cast<std::uintptr_t>(memory); }};
+
+    CHECK_NE(arena.allocate(1, 1), nullptr);
+    for (const std::size_t alignment : {std::size_t{32}, std::size_t{64}, std::size_t{128}}) {
+      CHECK_EQ(address(arena.allocate(8, alignment)) % alignment, 0);
+    }
+    // Does not fit the first block, and a new one is not aligned to 512 by itself.
+    CHECK_EQ(address(arena.allocate(300, 512)) % 512, 0);
+    CHECK_EQ(address(arena.allocate(8, 4096)) % 4096, 0);
+  }
+
+  TEST_CASE("Large requests get their own block") {
+    App::Core::FrameArena arena{64};
+    CHECK_NE(arena.allocate(1000, 8), nullptr);
+    CHECK(arena.capacity() >= 1000);
+  }
+
+  TEST_CASE("Steady-state frames do not touch the heap") {
+    App::Core::FrameArena arena{256};
+    const auto frame{[&arena] {
+      std::pmr::vector<double> values{&arena};
+      for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+      }
+      CHECK_EQ(values.back(), 999.0);
+    }};
+
+    // The first frame sizes the blocks.
+    frame();
+    arena.reset();
+
+    const std::uint64_t before{App::Debug::AllocationCounter::this_thread()};
+    for (int i = 0; i < 10; ++i) {
+      frame();
+      arena.reset();
+    }
+    CHECK_EQ(App::Debug::AllocationCounter::this_thread(), before);
+  }
+
+  TEST_CASE("Global operator new is counted") {
+    const std::uint64_t before{App::Debug::AllocationCounter::this_thread()};
+    const auto value{std::make_unique<int>(7)};
+    CHECK_EQ(*value, 7);
+    CHECK_EQ(App::Debug::AllocationCounter::this_thread(), before + 1);
+  }
+
+  TEST_CASE("Aligned and nothrow operator new are counted") {
+    struct alignas(64) Line {
+      std::array<std::byte, 64> bytes;
+    };
+    const std::uint64_t before{App::Debug::AllocationCounter::this_thread()};
+    const auto line{std::make_unique<Line>()};
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(line.get()) % 64, 0);
+    const std::unique_ptr<Line[]> lines{new (std::nothrow) Line[3]};
+    CHECK(lines != nullptr);
+    const std::unique_ptr<int> value{new (std::nothrow) int{7}};
+    CHECK(value != nullptr);
+    CHECK_EQ(App::Debug::AllocationCounter::this_thread(), before + 3);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,63 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Core/CompiledExpression.hpp"
+#include "Core/GridSweep.hpp"
+#include "Core/SampleCache.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::GridSweep") {
+  TEST_CASE("Grid points come from the shared evaluation") {
+    const std::vector<std::shared_ptr<App::Core::CompiledExpression>> members{
+        std::make_shared<App::Core::CompiledExpression>("sin(x)"),
+        std::make_shared<App::Core::CompiledExpression>("sin(x) + x^2")};
+    REQUIRE(members[0]->is_batched());
+    REQUIRE(members[1]->is_batched());
+
+    const double pixels_per_unit{100.0};
+    App::Core::GridSweep sweep{members, -4.0, 4.0, pixels_per_unit};
+    CHECK(sweep.matches(members, -4.0, 4.0, pixels_per_unit));
+    CHECK_FALSE(sweep.matches(members, -4.0, 4.0, 2.0 * pixels_per_unit));
+
+    const double step{App::Core::SampleCache::step_for(pixels_per_unit)};
+    std::vector<double> xs;
+    for (int k = -400; k <= 400; k += 3) {
+      xs.push_back(k * step);
+    }
+    std::vector<double> swept(xs.size());
+    std::vector<double> direct(xs.size());
+    for (const auto& member : members) {
+      REQUIRE(sweep.lookup(member.get(), xs.data(), swept.data(), xs.size()));
+      member->evaluate(xs.data(), direct.data(), xs.size());
+      for (std::size_t i = 0; i < xs.size(); ++i) {
+        CHECK_EQ(swept[i], direct[i]);
+      }
+    }
+  }
+
+  TEST_CASE("Points off the grid and other expressions are left to the caller") {
+    const std::vector<std::shared_ptr<App::Core::CompiledExpression>> members{
+        std::make_shared<App::Core::CompiledExpression>("x"),
+        std::make_shared<App::Core::CompiledExpression>("2*x")};
+    App::Core::GridSweep sweep{members, 0.0, 1.0, 64.0};
+
+    std::array<double, 1> y{};
+    const std::array<double, 1> off_grid{0.3};
+    CHECK_FALSE(sweep.lookup(members[0].get(), off_grid.data(), y.data(), 1));
+    const std::array<double, 1> outside{8.0};
+    CHECK_FALSE(sweep.lookup(members[0].get(), outside.data(), y.data(), 1));
+
+    const App::Core::CompiledExpression other{"x"};
+    const std::array<double, 1> on_grid{0.5};
+    CHECK_FALSE(sweep.lookup(&other, on_grid.data(), y.data(), 1));
+    REQUIRE(sweep.lookup(members[1].get(), on_grid.data(), y.data(), 1));
+    CHECK_EQ(y[0], 1.0);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
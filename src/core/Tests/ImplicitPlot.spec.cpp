@@ -0,0 +1,189 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Core/BatchExpression.hpp"
+#include "Core/ImplicitPlot.hpp"
+#include "Core/Interval.hpp"
+#include "Core/SampleCache.hpp"
+#include "Core/ThreadPool.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+void circle(const double* x, const double* y, double* out, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = x[i] * x[i] + y[i] * y[i] - 1.0;
+  }
+}
+
+App::Core::Interval circle_bounds(const App::Core::Interval& x, const App::Core::Interval& y) {
+  using App::Core::Interval;
+  using Op = App::Core::BatchExpression::Op;
+  const Interval two{Interval::point(2.0)};
+  const Interval sum{
+      Interval::apply(Op::Add, Interval::apply(Op::Pow, x, two), Interval::apply(Op::Pow, y, two))};
+  return Interval::apply(Op::Sub, sum, Interval::point(1.0));
+}
+
+double area(const std::vector<App::Core::ImplicitPlot::Box>& boxes) {
+  double total{0.0};
+  for (const auto& box : boxes) {
+    total += (box.x1 - box.x0) * (box.y1 - box.y0);
+  }
+  return total;
+}
+
+// A circle of radius 0.01 around (cx, cy), well inside one coarse cell at 100 px per unit.
+struct SmallCircle {
+  double cx;
+  double cy;
+
+  void operator()(const double* x, const double* y, double* out, std::size_t count) const {
+    for (std::size_t i = 0; i < count; ++i) {
+      out[i] = (x[i] - cx) * (x[i] - cx) + (y[i] - cy) * (y[i] - cy) - 1e-4;
+    }
+  }
+
+  [[nodiscard]] App::Core::Interval bounds(
+      const App::Core::Interval& x, const App::Core::Interval& y) const {
+    using App::Core::Interval;
+    using Op = App::Core::BatchExpression::Op;
+    const Interval two{Interval::point(2.0)};
+    const Interval dx{Interval::apply(Op::Sub, x, Interval::point(cx))};
+    const Interval dy{Interval::apply(Op::Sub, y, Interval::point(cy))};
+    const Interval sum{Interval::apply(
+        Op::Add, Interval::apply(Op::Pow, dx, two), Interval::apply(Op::Pow, dy, two))};
+    return Interval::apply(Op::Sub, sum, Interval::point(1e-4));
+  }
+};
+
+}  // namespace
+
+TEST_SUITE("Core::ImplicitPlot") {
+  TEST_CASE("Circle contour lies on the circle") {
+    App::Core::ImplicitPlot plot;
+    plot.update(circle, -2.0, 2.0, -2.0, 2.0, 100.0, 0.0, false);
+
+    const auto& segments{plot.segments()};
+    REQUIRE_FALSE(segments.empty());
+
+    // Linear interpolation in ~2 px leaves stays well within a pixel of the curve.
+    int quadrants{0};
+    for (const auto& segment : segments) {
+      for (const auto& point : {segment.a, segment.b}) {
+        CHECK(std::fabs(std::hypot(point.x, point.y) - 1.0) < 0.01);
+        quadrants |= 1 << ((point.x > 0.0 ? 1 : 0) + (point.y > 0.0 ? 2 : 0));
+      }
+    }
+    CHECK_EQ(quadrants, 0b1111);
+    CHECK(plot.regions().empty());
+  }
+
+  TEST_CASE("Pan computes only the exposed tiles") {
+    App::Core::ImplicitPlot plot;
+    const double tile{
+        App::Core::SampleCache::step_for(100.0) * App::Core::ImplicitPlot::TILE_PIXELS};
+    const auto update{[&plot, tile](double left) {
+      // Four by two tiles, starting at tile column `left`.
+      return plot.update(circle,
+          left * tile,
+          (left + 4.0) * tile - 1e-9,
+          0.0,
+          2.0 * tile - 1e-9,
+          100.0,
+          0.0,
+          false);
+    }};
+
+    CHECK_EQ(update(0.0), 8);
+    CHECK_EQ(update(0.0), 0);
+    // One tile to the right exposes one column of two tiles.
+    CHECK_EQ(update(1.0), 2);
+  }
+
+  TEST_CASE("Regions fill where the comparison holds") {
+    App::Core::ImplicitPlot plot;
+    const auto left_half{[](const double* x, const double*, double* out, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) {
+        out[i] = x[i] < 0.1 ? 1.0 : 0.0;
+      }
+    }};
+    // One unit tiles at this zoom, so the view is exactly two by two tiles.
+    plot.update(left_half, -1.0, 1.0 - 1e-9, -1.0, 1.0 - 1e-9, 64.0, 0.5, true);
+
+    double area{0.0};
+    for (const auto& box : plot.regions()) {
+      CHECK(box.x0 < 0.1);
+      area += (box.x1 - box.x0) * (box.y1 - box.y0);
+    }
+    // The filled part is 1.1 x 2, up to one column of leaf cells.
+    CHECK(std::fabs(area - 2.2) < 2.0 * 2.0 / 32.0);
+    CHECK_FALSE(plot.segments().empty());
+  }
+
+  TEST_CASE("Parallel tiles match serial tiles") {
+    App::Core::ImplicitPlot serial;
+    App::Core::ImplicitPlot parallel;
+    serial.update(circle, -3.0, 3.0, -2.0, 2.0, 50.0, 0.0, false);
+    parallel.update(circle, -3.0, 3.0, -2.0, 2.0, 50.0, 0.0, false, &App::Core::ThreadPool::get());
+    CHECK_EQ(serial.segments().size(), parallel.segments().size());
+  }
+
+  TEST_CASE("Bounds skip the tiles the curve does not enter") {
+    std::size_t evaluated{0};
+    const auto counted{
+        [&evaluated](const double* x, const double* y, double* out, std::size_t count) {
+          evaluated += count;
+          circle(x, y, out, count);
+        }};
+
+    App::Core::ImplicitPlot sampled;
+    sampled.update(counted, -8.0, 8.0, -8.0, 8.0, 50.0, 0.0, false);
+    const std::size_t sampled_evaluations{evaluated};
+
+    evaluated = 0;
+    App::Core::ImplicitPlot culled;
+    culled.update(counted, -8.0, 8.0, -8.0, 8.0, 50.0, 0.0, false, nullptr, circle_bounds);
+
+    // The same contour, sampled only around the circle.
+    CHECK_EQ(culled.segments().size(), sampled.segments().size());
+    CHECK_LT(evaluated * 4, sampled_evaluations);
+
+    // Cells entirely outside the circle are filled without sampling them.
+    sampled.update(circle, -8.0, 8.0, -8.0, 8.0, 50.0, 0.0, true);
+    culled.update(circle, -8.0, 8.0, -8.0, 8.0, 50.0, 0.0, true, nullptr, circle_bounds);
+    CHECK_EQ(area(culled.regions()), doctest::Approx(area(sampled.regions())));
+    CHECK_LT(culled.regions().size(), sampled.regions().size());
+  }
+
+  TEST_CASE("Bounds find a loop smaller than a coarse cell") {
+    constexpr double ZOOM{100.0};
+    const double coarse{
+        App::Core::SampleCache::step_for(ZOOM) * App::Core::ImplicitPlot::COARSE_PIXELS};
+    REQUIRE(coarse > 0.04);
+    // In the middle of a coarse cell, so every corner of it is outside the loop.
+    const SmallCircle loop{coarse * 0.5, coarse * 0.5};
+    const auto bounds{[&loop](const App::Core::Interval& x, const App::Core::Interval& y) {
+      return loop.bounds(x, y);
+    }};
+
+    App::Core::ImplicitPlot sampled;
+    sampled.update(loop, -1.0, 1.0, -1.0, 1.0, ZOOM, 0.0, false);
+    CHECK(sampled.segments().empty());
+
+    App::Core::ImplicitPlot refined;
+    refined.update(loop, -1.0, 1.0, -1.0, 1.0, ZOOM, 0.0, false, nullptr, bounds);
+    REQUIRE_FALSE(refined.segments().empty());
+    for (const auto& segment : refined.segments()) {
+      for (const auto& point : {segment.a, segment.b}) {
+        CHECK(std::fabs(std::hypot(point.x - loop.cx, point.y - loop.cy) - 0.01) < 0.005);
+      }
+    }
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
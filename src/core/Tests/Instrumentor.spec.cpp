@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/Debug/Instrumentor.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+std::size_t count_occurrences(const std::string& text, const std::string& needle) {
+  std::size_t count{0};
+  for (std::size_t at = text.find(needle); at != std::string::npos;
+       at = text.find(needle, at + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_SUITE("Debug::Instrumentor") {
+  TEST_CASE("Scopes from several threads end up in the trace") {
+    auto& instrumentor{App::Debug::Instrumentor::get()};
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "instrumentor_spec.json"};
+
+    const std::uint32_t outer{instrumentor.intern("outer \"scope\"")};
+    const std::uint32_t inner{instrumentor.intern("inner")};
+    CHECK_EQ(instrumentor.intern("inner"), inner);
+    CHECK_NE(outer, inner);
+
+    // Not recorded: no session yet.
+    { const App::Debug::InstrumentationTimer timer{outer}; }
+
+    instrumentor.begin_session("spec", path.string());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([outer, inner] {
+        for (int i = 0; i < 100; ++i) {
+          const App::Debug::InstrumentationTimer timer{outer};
+          { const App::Debug::InstrumentationTimer nested{inner}; }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    instrumentor.end_session();
+
+    std::ifstream file{path};
+    const std::string trace{std::istreambuf_iterator<char>{file}, {}};
+    CHECK(trace.starts_with(R"({"otherData": {},"traceEvents":[{})"));
+    CHECK(trace.ends_with("]}"));
+    CHECK_EQ(count_occurrences(trace, R"("name":"outer 'scope'")"), 300);
+    CHECK_EQ(count_occurrences(trace, R"("name":"inner")"), 300);
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Buffers ask for a flush at the high-water mark and drop when full") {
+    using App::Debug::EventBuffer;
+    const auto buffer{std::make_unique<EventBuffer>(0)};
+
+    std::size_t requests{0};
+    for (std::size_t i = 0; i < EventBuffer::CAPACITY + 10; ++i) {
+      if (buffer->push({0, static_cast<std::int64_t>(i), 1})) {
+        ++requests;
+        CHECK_EQ(i + 1, EventBuffer::HIGH_WATER);
+      }
+    }
+    CHECK_EQ(requests, 1);
+    CHECK_EQ(buffer->take_dropped(), 10);
+
+    std::size_t drained{0};
+    buffer->drain([&drained](const App::Debug::ProfileEvent& event) {
+      CHECK_EQ(event.start_ns, static_cast<std::int64_t>(drained));
+      ++drained;
+    });
+    CHECK_EQ(drained, EventBuffer::CAPACITY);
+    CHECK_FALSE(buffer->push({0, 0, 1}));  // room again, far from the mark
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,124 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <string_view>
+
+#include "Core/BatchExpression.hpp"
+#include "Core/Interval.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+App::Core::Interval bounds(std::string_view source, double lo, double hi) {
+  App::Core::BatchExpression expression;
+  CHECK(expression.compile(source));
+  const std::array<App::Core::Interval, 1> inputs{{{lo, hi}}};
+  return expression.evaluate(inputs);
+}
+
+}  // namespace
+
+TEST_SUITE("Core::Interval") {
+  TEST_CASE("Bounds enclose every sampled value") {
+    constexpr std::array<std::string_view, 19> SOURCES{
+        "x^2 - 2*x",
+        "sin(x) * cos(3*x)",
+        "tan(x)",
+        "1 / (x - 0.5)",
+        "sqrt(x) + log(x)",
+        "exp(-x^2)",
+        "asin(x/2)",
+        "acos(x)",
+        "x^3 - x",
+        "x^(-2)",
+        "x^0.5",
+        "abs(x) - floor(x) + ceil(x)",
+        "mod(x, 0.7)",
+        "atan2(x, 1.5) + atan(x)",
+        "hypot(x, 2) - cosh(x)",
+        "min(x, sqrt(x)) + max(x, 1)",
+        "sgn(x) * tanh(x) - sinh(x)",
+        "log10(x) + log2(x)",
+        "(x + 1)^x",
+    };
+    constexpr std::array<std::array<double, 2>, 7> RANGES{{
+        {-3.0, -1.0},
+        {-0.2, 0.3},
+        {0.1, 0.4},
+        {1.0, 4.0},
+        {-10.0, 10.0},
+        {2.9, 3.3},
+        {0.5, 0.5},
+    }};
+    constexpr int SAMPLES{257};
+
+    for (const std::string_view source : SOURCES) {
+      App::Core::BatchExpression expression;
+      REQUIRE(expression.compile(source));
+      for (const auto& [lo, hi] : RANGES) {
+        const std::array<App::Core::Interval, 1> inputs{{{lo, hi}}};
+        const App::Core::Interval value{expression.evaluate(inputs)};
+        for (int i = 0; i < SAMPLES; ++i) {
+          const double x{lo + (hi - lo) * i / (SAMPLES - 1)};
+          const double y{expression.evaluate(x)};
+          if (std::isfinite(y)) {
+            CHECK(value.contains(y));
+          } else {
+            CHECK_FALSE(value.defined);
+          }
+        }
+      }
+    }
+  }
+
+  TEST_CASE("Bounds are tight for monotonic pieces") {
+    const App::Core::Interval square{bounds("x^2", -1.0, 2.0)};
+    CHECK_EQ(square.lo, doctest::Approx(0.0));
+    CHECK_EQ(square.hi, doctest::Approx(4.0));
+    CHECK(square.defined);
+
+    const App::Core::Interval sine{bounds("sin(x)", 0.0, std::numbers::pi)};
+    CHECK_EQ(sine.lo, doctest::Approx(0.0));
+    CHECK_EQ(sine.hi, 1.0);
+
+    const App::Core::Interval exponential{bounds("exp(x) + 1", 0.0, 1.0)};
+    CHECK_EQ(exponential.lo, doctest::Approx(2.0));
+    CHECK_EQ(exponential.hi, doctest::Approx(std::numbers::e + 1.0));
+  }
+
+  TEST_CASE("Domain errors and poles are flagged") {
+    CHECK(bounds("sqrt(x)", -2.0, -1.0).is_empty());
+    CHECK(bounds("sqrt(x)", 1.0, 4.0).defined);
+    CHECK_FALSE(bounds("log(x)", -1.0, 1.0).defined);
+    CHECK_FALSE(bounds("asin(x)", 0.5, 2.0).defined);
+
+    const App::Core::Interval pole{bounds("1 / x", -1.0, 1.0)};
+    CHECK_FALSE(pole.defined);
+    CHECK(pole.contains(1e300));
+    CHECK(pole.contains(-1e300));
+
+    CHECK_FALSE(bounds("tan(x)", 1.0, 2.0).defined);
+    CHECK(bounds("tan(x)", -1.0, 1.0).defined);
+    // Undefined operands do not empty fmin: it returns the other one.
+    CHECK(bounds("min(sqrt(x), 2)", -2.0, -1.0).contains(2.0));
+  }
+
+  TEST_CASE("Two-variable bounds exclude a level away from the curve") {
+    App::Core::BatchExpression circle;
+    const std::array<std::string_view, 2> variables{"x", "y"};
+    REQUIRE(circle.compile("x^2 + y^2 - 1", variables));
+
+    const std::array<App::Core::Interval, 2> far{{{2.0, 3.0}, {-0.5, 0.5}}};
+    CHECK_FALSE(circle.evaluate(far).contains(0.0));
+    CHECK_GT(circle.evaluate(far).lo, 0.0);
+
+    const std::array<App::Core::Interval, 2> across{{{0.5, 1.5}, {-0.5, 0.5}}};
+    CHECK(circle.evaluate(across).contains(0.0));
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,54 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <string>
+
+#include "Core/Parameters.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::Parameters") {
+  TEST_CASE("Names keep their id across redefinitions") {
+    App::Core::Parameters parameters;
+    const std::size_t a{parameters.define("a", 1.0)};
+    const std::size_t b{parameters.define("b", 2.0)};
+    CHECK_NE(a, b);
+    CHECK_EQ(parameters.find("a"), a);
+    CHECK_EQ(parameters.find("c"), App::Core::Parameters::NONE);
+
+    parameters.undefine(a);
+    CHECK_EQ(parameters.find("a"), App::Core::Parameters::NONE);
+    CHECK_EQ(parameters.define("a", 5.0), a);
+    CHECK_EQ(parameters.value(a), 5.0);
+    CHECK_EQ(parameters.size(), 2);
+  }
+
+  TEST_CASE("Only changes bump the revisions") {
+    App::Core::Parameters parameters;
+    const std::size_t a{parameters.define("a", 1.0)};
+    const std::size_t b{parameters.define("b", 2.0)};
+    const auto a_revision{parameters.revision(a)};
+    const auto b_revision{parameters.revision(b)};
+    const auto revision{parameters.revision()};
+
+    parameters.set(a, 1.0);
+    CHECK_EQ(parameters.revision(), revision);
+
+    parameters.set(a, 3.0);
+    CHECK_EQ(parameters.value(a), 3.0);
+    CHECK_GT(parameters.revision(a), a_revision);
+    CHECK_EQ(parameters.revision(b), b_revision);
+    CHECK_GT(parameters.revision(), revision);
+  }
+
+  TEST_CASE("The table is bounded") {
+    App::Core::Parameters parameters;
+    for (std::size_t i = 0; i < App::Core::Parameters::MAX_PARAMETERS; ++i) {
+      CHECK_EQ(parameters.define("p" + std::to_string(i), 0.0), i);
+    }
+    CHECK_EQ(parameters.define("extra", 0.0), App::Core::Parameters::NONE);
+    CHECK_EQ(parameters.define("p0", 1.0), 0);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,88 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstddef>
+
+#include "Core/ParametricCurve.hpp"
+#include "Core/ThreadPool.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+constexpr double TAU{6.283185307179586};
+
+void circle(const double* t, double* x, double* y, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    x[i] = std::cos(t[i]);
+    y[i] = std::sin(t[i]);
+  }
+}
+
+}  // namespace
+
+TEST_SUITE("Core::ParametricCurve") {
+  TEST_CASE("Circles are sampled finely enough for the zoom and only once") {
+    App::Core::ParametricCurve curve;
+    const double pixels_per_unit{200.0};
+    CHECK(curve.update(circle, 0.0, TAU, pixels_per_unit, &App::Core::ThreadPool::get()) > 0);
+
+    const auto& points{curve.curve()};
+    REQUIRE(points.size() > App::Core::ParametricCurve::INITIAL_INTERVALS);
+    for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+      CHECK_EQ(std::hypot(points[i].x, points[i].y), doctest::Approx(1.0));
+      const double chord{
+          std::hypot(points[i + 1].x - points[i].x, points[i + 1].y - points[i].y)};
+      CHECK(chord * pixels_per_unit <= App::Core::ParametricCurve::MAX_CHORD_PX);
+    }
+    CHECK_EQ(points.front().x, doctest::Approx(1.0));
+    CHECK_EQ(points.back().x, doctest::Approx(1.0));
+
+    CHECK_EQ(curve.update(circle, 0.0, TAU, pixels_per_unit), 0);
+  }
+
+  TEST_CASE("Fast oscillations get the samples slow ones do not need") {
+    const auto wave{[](double frequency) {
+      return [frequency](const double* t, double* x, double* y, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+          x[i] = t[i];
+          y[i] = std::sin(frequency * t[i]);
+        }
+      };
+    }};
+    const double pixels_per_unit{100.0};
+    App::Core::ParametricCurve slow;
+    slow.update(wave(1.0), 0.0, TAU, pixels_per_unit);
+    App::Core::ParametricCurve fast;
+    fast.update(wave(50.0), 0.0, TAU, pixels_per_unit);
+
+    CHECK(fast.curve().size() > 4 * slow.curve().size());
+    const auto& points{fast.curve()};
+    for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+      const double chord{
+          std::hypot(points[i + 1].x - points[i].x, points[i + 1].y - points[i].y)};
+      CHECK(chord * pixels_per_unit <= App::Core::ParametricCurve::MAX_CHORD_PX);
+    }
+  }
+
+  TEST_CASE("Gaps are narrowed down to where the curve stops being defined") {
+    const auto half{[](const double* t, double* x, double* y, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) {
+        x[i] = t[i];
+        y[i] = std::sqrt(t[i]);
+      }
+    }};
+    App::Core::ParametricCurve curve;
+    curve.update(half, -1.0, 1.0, 100.0);
+
+    double first_defined{1.0};
+    for (const auto& point : curve.curve()) {
+      if (std::isfinite(point.y)) {
+        first_defined = std::fmin(first_defined, point.x);
+      }
+    }
+    CHECK(first_defined < 1e-3);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,36 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstddef>
+
+#include "Core/Debug/PerfStats.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Debug::PerfStats") {
+  TEST_CASE("Percentiles and stage averages over the frame history") {
+    using std::chrono::milliseconds;
+    auto& stats{App::Debug::PerfStats::get()};
+
+    // Fill the whole history: 1..100 ms, repeated.
+    for (std::size_t i = 0; i < App::Debug::PerfStats::HISTORY; ++i) {
+      stats.add_time(App::Debug::PerfStats::Stage::Evaluate, milliseconds{2});
+      stats.add_evaluations(10);
+      stats.end_frame(milliseconds{static_cast<int>(i % 100) + 1}, 42);
+    }
+
+    const auto frames{stats.frame_percentiles()};
+    CHECK(frames.p50 <= frames.p95);
+    CHECK(frames.p95 <= frames.p99);
+    CHECK(frames.p99 <= 100.0);
+    CHECK(frames.p50 > 30.0);
+    CHECK(frames.p50 < 60.0);
+
+    CHECK_EQ(stats.stage_average(App::Debug::PerfStats::Stage::Evaluate), doctest::Approx(2.0));
+    CHECK_EQ(stats.stage_average(App::Debug::PerfStats::Stage::Parse), 0.0);
+    CHECK_EQ(stats.evaluations_last_frame(), 10);
+    CHECK_EQ(stats.vertices_last_frame(), 42);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
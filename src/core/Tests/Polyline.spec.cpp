@@ -0,0 +1,160 @@
+#include <doctest/doctest.h>
+#include <imgui.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/Polyline.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+// Distance from `point` to the polyline.
+float distance_to(const std::pmr::vector<ImVec2>& line, const ImVec2& point) {
+  float best{std::numeric_limits<float>::max()};
+  for (std::size_t i = 0; i + 1 < line.size(); ++i) {
+    const ImVec2 a{line[i]};
+    const ImVec2 b{line[i + 1]};
+    const float dx{b.x - a.x};
+    const float dy{b.y - a.y};
+    const float length{dx * dx + dy * dy};
+    float t{length > 0.0F ? ((point.x - a.x) * dx + (point.y - a.y) * dy) / length : 0.0F};
+    t = std::fmax(0.0F, std::fmin(1.0F, t));
+    best = std::fmin(best, std::hypot(a.x + t * dx - point.x, a.y + t * dy - point.y));
+  }
+  return best;
+}
+
+}  // namespace
+
+TEST_SUITE("Core::Polyline") {
+  TEST_CASE("Straight runs collapse to their end points") {
+    std::vector<ImVec2> points;
+    for (int i = 0; i <= 1000; ++i) {
+      points.emplace_back(static_cast<float>(i) * 0.5F, static_cast<float>(i) * 0.25F);
+    }
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::simplify(points, App::Core::Polyline::DEFAULT_TOLERANCE_PX, out);
+    REQUIRE_EQ(out.size(), 2);
+    CHECK_EQ(out.front().x, 0.0F);
+    CHECK_EQ(out.back().x, 500.0F);
+  }
+
+  TEST_CASE("Smooth curves shrink by an order of magnitude within tolerance") {
+    // Four samples per pixel of a sine 100 px high, as refinement produces them.
+    std::vector<ImVec2> points;
+    for (int i = 0; i <= 4000; ++i) {
+      const float x{static_cast<float>(i) * 0.25F};
+      points.emplace_back(x, 100.0F * std::sin(x / 80.0F));
+    }
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::simplify(points, App::Core::Polyline::DEFAULT_TOLERANCE_PX, out);
+    CHECK(out.size() * 10 < points.size());
+
+    // Column decimation may move the line by up to one column, RDP by the tolerance.
+    for (const ImVec2& point : points) {
+      CHECK(distance_to(out, point) <= 1.0F + App::Core::Polyline::DEFAULT_TOLERANCE_PX);
+    }
+  }
+
+  TEST_CASE("Columns keep their vertical extent") {
+    const std::vector<ImVec2> points{
+        {10.1F, 0.0F}, {10.3F, 50.0F}, {10.5F, -20.0F}, {10.7F, 5.0F}, {10.9F, 1.0F}};
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::decimate_columns(points, out);
+    REQUIRE_EQ(out.size(), 4);
+    CHECK_EQ(out[0].x, 10.1F);
+    CHECK_EQ(out[1].y, 50.0F);
+    CHECK_EQ(out[2].y, -20.0F);
+    CHECK_EQ(out[3].x, 10.9F);
+  }
+
+  TEST_CASE("Non-finite points stay as single separators") {
+    const float nan{std::numeric_limits<float>::quiet_NaN()};
+    const std::vector<ImVec2> points{
+        {0.0F, 0.0F}, {1.0F, 1.0F}, {2.0F, nan}, {3.0F, nan}, {4.0F, 4.0F}, {5.0F, 5.0F}};
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::simplify(points, App::Core::Polyline::DEFAULT_TOLERANCE_PX, out);
+    REQUIRE_EQ(out.size(), 5);
+    CHECK(std::isnan(out[2].y));
+    CHECK_EQ(out[3].x, 4.0F);
+  }
+  TEST_CASE("Clipping cuts segments at the band edges and drops the rest") {
+    const std::vector<ImVec2> points{
+        {0.0F, 50.0F}, {1.0F, 150.0F}, {2.0F, 250.0F}, {3.0F, 150.0F}, {4.0F, 50.0F}};
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::clip(points, 0.0F, 100.0F, out);
+    REQUIRE_EQ(out.size(), 5);
+    CHECK_EQ(out[0].x, 0.0F);
+    CHECK_EQ(out[1].x, doctest::Approx(0.5F));
+    CHECK_EQ(out[1].y, 100.0F);
+    CHECK(std::isnan(out[2].x));
+    CHECK_EQ(out[3].x, doctest::Approx(3.5F));
+    CHECK_EQ(out[4].x, 4.0F);
+
+    std::size_t runs{0};
+    App::Core::Polyline::for_each_run(out, [&runs](const ImVec2*, std::size_t count) {
+      CHECK_EQ(count, 2);
+      ++runs;
+    });
+    CHECK_EQ(runs, 2);
+  }
+
+  TEST_CASE("Poles break the line, steep continuous segments do not") {
+    // Screen space, y down: tan(x) rising towards a pole, then coming back from below.
+    const std::vector<ImVec2> pole{
+        {0.0F, 50.0F}, {1.0F, -1.0e6F}, {2.0F, 1.0e6F}, {3.0F, 50.0F}, {4.0F, 40.0F}};
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::clip(pole, 0.0F, 100.0F, out);
+    for (std::size_t i = 0; i + 1 < out.size(); ++i) {
+      // No piece of the jump between x = 1 and x = 2 survives.
+      CHECK_FALSE((out[i].x > 1.0F && out[i].x < 2.0F));
+    }
+
+    // Crossing the band without a direction reversal is a steep but continuous curve.
+    const std::vector<ImVec2> steep{
+        {0.0F, 150.0F}, {1.0F, 120.0F}, {2.0F, -1.0e6F}, {3.0F, -2.0e6F}};
+    out.clear();
+    App::Core::Polyline::clip(steep, 0.0F, 100.0F, out);
+    REQUIRE_EQ(out.size(), 2);
+    CHECK_EQ(out[0].y, 100.0F);
+    CHECK_EQ(out[1].y, 0.0F);
+  }
+
+  TEST_CASE("Unbounded coordinates narrow to finite floats on both axes") {
+    constexpr double LIMIT{1.0e7};
+    // x = tan(t), y = t near the pole at t = pi/2, already in pixels.
+    const std::vector<std::array<double, 2>> samples{
+        {1.0e3, 10.0}, {1.0e300, 20.0}, {-1.0e300, 30.0}, {-1.0e3, 40.0}};
+    std::vector<ImVec2> points;
+    for (const auto& [x, y] : samples) {
+      points.push_back(App::Core::Polyline::narrow(x, y, LIMIT));
+    }
+    CHECK_EQ(points[1].x, static_cast<float>(LIMIT));
+    CHECK_EQ(points[2].x, static_cast<float>(-LIMIT));
+    CHECK_EQ(App::Core::Polyline::narrow(0.0, -1.0e300, LIMIT).y, static_cast<float>(-LIMIT));
+
+    const ImVec2 gap{App::Core::Polyline::narrow(std::nan(""), 5.0, LIMIT)};
+    CHECK(std::isnan(gap.x));
+
+    std::pmr::vector<ImVec2> out;
+    App::Core::Polyline::clip(points, 0.0F, 100.0F, out);
+    REQUIRE_FALSE(out.empty());
+    for (const ImVec2& point : out) {
+      CHECK((std::isnan(point.x) || std::isfinite(point.x)));
+      CHECK((std::isnan(point.y) || std::isfinite(point.y)));
+    }
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/Raster.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+constexpr ImU32 WHITE{IM_COL32(255, 255, 255, 255)};
+constexpr ImVec4 NO_CLIP{-1e4F, -1e4F, 1e4F, 1e4F};
+constexpr App::Core::Raster::Texture NO_TEXTURE{nullptr, 0, 0};
+
+// Two triangles covering the rectangle (x0, y0) - (x1, y1), sharing its diagonal.
+void fill(App::Core::Raster& raster, float x0, float y0, float x1, float y1, ImU32 color) {
+  const std::array<ImDrawVert, 4> vertices{ImDrawVert{ImVec2(x0, y0), ImVec2(), color},
+      ImDrawVert{ImVec2(x1, y0), ImVec2(), color},
+      ImDrawVert{ImVec2(x1, y1), ImVec2(), color},
+      ImDrawVert{ImVec2(x0, y1), ImVec2(), color}};
+  const std::array<ImDrawIdx, 6> indices{0, 1, 2, 0, 2, 3};
+  raster.draw(vertices, indices, NO_CLIP, NO_TEXTURE);
+}
+
+std::uint32_t read_u32(const std::vector<std::uint8_t>& bytes, std::size_t offset) {
+  return (std::uint32_t{bytes[offset]} << 24U) | (std::uint32_t{bytes[offset + 1]} << 16U) |
+         (std::uint32_t{bytes[offset + 2]} << 8U) | std::uint32_t{bytes[offset + 3]};
+}
+
+}  // namespace
+
+TEST_SUITE("Core::Raster") {
+  TEST_CASE("Covers exactly the pixels whose centers are inside") {
+    App::Core::Raster raster{8, 8, WHITE};
+    fill(raster, 2.0F, 2.0F, 6.0F, 5.0F, IM_COL32(255, 0, 0, 255));
+
+    std::size_t covered{0};
+    for (int y = 0; y < 8; ++y) {
+      for (int x = 0; x < 8; ++x) {
+        const bool inside{x >= 2 && x < 6 && y >= 2 && y < 5};
+        const ImU32 pixel{raster.pixels()[static_cast<std::size_t>(y * 8 + x)]};
+        CHECK_EQ(pixel, inside ? IM_COL32(255, 0, 0, 255) : WHITE);
+        covered += inside ? 1 : 0;
+      }
+    }
+    CHECK_EQ(covered, 12);
+  }
+
+  TEST_CASE("Shared edges are blended once") {
+    App::Core::Raster raster{16, 16, IM_COL32(0, 0, 0, 255)};
+    // The diagonal passes through pixel centers.
+    fill(raster, 0.0F, 0.0F, 16.0F, 16.0F, IM_COL32(255, 255, 255, 128));
+
+    const ImU32 first{raster.pixels().front()};
+    for (const ImU32 pixel : raster.pixels()) {
+      CHECK_EQ(pixel, first);
+    }
+  }
+
+  TEST_CASE("Clips to the clip rectangle and the image") {
+    App::Core::Raster raster{4, 4, WHITE};
+    const std::array<ImDrawVert, 3> vertices{
+        ImDrawVert{ImVec2(-10.0F, -10.0F), ImVec2(), IM_COL32(0, 0, 0, 255)},
+        ImDrawVert{ImVec2(30.0F, -10.0F), ImVec2(), IM_COL32(0, 0, 0, 255)},
+        ImDrawVert{ImVec2(-10.0F, 30.0F), ImVec2(), IM_COL32(0, 0, 0, 255)}};
+    const std::array<ImDrawIdx, 3> indices{0, 1, 2};
+    raster.draw(vertices, indices, ImVec4(0.0F, 0.0F, 2.0F, 4.0F), NO_TEXTURE);
+
+    CHECK_EQ(raster.pixels()[0], IM_COL32(0, 0, 0, 255));
+    CHECK_EQ(raster.pixels()[1], IM_COL32(0, 0, 0, 255));
+    CHECK_EQ(raster.pixels()[2], WHITE);
+  }
+
+  TEST_CASE("Encodes a well-formed PNG") {
+    std::vector<ImU32> pixels(64 * 32, WHITE);
+    pixels[100] = IM_COL32(10, 20, 30, 255);
+    const std::vector<std::uint8_t> png{App::Core::Raster::encode_png(pixels, 64, 32)};
+
+    const std::array<std::uint8_t, 8> signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    REQUIRE_GT(png.size(), 8 + 25 + 12 + 12);
+    CHECK(std::equal(signature.begin(), signature.end(), png.begin()));
+
+    // IHDR: size, type, width, height, 8-bit RGBA.
+    CHECK_EQ(read_u32(png, 8), 13);
+    CHECK_EQ(std::string(png.begin() + 12, png.begin() + 16), "IHDR");
+    CHECK_EQ(read_u32(png, 16), 64);
+    CHECK_EQ(read_u32(png, 20), 32);
+    CHECK_EQ(png[24], 8);
+    CHECK_EQ(png[25], 6);
+
+    // Then IDAT, whose zlib header is valid, and the constant IEND chunk.
+    const std::uint32_t idat_size{read_u32(png, 33)};
+    CHECK_EQ(std::string(png.begin() + 37, png.begin() + 41), "IDAT");
+    CHECK_EQ(((png[41] << 8U) | png[42]) % 31, 0);
+    CHECK_EQ(png.size(), 33 + 12 + idat_size + 12);
+    const std::array<std::uint8_t, 12> end{0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xAE, 0x42, 0x60, 0x82};
+    CHECK(std::equal(end.begin(), end.end(), png.end() - 12));
+
+    // Flat images compress well below their raw size.
+    CHECK_LT(idat_size, pixels.size() * 4 / 10);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,189 @@
+#include <doctest/doctest.h>
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "Core/AsyncCurve.hpp"
+#include "Core/CurveGeometry.hpp"
+#include "Core/RetainedGeometry.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+
+using App::Core::CurveGeometry;
+using App::Core::RetainedGeometry;
+
+// Settings of a standalone draw list: no anti-aliasing, and vertex offsets allowed as the
+// backend does, so that a list may grow past 64K vertices with 16-bit indices.
+void init_shared_data(ImDrawListSharedData& shared) {
+  shared.ClipRectFullscreen = {-8192.0F, -8192.0F, 8192.0F, 8192.0F};
+  shared.InitialFlags = ImDrawListFlags_AllowVtxOffset;
+}
+
+void begin_frame(ImDrawList& list) {
+  list._ResetForNewFrame();
+  list.PushClipRectFullScreen();
+}
+
+// Triangle corners as the backend reads them: every index resolved through the vertex offset
+// of its command. Indices pointing past the vertex buffer are counted in `out_of_range`.
+std::vector<ImVec2> resolve(const ImDrawList& list, std::size_t& out_of_range) {
+  std::vector<ImVec2> corners;
+  out_of_range = 0;
+  for (const ImDrawCmd& cmd : list.CmdBuffer) {
+    for (unsigned int i = cmd.IdxOffset; i < cmd.IdxOffset + cmd.ElemCount; ++i) {
+      const unsigned int vertex{cmd.VtxOffset + list.IdxBuffer[static_cast<int>(i)]};
+      if (vertex >= static_cast<unsigned int>(list.VtxBuffer.Size)) {
+        ++out_of_range;
+        continue;
+      }
+      corners.push_back(list.VtxBuffer[static_cast<int>(vertex)].pos);
+    }
+  }
+  return corners;
+}
+
+}  // namespace
+
+TEST_SUITE("Core::RetainedGeometry") {
+  TEST_CASE("Drawing at another origin translates every vertex") {
+    ImDrawListSharedData shared;
+    init_shared_data(shared);
+    ImDrawList scratch{&shared};
+    begin_frame(scratch);
+    scratch.AddRectFilled({0.0F, 0.0F}, {10.0F, 5.0F}, IM_COL32_WHITE);
+    scratch.AddRectFilled({-3.0F, 2.0F}, {1.0F, 4.0F}, IM_COL32_WHITE);
+
+    RetainedGeometry geometry;
+    geometry.capture(scratch);
+    CHECK_EQ(geometry.vertex_count(), 8U);
+
+    ImDrawList target{&shared};
+    std::size_t out_of_range{0};
+    begin_frame(target);
+    geometry.draw(&target, {100.0F, 50.0F});
+    const auto first{resolve(target, out_of_range)};
+    CHECK_EQ(out_of_range, 0U);
+    REQUIRE_EQ(first.size(), 12U);
+    CHECK_EQ(first[0].x, 100.0F);
+    CHECK_EQ(first[0].y, 50.0F);
+
+    begin_frame(target);
+    geometry.draw(&target, {-20.0F, 7.0F});
+    const auto second{resolve(target, out_of_range)};
+    CHECK_EQ(out_of_range, 0U);
+    REQUIRE_EQ(second.size(), first.size());
+    for (std::size_t i = 0; i < first.size(); ++i) {
+      CHECK_EQ(second[i].x, first[i].x - 120.0F);
+      CHECK_EQ(second[i].y, first[i].y - 43.0F);
+    }
+
+    // Same origin again: the placed vertices are reused as they are.
+    begin_frame(target);
+    geometry.draw(&target, {-20.0F, 7.0F});
+    const auto third{resolve(target, out_of_range)};
+    REQUIRE_EQ(third.size(), second.size());
+    for (std::size_t i = 0; i < second.size(); ++i) {
+      CHECK_EQ(third[i].x, second[i].x);
+      CHECK_EQ(third[i].y, second[i].y);
+    }
+
+    // A capture places the new vertices even though the origin did not move.
+    begin_frame(scratch);
+    scratch.AddRectFilled({20.0F, 20.0F}, {30.0F, 30.0F}, IM_COL32_WHITE);
+    geometry.capture(scratch);
+    begin_frame(target);
+    geometry.draw(&target, {-20.0F, 7.0F});
+    const auto fourth{resolve(target, out_of_range)};
+    CHECK_EQ(out_of_range, 0U);
+    REQUIRE_EQ(fourth.size(), 18U);
+    CHECK_EQ(fourth[12].x, 0.0F);
+    CHECK_EQ(fourth[12].y, 27.0F);
+  }
+
+  TEST_CASE("Indices are rebased when a draw crosses the 16-bit vertex limit") {
+    ImDrawListSharedData shared;
+    init_shared_data(shared);
+    ImDrawList scratch{&shared};
+    begin_frame(scratch);
+    // 40000 vertices: the second copy no longer fits below 65536.
+    for (int i = 0; i < 10000; ++i) {
+      const auto x{static_cast<float>(i)};
+      scratch.AddRectFilled({x, 0.0F}, {x + 0.5F, 1.0F}, IM_COL32_WHITE);
+    }
+    std::size_t out_of_range{0};
+    const auto captured{resolve(scratch, out_of_range)};
+    REQUIRE_EQ(out_of_range, 0U);
+
+    RetainedGeometry geometry;
+    geometry.capture(scratch);
+    ImDrawList target{&shared};
+    begin_frame(target);
+    geometry.draw(&target, {5.0F, 5.0F});
+    geometry.draw(&target, {5.0F, 5.0F});
+
+    CHECK_GT(target.VtxBuffer.Size, 1 << 16);
+    CHECK_GT(target.CmdBuffer.Size, 1);
+    const auto corners{resolve(target, out_of_range)};
+    CHECK_EQ(out_of_range, 0U);
+    REQUIRE_EQ(corners.size(), 2 * captured.size());
+    std::size_t misplaced{0};
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+      const ImVec2& expected{captured[i % captured.size()]};
+      if (corners[i].x != expected.x + 5.0F || corners[i].y != expected.y + 5.0F) {
+        ++misplaced;
+      }
+    }
+    CHECK_EQ(misplaced, 0U);
+  }
+
+  TEST_CASE("Long curves are tessellated in chunks and drawn past 64K vertices") {
+    ImDrawListSharedData shared;
+    init_shared_data(shared);
+    ImDrawList scratch{&shared};
+
+    // A zigzag 2 px per sample and 10 px high, so neither clipping nor simplification drops
+    // points and every chunk holds MAX_POINTS_PER_CHUNK of them.
+    constexpr std::size_t POINTS{3 * CurveGeometry::MAX_POINTS_PER_CHUNK};
+    App::Core::AsyncCurve::Curve curve;
+    curve.generation = 1;
+    for (std::size_t i = 0; i < POINTS; ++i) {
+      curve.samples.push_back({static_cast<double>(i) * 0.02, i % 2 == 0 ? 0.0 : 0.1});
+    }
+    const App::Core::AsyncCurve::View view{
+        0.0, static_cast<double>(POINTS) * 0.02, -1.0, 1.0, 100.0};
+
+    CurveGeometry geometry;
+    REQUIRE(geometry.update(
+        curve, view, IM_COL32_WHITE, 1.0F, scratch, std::pmr::get_default_resource()));
+    CHECK_FALSE(geometry.update(
+        curve, view, IM_COL32_WHITE, 1.0F, scratch, std::pmr::get_default_resource()));
+    CHECK_GT(geometry.vertex_count(), 1 << 16);
+
+    ImDrawList target{&shared};
+    begin_frame(target);
+    const ImVec2 anchor{400.0F, 300.0F};
+    geometry.draw(&target, anchor);
+
+    std::size_t out_of_range{0};
+    const auto corners{resolve(target, out_of_range)};
+    CHECK_EQ(out_of_range, 0U);
+    REQUIRE_FALSE(corners.empty());
+    // Every corner lies within a line width of the zigzag's bounding box.
+    const float half_width{0.5F * static_cast<float>(view.xmax - view.xmin) * 100.0F};
+    std::size_t outside{0};
+    for (const ImVec2& corner : corners) {
+      if (corner.x < anchor.x - half_width - 1.0F || corner.x > anchor.x + half_width + 1.0F ||
+          corner.y < anchor.y - 11.0F || corner.y > anchor.y + 1.0F) {
+        ++outside;
+      }
+    }
+    CHECK_EQ(outside, 0U);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
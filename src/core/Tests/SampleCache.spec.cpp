@@ -0,0 +1,204 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Core/BatchExpression.hpp"
+#include "Core/Interval.hpp"
+#include "Core/SampleCache.hpp"
+#include "Core/ThreadPool.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::SampleCache") {
+  TEST_CASE("Step is the power of two closest to one pixel") {
+    CHECK_EQ(App::Core::SampleCache::step_for(1.0), 1.0);
+    CHECK_EQ(App::Core::SampleCache::step_for(100.0), 1.0 / 128.0);
+    CHECK_EQ(App::Core::SampleCache::step_for(0.5), 2.0);
+  }
+
+  TEST_CASE("Static view evaluates only once") {
+    App::Core::SampleCache cache;
+    std::size_t calls{0};
+    const auto line{[&calls](double x) {
+      ++calls;
+      return 2.0 * x;
+    }};
+
+    const std::size_t evaluated{cache.update(line, -1.0, 1.0, 4.0)};
+    CHECK_EQ(evaluated, 9);
+    CHECK_EQ(calls, 9);
+    CHECK_EQ(cache.samples().front().x, -1.0);
+    CHECK_EQ(cache.samples().back().y, 2.0);
+
+    CHECK_EQ(cache.update(line, -1.0, 1.0, 4.0), 0);
+    CHECK_EQ(calls, 9);
+  }
+
+  TEST_CASE("Pan evaluates only the exposed interval") {
+    App::Core::SampleCache cache;
+    const auto identity{[](double x) { return x; }};
+
+    cache.update(identity, 0.0, 1.0, 4.0);
+    CHECK_EQ(cache.update(identity, 0.5, 1.5, 4.0), 2);
+    CHECK_EQ(cache.samples().size(), 5);
+    CHECK_EQ(cache.samples().front().x, 0.5);
+    CHECK_EQ(cache.samples().back().x, 1.5);
+  }
+
+  TEST_CASE("Zooming in reuses every existing sample") {
+    App::Core::SampleCache cache;
+    const auto identity{[](double x) { return x; }};
+
+    cache.update(identity, 0.0, 1.0, 4.0);
+    CHECK_EQ(cache.update(identity, 0.0, 1.0, 8.0), 4);
+    CHECK_EQ(cache.samples().size(), 9);
+
+    // Zooming out again only drops samples.
+    CHECK_EQ(cache.update(identity, 0.0, 1.0, 4.0), 0);
+    CHECK_EQ(cache.samples().size(), 5);
+  }
+
+  TEST_CASE("Flat spans are merged") {
+    App::Core::SampleCache cache;
+    cache.update([](double x) { return 3.0 * x + 1.0; }, -10.0, 10.0, 16.0);
+
+    REQUIRE_EQ(cache.curve().size(), 2);
+    CHECK_EQ(cache.curve().front().x, -10.0);
+    CHECK_EQ(cache.curve().back().x, 10.0);
+  }
+
+  TEST_CASE("Sharp features are refined within the budget") {
+    App::Core::SampleCache cache;
+    const auto step{[](double x) { return std::tanh(1000.0 * x); }};
+
+    const std::size_t evaluated{cache.update(step, -1.0, 1.0, 8.0)};
+    const std::size_t base{cache.samples().size()};
+    CHECK_GT(evaluated, base);
+    CHECK_LE(evaluated, base * (1 + App::Core::SampleCache::REFINE_BUDGET_PER_SAMPLE));
+
+    // Refined points end up between the base samples around the jump.
+    bool has_refined_point{false};
+    for (const auto& sample : cache.curve()) {
+      has_refined_point = has_refined_point || (std::fabs(sample.x) < 0.0625 && sample.x != 0.0);
+    }
+    CHECK(has_refined_point);
+  }
+
+  TEST_CASE("Curves break at jumps and poles, not at steep slopes") {
+    // Index of the separator between finite samples, or the curve's size if there is none.
+    const auto separator{[](const std::vector<App::Core::Sample>& curve) {
+      std::size_t count{0};
+      std::size_t index{curve.size()};
+      for (std::size_t i = 1; i + 1 < curve.size(); ++i) {
+        if (!std::isfinite(curve[i].y)) {
+          ++count;
+          index = i;
+        }
+      }
+      return count == 1 ? index : curve.size() + count;
+    }};
+
+    App::Core::SampleCache cache;
+    const std::size_t evaluated{cache.update([](double x) { return 1.0 / (x - 0.3); },
+        -1.0,
+        1.0,
+        64.0)};
+    const std::size_t pole{separator(cache.curve())};
+    REQUIRE_LT(pole, cache.curve().size());
+    CHECK_LT(cache.curve()[pole - 1].x, 0.3);
+    CHECK_GT(cache.curve()[pole + 1].x, 0.3);
+    // The approach runs far past the canvas on both sides.
+    CHECK_LT(cache.curve()[pole - 1].y, -1e4);
+    CHECK_GT(cache.curve()[pole + 1].y, 1e4);
+    CHECK_LE(evaluated,
+        cache.samples().size() * (1 + App::Core::SampleCache::REFINE_BUDGET_PER_SAMPLE));
+
+    cache.invalidate();
+    cache.update([](double x) { return std::floor(x); }, 0.2, 1.8, 64.0);
+    const std::size_t step{separator(cache.curve())};
+    REQUIRE_LT(step, cache.curve().size());
+    CHECK_EQ(cache.curve()[step - 1].y, 0.0);
+    CHECK_EQ(cache.curve()[step + 1].y, 1.0);
+    CHECK_LT(cache.curve()[step + 1].x - cache.curve()[step - 1].x, 1e-4);
+
+    cache.invalidate();
+    cache.update([](double x) { return std::tanh(1000.0 * x); }, -1.0, 1.0, 8.0);
+    CHECK_EQ(separator(cache.curve()), cache.curve().size());
+  }
+
+  TEST_CASE("Parallel update matches the serial one") {
+    const auto wave{[](double x) { return std::sin(x) * std::tanh(20.0 * x); }};
+
+    App::Core::SampleCache serial;
+    App::Core::SampleCache parallel;
+    serial.update(wave, -50.0, 50.0, 64.0);
+    parallel.update(wave, -50.0, 50.0, 64.0, &App::Core::ThreadPool::get());
+
+    REQUIRE_EQ(serial.samples().size(), parallel.samples().size());
+    for (std::size_t i = 0; i < serial.samples().size(); ++i) {
+      CHECK_EQ(serial.samples()[i].y, parallel.samples()[i].y);
+    }
+  }
+
+  TEST_CASE("New grid points go through the batch function") {
+    App::Core::SampleCache cache;
+    std::size_t batched{0};
+    const auto scalar{[](double x) { return x * x; }};
+    const auto batch{[&batched](const double* x, double* y, std::size_t count) {
+      batched += count;
+      for (std::size_t i = 0; i < count; ++i) {
+        y[i] = x[i] * x[i];
+      }
+    }};
+
+    cache.update(scalar, 0.0, 1.0, 4.0, nullptr, batch);
+    CHECK_EQ(batched, 5);
+    CHECK_EQ(cache.update(scalar, 0.0, 1.0, 8.0, nullptr, batch), 4);
+    CHECK_EQ(batched, 9);
+    CHECK_EQ(cache.samples()[3].y, 0.375 * 0.375);
+  }
+
+  TEST_CASE("Curves outside the band are refined only once it moves over them") {
+    using App::Core::Interval;
+    using Op = App::Core::BatchExpression::Op;
+    const auto wave{[](double x) { return std::sin(50.0 * x) + 10.0; }};
+    const auto bounds{[](double x0, double x1) {
+      const Interval phase{Interval::apply(Op::Mul, Interval::point(50.0), {x0, x1})};
+      return Interval::apply(
+          Op::Add, Interval::apply(Op::Sin, phase, phase), Interval::point(10.0));
+    }};
+
+    App::Core::SampleCache reference;
+    const std::size_t full{reference.update(wave, -2.0, 2.0, 64.0)};
+
+    App::Core::SampleCache culled;
+    const std::size_t below{
+        culled.update(wave, -2.0, 2.0, 64.0, nullptr, nullptr, {-1.0, 1.0, bounds})};
+    CHECK_EQ(below, culled.samples().size());
+    CHECK_LT(below, full);
+    CHECK_EQ(culled.update(wave, -2.0, 2.0, 64.0, nullptr, nullptr, {-1.0, 1.0, bounds}), 0);
+
+    // Over the curve, the skipped intervals are refined as they would have been.
+    CHECK_EQ(culled.update(wave, -2.0, 2.0, 64.0, nullptr, nullptr, {8.0, 12.0, bounds}),
+        full - below);
+    REQUIRE_EQ(culled.curve().size(), reference.curve().size());
+    for (std::size_t i = 0; i < reference.curve().size(); ++i) {
+      CHECK_EQ(culled.curve()[i].y, reference.curve()[i].y);
+    }
+  }
+
+  TEST_CASE("Invalidate forces a full resample") {
+    App::Core::SampleCache cache;
+    const auto identity{[](double x) { return x; }};
+
+    cache.update(identity, 0.0, 1.0, 2.0);
+    cache.invalidate();
+    CHECK(cache.samples().empty());
+    CHECK(cache.curve().empty());
+    CHECK_EQ(cache.update(identity, 0.0, 1.0, 2.0), 3);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
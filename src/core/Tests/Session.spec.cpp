@@ -0,0 +1,136 @@
+#include <doctest/doctest.h>
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "Core/ImplicitPlot.hpp"
+#include "Core/SampleCache.hpp"
+#include "Core/Session.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::Session") {
+  TEST_CASE("Saved sessions load back unchanged") {
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "session_spec.txt"};
+
+    App::Core::Session session;
+    session.center_x = 0.1;
+    session.center_y = -1e-9;
+    session.pixels_per_unit = 12345.678;
+    session.rows.push_back({"sin(x)", IM_COL32(199, 68, 64, 255), true});
+    session.rows.push_back({"a = 2", IM_COL32(1, 2, 3, 4), false});
+    session.rows.push_back({"f(x) = x \\ 2\nsecond line", IM_COL32(0, 0, 0, 255), true});
+    session.rows.push_back({"", IM_COL32(255, 255, 255, 255), true});
+    REQUIRE(session.save(path));
+
+    App::Core::Session loaded;
+    loaded.rows.push_back({"stale", 0, true});
+    REQUIRE(loaded.load(path));
+    CHECK_EQ(loaded.center_x, session.center_x);
+    CHECK_EQ(loaded.center_y, session.center_y);
+    CHECK_EQ(loaded.pixels_per_unit, session.pixels_per_unit);
+    REQUIRE_EQ(loaded.rows.size(), session.rows.size());
+    for (std::size_t i = 0; i < session.rows.size(); ++i) {
+      CHECK_EQ(loaded.rows[i].text, session.rows[i].text);
+      CHECK_EQ(loaded.rows[i].color, session.rows[i].color);
+      CHECK_EQ(loaded.rows[i].visible, session.rows[i].visible);
+    }
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Hand-written files allow comments and short colors") {
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "session_spec.txt"};
+    {
+      std::ofstream file{path};
+      file << "# nightly plot\n\nrow #FF0000 1 x^2 + y^2 = 4\r\nview 1 2 50\n";
+    }
+
+    App::Core::Session session;
+    REQUIRE(session.load(path));
+    REQUIRE_EQ(session.rows.size(), 1);
+    CHECK_EQ(session.rows[0].text, "x^2 + y^2 = 4");
+    CHECK_EQ(session.rows[0].color, IM_COL32(255, 0, 0, 255));
+    CHECK_EQ(session.center_x, 1.0);
+    CHECK_EQ(session.pixels_per_unit, 50.0);
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Binary sessions keep cached curves") {
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "session_spec.imgraph"};
+    const std::vector<App::Core::Sample> samples{{-1.0, 1.0}, {0.0, 0.0}, {1.0, 1.0}};
+    const std::vector<App::Core::ImplicitPlot::Segment> segments{{{0.0, 1.0}, {1.0, 0.0}}};
+    const std::vector<App::Core::ImplicitPlot::Box> regions{{0.0, 0.0, 0.5, 0.5}};
+
+    App::Core::Session session;
+    session.center_x = 3.5;
+    session.pixels_per_unit = 42.0;
+    session.rows.push_back({"x^2", IM_COL32(10, 20, 30, 255), true});
+    session.rows.back().curve.samples = samples;
+    session.rows.push_back({"x^2 + y^2 < 1", IM_COL32(1, 2, 3, 4), false});
+    session.rows.back().curve.segments = segments;
+    session.rows.back().curve.regions = regions;
+    session.rows.push_back({"a = 1", IM_COL32(0, 0, 0, 255), true});
+    REQUIRE(session.save(path, App::Core::Session::Format::Binary));
+
+    App::Core::Session loaded;
+    REQUIRE(loaded.load(path));
+    CHECK_EQ(loaded.center_x, 3.5);
+    CHECK_EQ(loaded.pixels_per_unit, 42.0);
+    REQUIRE_EQ(loaded.rows.size(), 3);
+    CHECK_EQ(loaded.rows[1].text, "x^2 + y^2 < 1");
+    CHECK_EQ(loaded.rows[1].color, IM_COL32(1, 2, 3, 4));
+    CHECK_FALSE(loaded.rows[1].visible);
+
+    const auto& curve{loaded.rows[0].curve};
+    REQUIRE_EQ(curve.samples.size(), samples.size());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      CHECK_EQ(curve.samples[i].x, samples[i].x);
+      CHECK_EQ(curve.samples[i].y, samples[i].y);
+    }
+    REQUIRE_EQ(loaded.rows[1].curve.segments.size(), 1);
+    CHECK_EQ(loaded.rows[1].curve.segments[0].b.x, 1.0);
+    REQUIRE_EQ(loaded.rows[1].curve.regions.size(), 1);
+    CHECK_EQ(loaded.rows[1].curve.regions[0].x1, 0.5);
+    CHECK(loaded.rows[2].curve.empty());
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Truncated binary sessions fail the load") {
+    const std::filesystem::path path{
+        std::filesystem::temp_directory_path() / "session_spec.imgraph"};
+    App::Core::Session session;
+    session.rows.push_back({"sin(x)", IM_COL32(199, 68, 64, 255), true});
+    REQUIRE(session.save(path, App::Core::Session::Format::Binary));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    App::Core::Session loaded;
+    CHECK_FALSE(loaded.load(path));
+    CHECK(loaded.rows.empty());
+
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("Malformed lines fail the load") {
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "session_spec.txt"};
+    {
+      std::ofstream file{path};
+      file << "row red 1 sin(x)\n";
+    }
+
+    App::Core::Session session;
+    CHECK_FALSE(session.load(path));
+    CHECK_FALSE(session.load(std::filesystem::temp_directory_path() / "no_such_session.txt"));
+
+    std::filesystem::remove(path);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
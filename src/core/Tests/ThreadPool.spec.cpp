@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "Core/ThreadPool.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::ThreadPool") {
+  TEST_CASE("parallel_for visits every index once") {
+    auto& pool{App::Core::ThreadPool::get()};
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallel_for(visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+
+    for (const auto& count : visits) {
+      CHECK_EQ(count.load(), 1);
+    }
+  }
+
+  TEST_CASE("Nested parallel_for completes") {
+    auto& pool{App::Core::ThreadPool::get()};
+    std::atomic<std::size_t> total{0};
+
+    pool.parallel_for(8, [&pool, &total](std::size_t) {
+      pool.parallel_for(100, [&total](std::size_t) { ++total; });
+    });
+
+    CHECK_EQ(total.load(), 800);
+  }
+
+  TEST_CASE("Nested parallel_for under queued tasks only helps its own batch") {
+    auto& pool{App::Core::ThreadPool::get()};
+    const std::size_t jobs{pool.slot_count() * 4};
+    // Jobs running on the stack of the current thread; a waiting parallel_for must not start
+    // another queued job on top of its own.
+    thread_local int depth{0};
+    std::atomic<int> deepest{0};
+    std::atomic<std::size_t> total{0};
+    std::atomic<std::size_t> finished{0};
+
+    for (std::size_t job = 0; job < jobs; ++job) {
+      pool.submit([&pool, &deepest, &total, &finished] {
+        ++depth;
+        int seen{deepest.load()};
+        while (depth > seen && !deepest.compare_exchange_weak(seen, depth)) {
+        }
+        pool.parallel_for(16, [&pool, &total](std::size_t) {
+          pool.parallel_for(50, [&total](std::size_t) { ++total; });
+        });
+        --depth;
+        ++finished;
+      });
+    }
+    while (finished.load() < jobs) {
+      std::this_thread::yield();
+    }
+
+    CHECK_EQ(total.load(), jobs * 16 * 50);
+    CHECK_EQ(deepest.load(), 1);
+  }
+
+  TEST_CASE("Slots are within range") {
+    auto& pool{App::Core::ThreadPool::get()};
+    std::atomic<bool> in_range{true};
+
+    CHECK_EQ(App::Core::ThreadPool::current_slot(), 0);
+    pool.parallel_for(64, [&pool, &in_range](std::size_t) {
+      if (App::Core::ThreadPool::current_slot() >= pool.slot_count()) {
+        in_range = false;
+      }
+    });
+    CHECK(in_range.load());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,69 @@
+#include <doctest/doctest.h>
+
+#include <cmath>
+
+#include "Core/ViewTransform.hpp"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::ViewTransform") {
+  TEST_CASE("Zooming keeps the point under the cursor in place, deep and far out") {
+    App::Core::ViewTransform view{1234.5678, -0.001, 100.0};
+    const double cursor_x{-200.0};
+    const double cursor_y{150.0};
+    const double x{view.to_world_x(cursor_x)};
+    const double y{view.to_world_y(cursor_y)};
+
+    for (int step = 0; step < 400; ++step) {
+      view.zoom_at(cursor_x, cursor_y, 1.1);
+      const ImVec2 screen{view.to_screen(x, y)};
+      CHECK_EQ(screen.x, doctest::Approx(cursor_x).epsilon(1e-3));
+      CHECK_EQ(screen.y, doctest::Approx(cursor_y).epsilon(1e-3));
+    }
+    CHECK_EQ(view.pixels_per_unit(), doctest::Approx(view.max_pixels_per_unit()));
+    CHECK(view.pixels_per_unit() > 1.0e9);
+  }
+
+  TEST_CASE("Neighbouring pixels stay distinct at the largest zoom") {
+    App::Core::ViewTransform view{1.0e4, 3.0, 1.0e30};
+    const double zoom{view.pixels_per_unit()};
+    CHECK_EQ(zoom, view.max_pixels_per_unit());
+    CHECK(zoom < 1.0e30);
+    for (int pixel = -640; pixel <= 640; ++pixel) {
+      const double x{view.to_world_x(pixel)};
+      CHECK(x < view.to_world_x(pixel + 1));
+      CHECK_EQ(view.to_screen(x, 3.0).x, doctest::Approx(pixel).epsilon(0.05));
+    }
+  }
+
+  TEST_CASE("Panning far out lowers a zoom the new center cannot hold") {
+    App::Core::ViewTransform view{0.0, 0.0, 1.0e30};
+    const double near_origin{view.pixels_per_unit()};
+    view.pan(-1.0e3, 0.0);
+    view.zoom_at(0.0, 0.0, 1.0);
+    CHECK_EQ(view.pixels_per_unit(), near_origin);
+
+    App::Core::ViewTransform far{0.0, 0.0, 1.0};
+    far.pan(-1.0e9, 0.0);
+    CHECK_EQ(far.center_x(), doctest::Approx(1.0e9));
+    far.zoom_at(0.0, 0.0, 1.0e30);
+    CHECK(far.pixels_per_unit() < near_origin / 1.0e8);
+  }
+
+  TEST_CASE("Centers too large for any zoom keep the smallest one") {
+    using App::Core::ViewTransform;
+    ViewTransform view{1.0e300, -1.0e20, 1.0};
+    REQUIRE(view.max_pixels_per_unit() < ViewTransform::MIN_PIXELS_PER_UNIT);
+    CHECK_EQ(view.pixels_per_unit(), ViewTransform::MIN_PIXELS_PER_UNIT);
+
+    view.zoom_at(10.0, 10.0, 1.0e6);
+    CHECK_EQ(view.pixels_per_unit(), ViewTransform::MIN_PIXELS_PER_UNIT);
+    view.zoom_at(0.0, 0.0, 1.0e-6);
+    CHECK_EQ(view.pixels_per_unit(), ViewTransform::MIN_PIXELS_PER_UNIT);
+    view.pan(100.0, 0.0);
+    CHECK(std::isfinite(view.center_x()));
+    CHECK_EQ(view.pixels_per_unit(), ViewTransform::MIN_PIXELS_PER_UNIT);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)